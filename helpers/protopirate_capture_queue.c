@@ -0,0 +1,214 @@
+// helpers/protopirate_capture_queue.c
+#include "protopirate_capture_queue.h"
+#include "../protocols/protocol_items.h"
+
+#define TAG "ProtoPirateCaptureQueue"
+
+#define CAPTURE_QUEUE_SIZE       8 // frames, power of two
+#define CAPTURE_QUEUE_STACK_SIZE (4 * 1024)
+#define CAPTURE_QUEUE_ALIGN(x)   (((x) + 7) & ~(size_t)7)
+
+#define CAPTURE_QUEUE_IDLE_MS   1000
+
+#define CAPTURE_QUEUE_FLAG_DATA (1UL << 0)
+#define CAPTURE_QUEUE_FLAG_EXIT (1UL << 1)
+
+// Each slot is this header followed by the decoder struct at data_offset
+typedef struct {
+    uint32_t frequency;
+    uint8_t protocol; // registry index
+} ProtoPirateCaptureQueueHeader;
+
+struct ProtoPirateCaptureQueue {
+    const SubGhzProtocolDecoder** vtables;
+    SubGhzProtocolDecoderBase** decoders; // consumer side copies, by registry index
+    size_t count;
+
+    uint8_t* slots;
+    size_t slot_size;
+    size_t data_offset;
+    uint32_t head; // advanced by the worker only
+    uint32_t tail; // advanced by the consumer only
+    uint32_t dropped;
+
+    FuriThread* thread;
+    ProtoPirateCaptureQueueCallback callback;
+    ProtoPirateCaptureQueueIdleCallback idle;
+    void* context;
+};
+
+ProtoPirateCaptureQueue* protopirate_capture_queue_alloc(SubGhzEnvironment* environment) {
+    ProtoPirateCaptureQueue* instance = malloc(sizeof(ProtoPirateCaptureQueue));
+    size_t size = protopirate_protocol_registry.size;
+    furi_check(size == protopirate_protocol_entries_count);
+
+    instance->vtables = malloc(sizeof(SubGhzProtocolDecoder*) * size);
+    instance->decoders = malloc(sizeof(SubGhzProtocolDecoderBase*) * size);
+    instance->count = size;
+
+    size_t max_decoder_size = 0;
+    for(size_t i = 0; i < size; i++) {
+        const SubGhzProtocol* protocol = protopirate_protocol_registry.items[i];
+        instance->vtables[i] = protocol->decoder;
+        instance->decoders[i] = NULL;
+        if(!protocol->decoder || !protocol->decoder->alloc) continue;
+
+        instance->decoders[i] = protocol->decoder->alloc(environment);
+        max_decoder_size = MAX(max_decoder_size, protopirate_protocol_entries[i]->decoder_size);
+    }
+
+    instance->data_offset = CAPTURE_QUEUE_ALIGN(sizeof(ProtoPirateCaptureQueueHeader));
+    instance->slot_size = CAPTURE_QUEUE_ALIGN(instance->data_offset + max_decoder_size);
+    instance->slots = malloc(instance->slot_size * CAPTURE_QUEUE_SIZE);
+    instance->head = 0;
+    instance->tail = 0;
+    instance->dropped = 0;
+
+    instance->thread = NULL;
+    instance->callback = NULL;
+    instance->idle = NULL;
+    instance->context = NULL;
+    return instance;
+}
+
+void protopirate_capture_queue_free(ProtoPirateCaptureQueue* instance) {
+    furi_assert(instance);
+    protopirate_capture_queue_stop(instance);
+
+    for(size_t i = 0; i < instance->count; i++) {
+        if(instance->decoders[i]) {
+            instance->vtables[i]->free(instance->decoders[i]);
+        }
+    }
+    free(instance->slots);
+    free(instance->decoders);
+    free(instance->vtables);
+    free(instance);
+}
+
+// Copies every published frame into its protocol's decoder and runs the
+// callback on it. The slot is released before the callback, so the worker
+// can reuse it while we're busy with the SD card.
+static void protopirate_capture_queue_drain(ProtoPirateCaptureQueue* instance) {
+    uint32_t tail = instance->tail;
+
+    while(tail != __atomic_load_n(&instance->head, __ATOMIC_ACQUIRE)) {
+        const uint8_t* slot =
+            instance->slots + (tail & (CAPTURE_QUEUE_SIZE - 1)) * instance->slot_size;
+        const ProtoPirateCaptureQueueHeader* header = (const ProtoPirateCaptureQueueHeader*)slot;
+
+        uint8_t protocol = header->protocol;
+        uint32_t frequency = header->frequency;
+        SubGhzProtocolDecoderBase* decoder = instance->decoders[protocol];
+        memcpy(
+            decoder,
+            slot + instance->data_offset,
+            protopirate_protocol_entries[protocol]->decoder_size);
+
+        tail++;
+        __atomic_store_n(&instance->tail, tail, __ATOMIC_RELEASE);
+
+        if(instance->callback) {
+            instance->callback(decoder, frequency, instance->context);
+        }
+    }
+}
+
+static int32_t protopirate_capture_queue_thread(void* context) {
+    ProtoPirateCaptureQueue* instance = context;
+
+    while(true) {
+        uint32_t flags = furi_thread_flags_wait(
+            CAPTURE_QUEUE_FLAG_DATA | CAPTURE_QUEUE_FLAG_EXIT,
+            FuriFlagWaitAny,
+            furi_ms_to_ticks(CAPTURE_QUEUE_IDLE_MS));
+        if(flags == (uint32_t)FuriFlagErrorTimeout) {
+            if(instance->idle) instance->idle(instance->context);
+            continue;
+        }
+        if(flags & FuriFlagError) continue;
+
+        protopirate_capture_queue_drain(instance);
+        if(flags & CAPTURE_QUEUE_FLAG_EXIT) break;
+    }
+
+    return 0;
+}
+
+void protopirate_capture_queue_start(
+    ProtoPirateCaptureQueue* instance,
+    ProtoPirateCaptureQueueCallback callback,
+    ProtoPirateCaptureQueueIdleCallback idle,
+    void* context) {
+    furi_assert(instance);
+    if(instance->thread) return;
+
+    instance->callback = callback;
+    instance->idle = idle;
+    instance->context = context;
+
+    instance->thread = furi_thread_alloc_ex(
+        "ProtoPirateCapture", CAPTURE_QUEUE_STACK_SIZE, protopirate_capture_queue_thread, instance);
+    furi_thread_set_priority(instance->thread, FuriThreadPriorityLow);
+    furi_thread_start(instance->thread);
+
+    // Frames pushed while nobody was listening
+    furi_thread_flags_set(furi_thread_get_id(instance->thread), CAPTURE_QUEUE_FLAG_DATA);
+}
+
+void protopirate_capture_queue_stop(ProtoPirateCaptureQueue* instance) {
+    furi_assert(instance);
+    if(!instance->thread) return;
+
+    furi_thread_flags_set(furi_thread_get_id(instance->thread), CAPTURE_QUEUE_FLAG_EXIT);
+    furi_thread_join(instance->thread);
+    furi_thread_free(instance->thread);
+    instance->thread = NULL;
+
+    uint32_t dropped = __atomic_load_n(&instance->dropped, __ATOMIC_RELAXED);
+    if(dropped) {
+        FURI_LOG_W(TAG, "%lu frames dropped on a full queue", dropped);
+    }
+}
+
+bool protopirate_capture_queue_push(
+    ProtoPirateCaptureQueue* instance,
+    SubGhzProtocolDecoderBase* decoder_base,
+    uint32_t frequency) {
+    furi_assert(instance);
+
+    size_t protocol = 0;
+    while(protocol < instance->count &&
+          protopirate_protocol_registry.items[protocol] != decoder_base->protocol) {
+        protocol++;
+    }
+    if(protocol == instance->count || !instance->decoders[protocol]) return false;
+
+    uint32_t head = instance->head;
+    if(head - __atomic_load_n(&instance->tail, __ATOMIC_ACQUIRE) >= CAPTURE_QUEUE_SIZE) {
+        __atomic_fetch_add(&instance->dropped, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    uint8_t* slot = instance->slots + (head & (CAPTURE_QUEUE_SIZE - 1)) * instance->slot_size;
+    ProtoPirateCaptureQueueHeader* header = (ProtoPirateCaptureQueueHeader*)slot;
+    header->frequency = frequency;
+    header->protocol = protocol;
+    memcpy(
+        slot + instance->data_offset,
+        decoder_base,
+        protopirate_protocol_entries[protocol]->decoder_size);
+
+    __atomic_store_n(&instance->head, head + 1, __ATOMIC_RELEASE);
+
+    FuriThread* thread = instance->thread;
+    if(thread) {
+        furi_thread_flags_set(furi_thread_get_id(thread), CAPTURE_QUEUE_FLAG_DATA);
+    }
+    return true;
+}
+
+uint32_t protopirate_capture_queue_get_dropped(ProtoPirateCaptureQueue* instance) {
+    furi_assert(instance);
+    return __atomic_load_n(&instance->dropped, __ATOMIC_RELAXED);
+}
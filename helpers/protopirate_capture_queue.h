@@ -0,0 +1,48 @@
+// helpers/protopirate_capture_queue.h
+#pragma once
+
+#include <furi.h>
+#include <lib/subghz/environment.h>
+#include <lib/subghz/protocols/base.h>
+
+// Hands decoded frames from the SubGhz worker to a low priority thread. The
+// worker side only copies the decoder struct into a free slot of a lock-free
+// single producer / single consumer ring, the consumer copies it back into its
+// own decoder of that protocol and runs the callback on it. get_string,
+// serialize, history and SD writes all happen there, never in the worker.
+typedef struct ProtoPirateCaptureQueue ProtoPirateCaptureQueue;
+
+// Consumer thread context. decoder_base stays valid until the callback returns,
+// frequency is what the radio was tuned to when the frame was decoded.
+typedef void (*ProtoPirateCaptureQueueCallback)(
+    SubGhzProtocolDecoderBase* decoder_base,
+    uint32_t frequency,
+    void* context);
+
+// Consumer thread too, about once a second while no frames come in. For work
+// that has to happen eventually, like flushing buffered writes.
+typedef void (*ProtoPirateCaptureQueueIdleCallback)(void* context);
+
+ProtoPirateCaptureQueue* protopirate_capture_queue_alloc(SubGhzEnvironment* environment);
+void protopirate_capture_queue_free(ProtoPirateCaptureQueue* instance);
+
+// Starts the consumer thread, does nothing if it's already running. idle may
+// be NULL, both get context.
+void protopirate_capture_queue_start(
+    ProtoPirateCaptureQueue* instance,
+    ProtoPirateCaptureQueueCallback callback,
+    ProtoPirateCaptureQueueIdleCallback idle,
+    void* context);
+
+// Processes whatever is still queued, then joins the consumer thread
+void protopirate_capture_queue_stop(ProtoPirateCaptureQueue* instance);
+
+// Worker side, no allocation and no locks. False if the ring is full and the
+// frame was dropped.
+bool protopirate_capture_queue_push(
+    ProtoPirateCaptureQueue* instance,
+    SubGhzProtocolDecoderBase* decoder_base,
+    uint32_t frequency);
+
+// Frames dropped on a full ring since alloc
+uint32_t protopirate_capture_queue_get_dropped(ProtoPirateCaptureQueue* instance);
@@ -0,0 +1,285 @@
+// helpers/protopirate_decoder_set.c
+#include "protopirate_decoder_set.h"
+#include "protopirate_stats.h"
+#include "protopirate_trace.h"
+#include "../protocols/protocol_items.h"
+
+#define TAG "ProtoPirateDecoderSet"
+
+// Symbols of a pulse are kept in a bit mask, one bit per family
+#define PROTOPIRATE_DECODER_SET_FAMILIES_MAX 32
+
+typedef void (*ProtoPirateDecoderSetFeedPulse)(void* context, ProtoPiratePulse pulse);
+
+// Pulses that take an idle decoder out of Reset, bounds inclusive
+typedef struct {
+    uint32_t min;
+    uint32_t max;
+    uint8_t levels; // ProtoPirateEntryLevel mask
+} ProtoPirateDecoderSetWindow;
+
+// What every ProtoPirate decoder struct starts with, see protopirate_entry.h
+typedef struct {
+    SubGhzProtocolDecoderBase base;
+    SubGhzBlockDecoder decoder;
+} ProtoPirateDecoderSetHead;
+
+struct ProtoPirateDecoderSet {
+    const SubGhzProtocolDecoder** vtables;
+    SubGhzProtocolDecoderBase** decoders;
+    ProtoPirateDecoderSetWindow* windows;
+    uint8_t* protocols; // registry index, for protopirate_stats
+    ProtoPirateDecoderSetFeedPulse* feed_pulses; // NULL for the vtable feed
+    uint8_t* families; // index into family_table, for a feed_pulse
+    size_t count;
+
+    // Distinct timings of the feed_pulse decoders
+    ProtoPiratePulseFamily family_table[PROTOPIRATE_DECODER_SET_FAMILIES_MAX];
+    size_t family_count;
+
+    // Glitch filter, the pulse held back until the next one shows whether a
+    // glitch is to be merged into it
+    uint32_t glitch_max; // 0 for off
+    bool held;
+    bool held_level;
+    bool held_merge; // a glitch was merged, the next pulse of held_level goes too
+    uint32_t held_duration;
+    uint32_t glitches;
+};
+
+// Pulse being fed, quantized for a family the first time a decoder needs it
+typedef struct {
+    bool level;
+    uint32_t duration;
+    uint32_t quantized; // bit per family
+    uint8_t symbols[PROTOPIRATE_DECODER_SET_FAMILIES_MAX];
+} ProtoPirateDecoderSetPulse;
+
+static void protopirate_decoder_set_window_init(
+    ProtoPirateDecoderSetWindow* window,
+    const ProtoPirateEntry* entry) {
+    const SubGhzBlockConst* block_const = entry->block_const;
+    uint32_t te = (entry->te == ProtoPirateEntryTeLong) ? block_const->te_long :
+                                                          block_const->te_short;
+    uint32_t delta = block_const->te_delta;
+    // DURATION_DIFF(duration, te) < delta unless the Reset step also takes == delta
+    uint32_t slack = entry->inclusive ? 0 : 1;
+
+    window->min = (te + slack > delta) ? te + slack - delta : 0;
+    window->max = te + delta - slack;
+    window->levels = entry->level;
+}
+
+static uint8_t protopirate_decoder_set_family(
+    ProtoPirateDecoderSet* instance,
+    const SubGhzBlockConst* block_const) {
+    for(size_t i = 0; i < instance->family_count; i++) {
+        if(protopirate_pulse_family_is(&instance->family_table[i], block_const)) return i;
+    }
+    furi_check(instance->family_count < PROTOPIRATE_DECODER_SET_FAMILIES_MAX);
+    protopirate_pulse_family_init(&instance->family_table[instance->family_count], block_const);
+    return instance->family_count++;
+}
+
+// Mid-frame decoders take every pulse, idle ones only what can start a frame
+static inline bool protopirate_decoder_set_wants(
+    ProtoPirateDecoderSet* instance,
+    size_t index,
+    uint8_t level_bit,
+    uint32_t duration) {
+    const ProtoPirateDecoderSetHead* head =
+        (const ProtoPirateDecoderSetHead*)instance->decoders[index];
+    if(head->decoder.parser_step) return true;
+
+    const ProtoPirateDecoderSetWindow* window = &instance->windows[index];
+    return (window->levels & level_bit) && duration >= window->min && duration <= window->max;
+}
+
+ProtoPirateDecoderSet* protopirate_decoder_set_alloc(SubGhzEnvironment* environment) {
+    ProtoPirateDecoderSet* instance = malloc(sizeof(ProtoPirateDecoderSet));
+    size_t size = protopirate_protocol_registry.size;
+    furi_check(size == ProtoPirateTraceProtocolCount);
+    furi_check(size == protopirate_protocol_entries_count);
+
+    instance->vtables = malloc(sizeof(SubGhzProtocolDecoder*) * size);
+    instance->decoders = malloc(sizeof(SubGhzProtocolDecoderBase*) * size);
+    instance->windows = malloc(sizeof(ProtoPirateDecoderSetWindow) * size);
+    instance->protocols = malloc(sizeof(uint8_t) * size);
+    instance->feed_pulses = malloc(sizeof(ProtoPirateDecoderSetFeedPulse) * size);
+    instance->families = malloc(sizeof(uint8_t) * size);
+    instance->count = 0;
+    instance->family_count = 0;
+    instance->glitch_max = 0;
+    instance->held = false;
+    instance->glitches = 0;
+
+    for(size_t i = 0; i < size; i++) {
+        const SubGhzProtocol* protocol = protopirate_protocol_registry.items[i];
+        if(!protocol->decoder || !protocol->decoder->alloc || !protocol->decoder->feed) continue;
+
+        SubGhzProtocolDecoderBase* decoder = protocol->decoder->alloc(environment);
+        if(!decoder) {
+            FURI_LOG_W(TAG, "Failed to alloc decoder %s", protocol->name);
+            continue;
+        }
+
+        instance->vtables[instance->count] = protocol->decoder;
+        instance->decoders[instance->count] = decoder;
+        protopirate_decoder_set_window_init(
+            &instance->windows[instance->count], protopirate_protocol_entries[i]);
+        instance->protocols[instance->count] = i;
+        instance->feed_pulses[instance->count] = protopirate_protocol_entries[i]->feed_pulse;
+        instance->families[instance->count] =
+            protopirate_protocol_entries[i]->feed_pulse ?
+                protopirate_decoder_set_family(
+                    instance, protopirate_protocol_entries[i]->block_const) :
+                0;
+        instance->count++;
+    }
+
+    FURI_LOG_D(TAG, "%zu decoders, %zu pulse families", instance->count, instance->family_count);
+
+    protopirate_decoder_set_reset(instance);
+    return instance;
+}
+
+void protopirate_decoder_set_free(ProtoPirateDecoderSet* instance) {
+    furi_assert(instance);
+    for(size_t i = 0; i < instance->count; i++) {
+        instance->vtables[i]->free(instance->decoders[i]);
+    }
+    free(instance->families);
+    free(instance->feed_pulses);
+    free(instance->protocols);
+    free(instance->windows);
+    free(instance->decoders);
+    free(instance->vtables);
+    free(instance);
+}
+
+void protopirate_decoder_set_set_callback(
+    ProtoPirateDecoderSet* instance,
+    ProtoPirateDecoderSetCallback callback,
+    void* context) {
+    furi_assert(instance);
+    for(size_t i = 0; i < instance->count; i++) {
+        instance->decoders[i]->callback = callback;
+        instance->decoders[i]->context = context;
+    }
+}
+
+void protopirate_decoder_set_reset(ProtoPirateDecoderSet* instance) {
+    furi_assert(instance);
+    instance->held = false;
+    for(size_t i = 0; i < instance->count; i++) {
+        if(instance->vtables[i]->reset) {
+            instance->vtables[i]->reset(instance->decoders[i]);
+        }
+    }
+}
+
+static inline void protopirate_decoder_set_feed_one(
+    ProtoPirateDecoderSet* instance,
+    size_t index,
+    ProtoPirateDecoderSetPulse* pulse) {
+    ProtoPirateDecoderSetFeedPulse feed_pulse = instance->feed_pulses[index];
+    if(!feed_pulse) {
+        instance->vtables[index]->feed(instance->decoders[index], pulse->level, pulse->duration);
+        return;
+    }
+
+    uint8_t family = instance->families[index];
+    if(!(pulse->quantized & (1UL << family))) {
+        pulse->symbols[family] = protopirate_pulse_quantize(
+            &instance->family_table[family], pulse->level, pulse->duration);
+        pulse->quantized |= 1UL << family;
+    }
+    feed_pulse(
+        instance->decoders[index],
+        (ProtoPiratePulse){.duration = pulse->duration, .symbol = pulse->symbols[family]});
+}
+
+static void protopirate_decoder_set_dispatch(
+    ProtoPirateDecoderSet* instance,
+    bool level,
+    uint32_t duration) {
+    uint8_t level_bit = level ? ProtoPirateEntryLevelHigh : ProtoPirateEntryLevelLow;
+    ProtoPirateDecoderSetPulse pulse = {.level = level, .duration = duration, .quantized = 0};
+
+    if(!protopirate_stats_enabled) {
+        for(size_t i = 0; i < instance->count; i++) {
+            if(!protopirate_decoder_set_wants(instance, i, level_bit, duration)) continue;
+            protopirate_decoder_set_feed_one(instance, i, &pulse);
+        }
+        return;
+    }
+
+    for(size_t i = 0; i < instance->count; i++) {
+        if(!protopirate_decoder_set_wants(instance, i, level_bit, duration)) continue;
+        ProtoPirateStatsEntry* entry = &protopirate_stats[instance->protocols[i]];
+        uint32_t start = PROTOPIRATE_STATS_TICKS();
+        protopirate_decoder_set_feed_one(instance, i, &pulse);
+        entry->ticks += (uint32_t)(PROTOPIRATE_STATS_TICKS() - start);
+        entry->pulses++;
+    }
+}
+
+// A glitch and the pulse after it are added to the held pulse, so high 500,
+// low 20, high 480 goes on as high 1000
+void protopirate_decoder_set_feed(ProtoPirateDecoderSet* instance, bool level, uint32_t duration) {
+    if(!instance->held && !instance->glitch_max) {
+        protopirate_decoder_set_dispatch(instance, level, duration);
+        return;
+    }
+
+    if(instance->held) {
+        bool glitch = duration < instance->glitch_max;
+        if(glitch || (instance->held_merge && level == instance->held_level)) {
+            if(glitch) instance->glitches++;
+            instance->held_duration += duration;
+            instance->held_merge = (level != instance->held_level);
+            return;
+        }
+        protopirate_decoder_set_dispatch(instance, instance->held_level, instance->held_duration);
+    }
+
+    if(instance->glitch_max) {
+        instance->held = true;
+        instance->held_level = level;
+        instance->held_merge = false;
+        instance->held_duration = duration;
+    } else {
+        // Filter just turned off, nothing held from here on
+        instance->held = false;
+        protopirate_decoder_set_dispatch(instance, level, duration);
+    }
+}
+
+void protopirate_decoder_set_flush(ProtoPirateDecoderSet* instance) {
+    furi_assert(instance);
+    if(instance->held) {
+        instance->held = false;
+        protopirate_decoder_set_dispatch(instance, instance->held_level, instance->held_duration);
+    }
+}
+
+void protopirate_decoder_set_set_glitch_filter(ProtoPirateDecoderSet* instance, uint32_t max_us) {
+    furi_assert(instance);
+    instance->glitch_max = max_us;
+}
+
+uint32_t protopirate_decoder_set_get_glitches(ProtoPirateDecoderSet* instance) {
+    furi_assert(instance);
+    return instance->glitches;
+}
+
+size_t protopirate_decoder_set_get_count(ProtoPirateDecoderSet* instance) {
+    furi_assert(instance);
+    return instance->count;
+}
+
+SubGhzProtocolDecoderBase* protopirate_decoder_set_get(ProtoPirateDecoderSet* instance, size_t index) {
+    furi_assert(instance);
+    furi_check(index < instance->count);
+    return instance->decoders[index];
+}
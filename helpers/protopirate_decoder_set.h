@@ -0,0 +1,41 @@
+// helpers/protopirate_decoder_set.h
+#pragma once
+
+#include <furi.h>
+#include <lib/subghz/environment.h>
+#include <lib/subghz/protocols/base.h>
+
+// Every decoder from protopirate_protocol_registry, allocated once and fed
+// together so a capture is walked in a single pass (like subghz_receiver_decode).
+// Decoders sitting in their Reset step are only fed pulses that fall in their
+// entry window (protopirate_protocol_entries), the rest would be rejected anyway.
+// Decoders with a feed_pulse get each pulse as a symbol, quantized once for all
+// decoders of the same timings (protopirate_pulse.h).
+typedef struct ProtoPirateDecoderSet ProtoPirateDecoderSet;
+
+typedef void (*ProtoPirateDecoderSetCallback)(SubGhzProtocolDecoderBase* decoder_base, void* context);
+
+ProtoPirateDecoderSet* protopirate_decoder_set_alloc(SubGhzEnvironment* environment);
+void protopirate_decoder_set_free(ProtoPirateDecoderSet* instance);
+
+void protopirate_decoder_set_set_callback(
+    ProtoPirateDecoderSet* instance,
+    ProtoPirateDecoderSetCallback callback,
+    void* context);
+
+// Drops a pulse held by the glitch filter too
+void protopirate_decoder_set_reset(ProtoPirateDecoderSet* instance);
+void protopirate_decoder_set_feed(ProtoPirateDecoderSet* instance, bool level, uint32_t duration);
+// Hands on the pulse held by the glitch filter, at the end of a capture
+void protopirate_decoder_set_flush(ProtoPirateDecoderSet* instance);
+
+// Pulses shorter than max_us are noise: merged with the pulses around them
+// before any decoder sees them, instead of resetting every decoder mid-frame.
+// With the filter on each pulse is held back until the next one has ended.
+// 0 turns it off, the default.
+void protopirate_decoder_set_set_glitch_filter(ProtoPirateDecoderSet* instance, uint32_t max_us);
+// Glitches merged so far
+uint32_t protopirate_decoder_set_get_glitches(ProtoPirateDecoderSet* instance);
+
+size_t protopirate_decoder_set_get_count(ProtoPirateDecoderSet* instance);
+SubGhzProtocolDecoderBase* protopirate_decoder_set_get(ProtoPirateDecoderSet* instance, size_t index);
@@ -0,0 +1,43 @@
+// helpers/protopirate_entry.h
+#pragma once
+
+#include <furi.h>
+#include <lib/subghz/blocks/const.h>
+#include "protopirate_pulse.h"
+
+// How an idle decoder (parser_step 0, its Reset step) starts a frame: one
+// pulse of the given level within te_delta of te_short or te_long from its
+// SubGhzBlockConst. The decoder set feeds idle decoders only those pulses, so
+// a Reset step must ignore everything else.
+//
+// Every decoder struct starts with SubGhzProtocolDecoderBase followed by
+// SubGhzBlockDecoder, that's where the decoder set reads parser_step from. The
+// structs hold no heap pointers, so a decoded frame can be copied out of the
+// worker with memcpy (decoder_size bytes) and formatted later.
+//
+// A decoder with a feed_pulse is fed through it instead of its vtable feed,
+// with the pulse quantized against its block_const (see protopirate_pulse.h).
+//
+// key_extra returns the part of a decoded key that doesn't fit generic, like
+// a second key word, so history can tell two frames apart by it.
+
+typedef enum {
+    ProtoPirateEntryLevelLow = (1 << 0),
+    ProtoPirateEntryLevelHigh = (1 << 1),
+    ProtoPirateEntryLevelAny = ProtoPirateEntryLevelLow | ProtoPirateEntryLevelHigh,
+} ProtoPirateEntryLevel;
+
+typedef enum {
+    ProtoPirateEntryTeShort,
+    ProtoPirateEntryTeLong,
+} ProtoPirateEntryTe;
+
+typedef struct {
+    const SubGhzBlockConst* block_const;
+    size_t decoder_size;
+    ProtoPirateEntryTe te;
+    ProtoPirateEntryLevel level;
+    bool inclusive; // DURATION_DIFF <= te_delta, the default is <
+    void (*feed_pulse)(void* context, ProtoPiratePulse pulse); // NULL for the vtable feed
+    uint64_t (*key_extra)(const void* context); // NULL if generic holds the whole key
+} ProtoPirateEntry;
@@ -0,0 +1,244 @@
+// helpers/protopirate_key_file.c
+#include "protopirate_key_file.h"
+#include <toolbox/stream/buffered_file_stream.h>
+
+#define TAG "ProtoPirateKeyFile"
+
+ProtoPirateKeyFile *protopirate_key_file_alloc(void)
+{
+    ProtoPirateKeyFile *key_file = malloc(sizeof(ProtoPirateKeyFile));
+    key_file->filetype = furi_string_alloc();
+    key_file->protocol = furi_string_alloc();
+    key_file->preset = furi_string_alloc();
+    key_file->data = flipper_format_string_alloc();
+    protopirate_key_file_reset(key_file);
+    return key_file;
+}
+
+void protopirate_key_file_free(ProtoPirateKeyFile *key_file)
+{
+    furi_assert(key_file);
+    furi_string_free(key_file->filetype);
+    furi_string_free(key_file->protocol);
+    furi_string_free(key_file->preset);
+    flipper_format_free(key_file->data);
+    free(key_file);
+}
+
+void protopirate_key_file_reset(ProtoPirateKeyFile *key_file)
+{
+    furi_assert(key_file);
+    furi_string_reset(key_file->filetype);
+    furi_string_reset(key_file->protocol);
+    furi_string_reset(key_file->preset);
+    stream_clean(flipper_format_get_raw_stream(key_file->data));
+
+    key_file->version = 0;
+    key_file->frequency = 0;
+    key_file->bit = 0;
+    key_file->key_size = 0;
+    key_file->serial = 0;
+    key_file->button = 0;
+    key_file->counter = 0;
+    key_file->crc = 0;
+    key_file->type = 0;
+    key_file->fields = 0;
+}
+
+bool protopirate_key_file_key_is(const char *line, size_t length, const char *key)
+{
+    return strlen(key) == length && strncmp(line, key, length) == 0;
+}
+
+const char *protopirate_key_file_split(const char *line, size_t *length)
+{
+    const char *value = strstr(line, ": ");
+    *length = value ? (size_t)(value - line) : strlen(line);
+    return value ? value + 2 : "";
+}
+
+static int protopirate_key_file_hex_digit(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+// "Key: 00 11 22 ..." as flipper_format_write_hex writes it, or one word of
+// digits like Kia V0's "%016llX". Two digits a byte, a word with an odd count
+// starts with a one digit byte.
+static void protopirate_key_file_parse_key(ProtoPirateKeyFile *key_file, const char *value)
+{
+    key_file->key_size = 0;
+    while (key_file->key_size < PROTOPIRATE_KEY_FILE_KEY_SIZE)
+    {
+        while (*value == ' ')
+            value++;
+
+        size_t digits = 0;
+        while (protopirate_key_file_hex_digit(value[digits]) >= 0)
+            digits++;
+        if (digits == 0)
+            break;
+
+        for (size_t i = 0; i < digits && key_file->key_size < PROTOPIRATE_KEY_FILE_KEY_SIZE;)
+        {
+            uint8_t byte = 0;
+            for (size_t end = (i == 0 && digits % 2) ? 1 : i + 2; i < end; i++)
+            {
+                byte = (byte << 4) | protopirate_key_file_hex_digit(value[i]);
+            }
+            key_file->key[key_file->key_size++] = byte;
+        }
+        value += digits;
+    }
+
+    if (key_file->key_size)
+    {
+        key_file->fields |= ProtoPirateKeyFileFieldKey;
+    }
+}
+
+void protopirate_key_file_parse_field(
+    ProtoPirateKeyFile *key_file,
+    const char *line,
+    size_t length,
+    const char *value)
+{
+    if (protopirate_key_file_key_is(line, length, "Protocol"))
+    {
+        furi_string_set_str(key_file->protocol, value);
+        key_file->fields |= ProtoPirateKeyFileFieldProtocol;
+    }
+    else if (protopirate_key_file_key_is(line, length, "Frequency"))
+    {
+        key_file->frequency = strtoul(value, NULL, 10);
+        key_file->fields |= ProtoPirateKeyFileFieldFrequency;
+    }
+    else if (protopirate_key_file_key_is(line, length, "Preset"))
+    {
+        furi_string_set_str(key_file->preset, value);
+        key_file->fields |= ProtoPirateKeyFileFieldPreset;
+    }
+    else if (protopirate_key_file_key_is(line, length, "Bit"))
+    {
+        key_file->bit = strtoul(value, NULL, 10);
+        key_file->fields |= ProtoPirateKeyFileFieldBit;
+    }
+    else if (protopirate_key_file_key_is(line, length, "Key"))
+    {
+        protopirate_key_file_parse_key(key_file, value);
+    }
+    else if (protopirate_key_file_key_is(line, length, "Serial"))
+    {
+        key_file->serial = strtoul(value, NULL, 10);
+        key_file->fields |= ProtoPirateKeyFileFieldSerial;
+    }
+    else if (protopirate_key_file_key_is(line, length, "Btn"))
+    {
+        key_file->button = strtoul(value, NULL, 10);
+        key_file->fields |= ProtoPirateKeyFileFieldButton;
+    }
+    else if (protopirate_key_file_key_is(line, length, "Cnt"))
+    {
+        key_file->counter = strtoul(value, NULL, 10);
+        key_file->fields |= ProtoPirateKeyFileFieldCounter;
+    }
+    else if (protopirate_key_file_key_is(line, length, "CRC"))
+    {
+        key_file->crc = strtoul(value, NULL, 10);
+        key_file->fields |= ProtoPirateKeyFileFieldCrc;
+    }
+    else if (protopirate_key_file_key_is(line, length, "Type"))
+    {
+        key_file->type = strtoul(value, NULL, 10);
+        key_file->fields |= ProtoPirateKeyFileFieldType;
+    }
+}
+
+bool protopirate_key_file_parse(ProtoPirateKeyFile *key_file, Stream *stream)
+{
+    furi_assert(key_file);
+    furi_assert(stream);
+
+    protopirate_key_file_reset(key_file);
+
+    Stream *data = flipper_format_get_raw_stream(key_file->data);
+    FuriString *line = furi_string_alloc();
+    bool header = false;
+    bool parsed = false;
+    size_t position = stream_tell(stream);
+
+    while (stream_read_line(stream, line))
+    {
+        furi_string_trim(line);
+        if (furi_string_empty(line) || furi_string_get_char(line, 0) == '#')
+        {
+            position = stream_tell(stream);
+            continue;
+        }
+
+        const char *text = furi_string_get_cstr(line);
+        size_t length;
+        const char *value = protopirate_key_file_split(text, &length);
+        parsed = true;
+
+        // Kia V3/V4 have a Version field too, only the one right behind
+        // Filetype belongs to the header
+        if (protopirate_key_file_key_is(text, length, "Filetype"))
+        {
+            furi_string_set_str(key_file->filetype, value);
+            header = true;
+        }
+        else if (header && protopirate_key_file_key_is(text, length, "Version"))
+        {
+            key_file->version = strtoul(value, NULL, 10);
+            header = false;
+        }
+        else if (protopirate_key_file_key_is(text, length, "RAW_Data"))
+        {
+            key_file->fields |= ProtoPirateKeyFileFieldRaw;
+            stream_seek(stream, position, StreamOffsetFromStart);
+            break;
+        }
+        else
+        {
+            header = false;
+            protopirate_key_file_parse_field(key_file, text, length, value);
+            furi_string_push_back(line, '\n');
+            stream_write_string(data, line);
+        }
+
+        position = stream_tell(stream);
+    }
+
+    furi_string_free(line);
+    flipper_format_rewind(key_file->data);
+    return parsed;
+}
+
+bool protopirate_key_file_load(ProtoPirateKeyFile *key_file, Storage *storage, const char *path)
+{
+    furi_assert(key_file);
+
+    Stream *stream = buffered_file_stream_alloc(storage);
+    bool result = false;
+
+    if (buffered_file_stream_open(stream, path, FSAM_READ, FSOM_OPEN_EXISTING))
+    {
+        result = protopirate_key_file_parse(key_file, stream);
+    }
+    else
+    {
+        FURI_LOG_E(TAG, "Failed to open %s", path);
+        protopirate_key_file_reset(key_file);
+    }
+
+    buffered_file_stream_close(stream);
+    stream_free(stream);
+    return result;
+}
@@ -0,0 +1,76 @@
+// helpers/protopirate_key_file.h
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+#include <flipper_format/flipper_format.h>
+#include <toolbox/stream/stream.h>
+
+// A SubGhz Key file read in one sequential pass. The fields the app looks at
+// are parsed into the record on the way, and every "Key: value" line except
+// the header is kept in an in-memory FlipperFormat for the decoders'
+// deserialize and for protopirate_storage_save_capture. Neither needs the file
+// again after that.
+//
+// A RAW file stops at its first RAW_Data line, the samples are far too big to
+// keep and get streamed from there by the caller.
+
+#define PROTOPIRATE_KEY_FILE_KEY_SIZE 16
+
+typedef enum {
+    ProtoPirateKeyFileFieldProtocol = (1 << 0),
+    ProtoPirateKeyFileFieldFrequency = (1 << 1),
+    ProtoPirateKeyFileFieldPreset = (1 << 2),
+    ProtoPirateKeyFileFieldBit = (1 << 3),
+    ProtoPirateKeyFileFieldKey = (1 << 4),
+    ProtoPirateKeyFileFieldSerial = (1 << 5),
+    ProtoPirateKeyFileFieldButton = (1 << 6),
+    ProtoPirateKeyFileFieldCounter = (1 << 7),
+    ProtoPirateKeyFileFieldCrc = (1 << 8),
+    ProtoPirateKeyFileFieldType = (1 << 9),
+    ProtoPirateKeyFileFieldRaw = (1 << 10), // RAW_Data follows, not loaded
+} ProtoPirateKeyFileField;
+
+typedef struct
+{
+    FuriString *filetype; // header, empty without one
+    uint32_t version;
+    FuriString *protocol;
+    FuriString *preset;
+    uint32_t frequency;
+    uint32_t bit;
+    uint8_t key[PROTOPIRATE_KEY_FILE_KEY_SIZE]; // "Key" hex bytes
+    uint8_t key_size;
+    uint32_t serial;
+    uint32_t button;
+    uint32_t counter;
+    uint32_t crc;
+    uint32_t type;
+    uint32_t fields; // ProtoPirateKeyFileField present in the file
+
+    FlipperFormat *data; // every field line, header excluded
+} ProtoPirateKeyFile;
+
+ProtoPirateKeyFile *protopirate_key_file_alloc(void);
+void protopirate_key_file_free(ProtoPirateKeyFile *key_file);
+void protopirate_key_file_reset(ProtoPirateKeyFile *key_file);
+
+// Parses from the current position of stream. On RAW_Data the stream is left at
+// the start of that line. False if nothing but comments was read.
+bool protopirate_key_file_parse(ProtoPirateKeyFile *key_file, Stream *stream);
+
+// Opens path, parses it and closes it again
+bool protopirate_key_file_load(ProtoPirateKeyFile *key_file, Storage *storage, const char *path);
+
+// The line parser behind protopirate_key_file_parse, for code that walks the
+// lines itself. split returns the value of a trimmed "Key: value" line and
+// the length of its key, "" for a line without a value.
+const char *protopirate_key_file_split(const char *line, size_t *length);
+bool protopirate_key_file_key_is(const char *line, size_t length, const char *key);
+// Typed copy of one field into key_file, values as flipper_format writes them.
+// Fields the record has no member for are ignored.
+void protopirate_key_file_parse_field(
+    ProtoPirateKeyFile *key_file,
+    const char *line,
+    size_t length,
+    const char *value);
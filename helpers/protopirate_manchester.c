@@ -0,0 +1,172 @@
+// helpers/protopirate_manchester.c
+#include "protopirate_manchester.h"
+#include <lib/subghz/blocks/math.h>
+
+// Transition table entries: next state in the low bits, then whether a bit
+// was finished and its value
+#define STEP_BIT 0x04
+#define STEP_ONE 0x08
+#define STEP(next) (ManchesterState##next)
+#define BIT0(next) (ManchesterState##next | STEP_BIT)
+#define BIT1(next) (ManchesterState##next | STEP_BIT | STEP_ONE)
+
+// First half-bit of each pair in a window of half-bits
+#define PAIR_FIRST 0xAAAAAAAAAAAAAAAAULL
+
+// [coding][state][event], events ShortLow, ShortHigh, LongLow, LongHigh with
+// 1 sent high then low
+static const uint8_t protopirate_manchester_steps[2][4][4] = {
+    [ProtoPirateManchesterCodingMid] =
+        {
+            [ManchesterStateStart1] = {STEP(Mid1), BIT1(Mid1), STEP(Mid1), STEP(Mid1)},
+            [ManchesterStateMid1] = {STEP(Start1), STEP(Mid1), BIT0(Mid0), STEP(Mid1)},
+            [ManchesterStateMid0] = {STEP(Mid1), STEP(Start0), STEP(Mid1), BIT1(Mid1)},
+            [ManchesterStateStart0] = {BIT0(Mid0), STEP(Mid1), STEP(Mid1), STEP(Mid1)},
+        },
+    [ProtoPirateManchesterCodingEnd] =
+        {
+            [ManchesterStateStart1] = {BIT1(Mid1), STEP(Mid1), BIT1(Start0), STEP(Mid1)},
+            [ManchesterStateMid1] = {STEP(Start0), STEP(Start1), STEP(Mid1), STEP(Mid1)},
+            [ManchesterStateMid0] = {STEP(Start0), STEP(Start1), STEP(Mid1), STEP(Mid1)},
+            [ManchesterStateStart0] = {STEP(Mid1), BIT0(Mid0), STEP(Mid1), BIT0(Start1)},
+        },
+};
+
+ProtoPirateManchesterEvent protopirate_manchester_event(
+    const ProtoPirateManchester* manchester,
+    bool level,
+    uint32_t duration) {
+    const SubGhzBlockConst* block_const = manchester->block_const;
+    uint8_t high = level ^ manchester->ieee;
+
+    if(DURATION_DIFF(duration, block_const->te_short) < block_const->te_delta) {
+        return ProtoPirateManchesterEventShortLow + high;
+    }
+    if(DURATION_DIFF(duration, block_const->te_long) < block_const->te_delta) {
+        return ProtoPirateManchesterEventLongLow + high;
+    }
+    return ProtoPirateManchesterEventNone;
+}
+
+bool protopirate_manchester_advance(
+    const ProtoPirateManchester* manchester,
+    ManchesterState* state,
+    ProtoPirateManchesterEvent event,
+    bool* bit) {
+    furi_assert(event < ProtoPirateManchesterEventNone);
+
+    uint8_t step = protopirate_manchester_steps[manchester->coding][*state][event];
+    *state = step & 0x03;
+    if(step & STEP_BIT) {
+        if(bit) *bit = step & STEP_ONE;
+        return true;
+    }
+    return false;
+}
+
+void protopirate_manchester_push_half(
+    uint64_t* halves,
+    uint16_t* count,
+    uint16_t capacity,
+    bool level) {
+    if(*count < capacity) {
+        uint64_t* word = &halves[*count / 64];
+        // A word's first half-bit shifts out stale bits from an earlier frame
+        *word = (*count % 64 ? *word << 1 : 0) | level;
+        (*count)++;
+    }
+}
+
+// Word index of halves left-aligned, the partial last word is kept in its low
+// bits while it fills up
+static uint64_t
+    protopirate_manchester_word(const uint64_t* halves, uint16_t count, uint16_t index) {
+    uint8_t filled = count % 64;
+    if(index == count / 64) {
+        return filled ? halves[index] << (64 - filled) : 0;
+    }
+    return halves[index];
+}
+
+// 64 half-bits from position on, MSB first
+static uint64_t
+    protopirate_manchester_window(const uint64_t* halves, uint16_t count, uint16_t position) {
+    uint16_t index = position / 64;
+    uint8_t shift = position % 64;
+    uint64_t window = protopirate_manchester_word(halves, count, index) << shift;
+    if(shift && index < count / 64) {
+        window |= protopirate_manchester_word(halves, count, index + 1) >> (64 - shift);
+    }
+    return window;
+}
+
+// The first half-bit of each of the 32 pairs of window, first pair in bit 31
+static uint32_t protopirate_manchester_compact(uint64_t window) {
+    uint64_t x = (window >> 1) & 0x5555555555555555ULL;
+    x = (x | (x >> 1)) & 0x3333333333333333ULL;
+    x = (x | (x >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+    x = (x | (x >> 4)) & 0x00FF00FF00FF00FFULL;
+    x = (x | (x >> 8)) & 0x0000FFFF0000FFFFULL;
+    x = (x | (x >> 16)) & 0x00000000FFFFFFFFULL;
+    return x;
+}
+
+// Pairs from one start offset, 32 per window: a pair is valid where its
+// halves differ, the run ends at the leading zero of that mask
+static uint8_t protopirate_manchester_decode_run(
+    const uint64_t* halves,
+    uint16_t count,
+    uint16_t offset,
+    uint8_t max_bits,
+    uint64_t* data) {
+    uint64_t value = 0;
+    uint8_t bits = 0;
+
+    for(uint16_t i = offset; bits < max_bits && i + 1 < count; i += 64) {
+        uint64_t window = protopirate_manchester_window(halves, count, i);
+        uint64_t invalid = ~(window ^ (window << 1)) & PAIR_FIRST;
+        uint8_t valid = invalid ? __builtin_clzll(invalid) / 2 : 32;
+
+        uint8_t take = MIN(valid, MIN((count - i) / 2, max_bits - bits));
+        if(take) {
+            value = (value << take) | (protopirate_manchester_compact(window) >> (32 - take));
+            bits += take;
+        }
+
+        // An invalid pair or the end of halves or max_bits
+        if(take < 32) break;
+    }
+
+    *data = value;
+    return bits;
+}
+
+uint8_t protopirate_manchester_decode_halves(
+    const ProtoPirateManchester* manchester,
+    const uint64_t* halves,
+    uint16_t count,
+    uint8_t max_bits,
+    uint64_t* data) {
+    furi_assert(max_bits <= 64);
+
+    uint8_t best_bits = 0;
+    uint64_t best_data = 0;
+
+    for(uint8_t i = 0; i < manchester->offset_count; i++) {
+        uint64_t run_data;
+        uint8_t run_bits = protopirate_manchester_decode_run(
+            halves, count, manchester->offset + i, max_bits, &run_data);
+        if(run_bits > best_bits) {
+            best_bits = run_bits;
+            best_data = run_data;
+        }
+    }
+
+    // The run holds first halves, 10 is a 1
+    if(manchester->ieee && best_bits) {
+        best_data ^= UINT64_MAX >> (64 - best_bits);
+    }
+
+    *data = best_data;
+    return best_bits;
+}
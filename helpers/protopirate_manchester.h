@@ -0,0 +1,79 @@
+// helpers/protopirate_manchester.h
+#pragma once
+
+#include <furi.h>
+#include <lib/subghz/blocks/const.h>
+#include <lib/toolbox/manchester_decoder.h>
+
+// Manchester decoding shared by the protocols, driven by a const descriptor
+// per protocol. Two ways in:
+//
+// Streaming, one pulse at a time: protopirate_manchester_event() classifies a
+// duration as a short (one half-bit) or long (two half-bits) event, and
+// protopirate_manchester_advance() looks the next state and any finished bit
+// up in the coding's transition table.
+//
+// Buffered, for decoders that collect half-bits during the frame and pair them
+// up at its end: protopirate_manchester_push_half() shifts them into 64-bit
+// words and protopirate_manchester_decode_halves() decodes 32 pairs per word
+// operation.
+
+typedef enum {
+    // Bit taken at its mid-bit edge, as lib/toolbox manchester_advance does
+    ProtoPirateManchesterCodingMid,
+    // Bit taken once its second half ends, a long pulse carries on into the
+    // first half of the next one
+    ProtoPirateManchesterCodingEnd,
+} ProtoPirateManchesterCoding;
+
+typedef enum {
+    ProtoPirateManchesterEventShortLow,
+    ProtoPirateManchesterEventShortHigh,
+    ProtoPirateManchesterEventLongLow,
+    ProtoPirateManchesterEventLongHigh,
+    ProtoPirateManchesterEventNone, // fits neither te_short nor te_long
+} ProtoPirateManchesterEvent;
+
+typedef struct {
+    const SubGhzBlockConst* block_const; // te_short is one half-bit, te_long two
+    ProtoPirateManchesterCoding coding;
+    bool ieee; // 1 is sent low then high, the default is high then low
+    ManchesterState start; // streaming: state the data starts in
+    uint8_t offset; // buffered: first half-bit a frame can start at
+    uint8_t offset_count; // buffered: offsets tried from there on
+} ProtoPirateManchester;
+
+// DURATION_DIFF(duration, te) < te_delta against te_short, then te_long
+ProtoPirateManchesterEvent protopirate_manchester_event(
+    const ProtoPirateManchester* manchester,
+    bool level,
+    uint32_t duration);
+
+// One table step. An invalid event for the state goes back to
+// ManchesterStateMid1, like manchester_advance. True when event finished a
+// bit, its value is stored in *bit.
+bool protopirate_manchester_advance(
+    const ProtoPirateManchester* manchester,
+    ManchesterState* state,
+    ProtoPirateManchesterEvent event,
+    bool* bit);
+
+// Appends one half-bit level to halves, words filled MSB first with the last
+// one in its low bits until full. Nothing past capacity half-bits is kept.
+void protopirate_manchester_push_half(
+    uint64_t* halves,
+    uint16_t* count,
+    uint16_t capacity,
+    bool level);
+
+// halves holds count half-bit levels as protopirate_manchester_push_half
+// leaves them. From each start offset of manchester, pairs are decoded until
+// max_bits, the end of halves or the first pair that isn't a valid bit. The
+// longest run, the first of equal ones, ends up in *data and its length is
+// returned.
+uint8_t protopirate_manchester_decode_halves(
+    const ProtoPirateManchester* manchester,
+    const uint64_t* halves,
+    uint16_t count,
+    uint8_t max_bits,
+    uint64_t* data);
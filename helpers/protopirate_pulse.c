@@ -0,0 +1,52 @@
+// helpers/protopirate_pulse.c
+#include "protopirate_pulse.h"
+
+// DURATION_DIFF(duration, te) < delta as lo <= duration < hi
+static void protopirate_pulse_window(uint32_t te, uint32_t delta, uint32_t* lo, uint32_t* hi) {
+    *lo = (te + 1 > delta) ? te + 1 - delta : 0;
+    *hi = te + delta;
+}
+
+void protopirate_pulse_family_init(
+    ProtoPiratePulseFamily* family,
+    const SubGhzBlockConst* block_const) {
+    furi_assert(family);
+    furi_assert(block_const);
+    protopirate_pulse_window(
+        block_const->te_short, block_const->te_delta, &family->short_lo, &family->short_hi);
+    protopirate_pulse_window(
+        block_const->te_long, block_const->te_delta, &family->long_lo, &family->long_hi);
+    furi_check(family->short_hi <= family->long_lo);
+}
+
+bool protopirate_pulse_family_is(
+    const ProtoPiratePulseFamily* family,
+    const SubGhzBlockConst* block_const) {
+    ProtoPiratePulseFamily other;
+    protopirate_pulse_family_init(&other, block_const);
+    return memcmp(family, &other, sizeof(other)) == 0;
+}
+
+uint8_t
+    protopirate_pulse_quantize(const ProtoPiratePulseFamily* family, bool level, uint32_t duration) {
+    uint8_t symbol = level ? PROTOPIRATE_PULSE_HIGH : 0;
+
+    if(duration < family->short_hi) {
+        if(duration >= family->short_lo) symbol |= ProtoPiratePulseClassShort;
+    } else if(duration < family->long_hi) {
+        if(duration >= family->long_lo) symbol |= ProtoPiratePulseClassLong;
+    } else {
+        symbol |= PROTOPIRATE_PULSE_GAP;
+    }
+    return symbol;
+}
+
+ProtoPiratePulse
+    protopirate_pulse_make(const SubGhzBlockConst* block_const, bool level, uint32_t duration) {
+    ProtoPiratePulseFamily family;
+    protopirate_pulse_family_init(&family, block_const);
+    return (ProtoPiratePulse){
+        .duration = duration,
+        .symbol = protopirate_pulse_quantize(&family, level, duration),
+    };
+}
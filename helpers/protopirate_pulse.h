@@ -0,0 +1,69 @@
+// helpers/protopirate_pulse.h
+#pragma once
+
+#include <furi.h>
+#include <lib/subghz/blocks/const.h>
+
+// A pulse quantized once against a timing family, the te_short, te_long and
+// te_delta of a SubGhzBlockConst, into a one byte symbol: its class, its level
+// and whether it's a gap, longer than any class of the family.
+//
+// The decoder set quantizes each pulse once per family in use and hands the
+// symbol of its family to every decoder whose ProtoPirateEntry has a
+// feed_pulse, so far the PWM ones (Kia V0, BMW, Honda, Mitsubishi, Peugeot,
+// Citroen). Protocols sharing timings share the work, Peugeot and Citroen
+// at 370/772. Such a decoder's plain feed quantizes the pulse itself and goes
+// the same way.
+//
+// Classes match DURATION_DIFF(duration, te) < te_delta, te_short first. The
+// short and long windows of a family must not overlap.
+
+typedef enum {
+    ProtoPiratePulseClassNone, // fits neither te_short nor te_long
+    ProtoPiratePulseClassShort,
+    ProtoPiratePulseClassLong,
+} ProtoPiratePulseClass;
+
+#define PROTOPIRATE_PULSE_CLASS 0x03 // ProtoPiratePulseClass
+#define PROTOPIRATE_PULSE_HIGH  (1 << 2)
+#define PROTOPIRATE_PULSE_GAP   (1 << 3) // at least te_long + te_delta
+
+#define PROTOPIRATE_PULSE_SYMBOL(level, pulse_class) \
+    (((level) ? PROTOPIRATE_PULSE_HIGH : 0) | (pulse_class))
+
+typedef struct {
+    uint32_t duration; // for the windows that aren't classes, sync and end gaps
+    uint8_t symbol;
+} ProtoPiratePulse;
+
+// Class bounds of a family, lo <= duration < hi
+typedef struct {
+    uint32_t short_lo;
+    uint32_t short_hi;
+    uint32_t long_lo;
+    uint32_t long_hi; // gaps start here
+} ProtoPiratePulseFamily;
+
+void protopirate_pulse_family_init(
+    ProtoPiratePulseFamily* family,
+    const SubGhzBlockConst* block_const);
+
+// Whether block_const has the timings of family
+bool protopirate_pulse_family_is(
+    const ProtoPiratePulseFamily* family,
+    const SubGhzBlockConst* block_const);
+
+uint8_t
+    protopirate_pulse_quantize(const ProtoPiratePulseFamily* family, bool level, uint32_t duration);
+
+// For a plain feed: quantizes against block_const on the spot
+ProtoPiratePulse
+    protopirate_pulse_make(const SubGhzBlockConst* block_const, bool level, uint32_t duration);
+
+static inline ProtoPiratePulseClass protopirate_pulse_class(uint8_t symbol) {
+    return symbol & PROTOPIRATE_PULSE_CLASS;
+}
+
+static inline bool protopirate_pulse_level(uint8_t symbol) {
+    return symbol & PROTOPIRATE_PULSE_HIGH;
+}
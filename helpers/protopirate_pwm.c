@@ -0,0 +1,139 @@
+// helpers/protopirate_pwm.c
+#include "protopirate_pwm.h"
+
+static inline bool protopirate_pwm_in(const ProtoPiratePwmWindow* window, uint32_t duration) {
+    return duration > window->lo && duration < window->hi;
+}
+
+static inline bool
+    protopirate_pwm_bit(const ProtoPiratePwmBit* bit, uint8_t high_class, uint8_t low_class) {
+    return bit->high == high_class && bit->low == low_class;
+}
+
+// A high of at least pwm->end: hand the frame on if its bit count fits, then
+// back to the protocol's own reset
+static void protopirate_pwm_end(
+    const ProtoPiratePwm* pwm,
+    ProtoPiratePwmDecoder* instance,
+    uint32_t duration) {
+    uint16_t count_bit = instance->decoder.decode_count_bit;
+    uint16_t min_count_bit = pwm->block_const->min_count_bit_for_found;
+
+    if(count_bit >= min_count_bit && (!pwm->max_count_bit || count_bit <= pwm->max_count_bit)) {
+        instance->generic.data = instance->decoder.decode_data;
+        instance->generic.data_count_bit = count_bit;
+
+        if(!pwm->frame || pwm->frame(instance)) {
+            PROTOPIRATE_TRACE_EVENT(
+                pwm->trace,
+                ProtoPirateTraceEventDecoded,
+                ProtoPiratePwmStepSaveDuration,
+                count_bit,
+                duration);
+            if(instance->base.callback) {
+                instance->base.callback(&instance->base, instance->base.context);
+            }
+        }
+    } else {
+        PROTOPIRATE_TRACE_EVENT(
+            pwm->trace,
+            PROTOPIRATE_TRACE_END_EVENT(count_bit, min_count_bit),
+            ProtoPiratePwmStepSaveDuration,
+            count_bit,
+            duration);
+    }
+
+    instance->base.protocol->decoder->reset(instance);
+}
+
+void protopirate_pwm_feed(const ProtoPiratePwm* pwm, void* context, bool level, uint32_t duration) {
+    furi_assert(pwm);
+    protopirate_pwm_feed_pulse(
+        pwm, context, protopirate_pulse_make(pwm->block_const, level, duration));
+}
+
+void protopirate_pwm_feed_pulse(const ProtoPiratePwm* pwm, void* context, ProtoPiratePulse pulse) {
+    furi_assert(pwm);
+    furi_assert(context);
+    ProtoPiratePwmDecoder* instance = context;
+    SubGhzBlockDecoder* decoder = &instance->decoder;
+    bool level = protopirate_pulse_level(pulse.symbol);
+    ProtoPiratePulseClass pulse_class = protopirate_pulse_class(pulse.symbol);
+    uint32_t duration = pulse.duration;
+
+    switch(decoder->parser_step) {
+    case ProtoPiratePwmStepReset:
+        if(level && pulse_class == ProtoPiratePulseClassShort) {
+            decoder->parser_step = ProtoPiratePwmStepCheckPreamble;
+            decoder->te_last = duration;
+            instance->high_class = pulse_class;
+            instance->header_count = 0;
+            decoder->decode_data = 0;
+            decoder->decode_count_bit = 0;
+        }
+        break;
+
+    case ProtoPiratePwmStepCheckPreamble:
+        if(level) {
+            if(pulse_class == ProtoPiratePulseClassShort ||
+               (pwm->preamble_long && pulse_class == ProtoPiratePulseClassLong)) {
+                decoder->te_last = duration;
+                instance->high_class = pulse_class;
+            } else {
+                decoder->parser_step = ProtoPiratePwmStepReset;
+            }
+        } else if(
+            pulse_class == ProtoPiratePulseClassShort &&
+            instance->high_class == ProtoPiratePulseClassShort) {
+            instance->header_count++;
+        } else if(
+            protopirate_pwm_in(&pwm->sync, duration) &&
+            (!pwm->sync_after_long || instance->high_class == ProtoPiratePulseClassLong) &&
+            instance->header_count >= pwm->sync_header_count) {
+            decoder->parser_step = ProtoPiratePwmStepSaveDuration;
+            decoder->decode_data = pwm->start_data;
+            decoder->decode_count_bit = pwm->start_count_bit;
+            PROTOPIRATE_TRACE_EVENT(
+                pwm->trace,
+                ProtoPirateTraceEventSync,
+                ProtoPiratePwmStepCheckPreamble,
+                instance->header_count,
+                duration);
+        } else {
+            decoder->parser_step = ProtoPiratePwmStepReset;
+        }
+        break;
+
+    case ProtoPiratePwmStepSaveDuration:
+        if(!level) {
+            decoder->parser_step = ProtoPiratePwmStepReset;
+        } else if((pulse.symbol & PROTOPIRATE_PULSE_GAP) && duration >= pwm->end) {
+            protopirate_pwm_end(pwm, instance, duration);
+        } else {
+            decoder->te_last = duration;
+            instance->high_class = pulse_class;
+            decoder->parser_step = ProtoPiratePwmStepCheckDuration;
+        }
+        break;
+
+    case ProtoPiratePwmStepCheckDuration:
+        if(level) {
+            decoder->parser_step = ProtoPiratePwmStepReset;
+        } else if(protopirate_pwm_bit(&pwm->zero, instance->high_class, pulse_class)) {
+            subghz_protocol_blocks_add_bit(decoder, 0);
+            decoder->parser_step = ProtoPiratePwmStepSaveDuration;
+        } else if(protopirate_pwm_bit(&pwm->one, instance->high_class, pulse_class)) {
+            subghz_protocol_blocks_add_bit(decoder, 1);
+            decoder->parser_step = ProtoPiratePwmStepSaveDuration;
+        } else {
+            PROTOPIRATE_TRACE_EVENT(
+                pwm->trace,
+                ProtoPirateTraceEventMismatch,
+                ProtoPiratePwmStepCheckDuration,
+                decoder->decode_count_bit,
+                duration);
+            decoder->parser_step = ProtoPiratePwmStepReset;
+        }
+        break;
+    }
+}
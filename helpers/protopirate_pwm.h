@@ -0,0 +1,86 @@
+// helpers/protopirate_pwm.h
+#pragma once
+
+#include <furi.h>
+#include <lib/subghz/protocols/base.h>
+#include <lib/subghz/blocks/const.h>
+#include <lib/subghz/blocks/decoder.h>
+#include <lib/subghz/blocks/generic.h>
+#include "protopirate_pulse.h"
+#include "protopirate_trace.h"
+
+// Decoder for the protocols sending each bit as a high pulse followed by a low
+// one, the pair of durations giving the bit. They all go
+//
+//   Reset          high te_short starts the preamble
+//   CheckPreamble  short high/short low pairs are counted until the sync low
+//   SaveDuration   a high pulse is kept, one of at least end ends the frame
+//   CheckDuration  the low pulse after it makes a bit with it
+//
+// and differ only in the timings and checks a const ProtoPiratePwm gives. The
+// decoder struct of such a protocol starts like ProtoPiratePwmDecoder, its
+// feed hands itself to protopirate_pwm_feed, its entry's feed_pulse to
+// protopirate_pwm_feed_pulse, and its reset goes back to
+// ProtoPiratePwmStepReset. A frame ends with that reset.
+//
+// Short and long are the pulse classes of block_const, only the sync and the
+// end are checked against the duration.
+
+typedef enum {
+    ProtoPiratePwmStepReset = 0,
+    ProtoPiratePwmStepCheckPreamble,
+    ProtoPiratePwmStepSaveDuration,
+    ProtoPiratePwmStepCheckDuration,
+} ProtoPiratePwmStep;
+
+// DURATION_DIFF(duration, te) < delta, as the bounds lo < duration < hi
+typedef struct {
+    uint32_t lo;
+    uint32_t hi;
+} ProtoPiratePwmWindow;
+
+#define PROTOPIRATE_PWM_WINDOW(te, delta) {.lo = (te) - (delta), .hi = (te) + (delta)}
+#define PROTOPIRATE_PWM_LONG(block_const) \
+    PROTOPIRATE_PWM_WINDOW((block_const).te_long, (block_const).te_delta)
+
+// ProtoPiratePulseClass of the high and the low pulse
+typedef struct {
+    uint8_t high;
+    uint8_t low;
+} ProtoPiratePwmBit;
+
+typedef struct {
+    SubGhzProtocolDecoderBase base;
+    SubGhzBlockDecoder decoder;
+    SubGhzBlockGeneric generic;
+    uint16_t header_count;
+    uint8_t high_class; // ProtoPiratePulseClass of the last high
+} ProtoPiratePwmDecoder;
+
+typedef struct {
+    const SubGhzBlockConst* block_const; // pulse classes, min_count_bit_for_found
+    ProtoPirateTraceProtocol trace;
+
+    bool preamble_long; // long highs are allowed in the preamble too
+
+    ProtoPiratePwmWindow sync; // low ending the preamble
+    bool sync_after_long; // only right after a long high
+    uint16_t sync_header_count; // short pairs needed before it
+
+    // decode_data and decode_count_bit when the data starts
+    uint64_t start_data;
+    uint16_t start_count_bit;
+
+    ProtoPiratePwmBit zero;
+    ProtoPiratePwmBit one;
+    uint32_t end; // high at least this long ends the frame, a gap of block_const
+    uint16_t max_count_bit; // 0 for any count from min_count_bit_for_found on
+
+    // Called with generic.data and data_count_bit set on a frame with a
+    // valid bit count, fills in the rest of generic. False drops the frame.
+    // NULL takes every frame.
+    bool (*frame)(void* context);
+} ProtoPiratePwm;
+
+void protopirate_pwm_feed(const ProtoPiratePwm* pwm, void* context, bool level, uint32_t duration);
+void protopirate_pwm_feed_pulse(const ProtoPiratePwm* pwm, void* context, ProtoPiratePulse pulse);
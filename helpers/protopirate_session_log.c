@@ -0,0 +1,402 @@
+// helpers/protopirate_session_log.c
+#include "protopirate_session_log.h"
+#include <furi_hal_rtc.h>
+#include <toolbox/stream/stream.h>
+
+#define TAG "ProtoPirateSessionLog"
+
+#define SESSION_LOG_MAGIC        0x4C535050 // "PPSL"
+#define SESSION_LOG_VERSION      1
+#define SESSION_LOG_RECORD_MAGIC 0x5250 // "PR"
+#define SESSION_LOG_RECORD_DONE  0x4450 // "PD", already exported
+
+#define SESSION_LOG_PREALLOC    (64 * 1024) // grown in steps of this
+#define SESSION_LOG_BUFFER_SIZE (2 * 1024)
+// Oldest buffered record waits about this long, checked on append and by
+// flush_due, which the receiver calls from the idle capture thread
+#define SESSION_LOG_FLUSH_MS    10000
+#define SESSION_LOG_MAX_FILES   64 // per export run
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+} __attribute__((packed)) SessionLogHeader;
+
+typedef struct
+{
+    uint16_t magic;
+    uint16_t size; // payload bytes that follow
+    uint32_t timestamp; // RTC, seconds
+} __attribute__((packed)) SessionLogRecord;
+
+struct ProtoPirateSessionLog
+{
+    Storage *storage;
+    File *file;
+    FuriString *path;
+
+    // Pending records plus room for the terminator written behind every batch
+    uint8_t buffer[SESSION_LOG_BUFFER_SIZE + sizeof(SessionLogRecord)];
+    size_t buffered;
+    uint32_t buffered_since;
+
+    uint64_t written;
+    uint64_t allocated;
+    uint32_t count;
+};
+
+static void protopirate_session_log_preallocate(ProtoPirateSessionLog *log, uint64_t needed)
+{
+    if (needed <= log->allocated)
+        return;
+
+    uint64_t size = log->allocated;
+    while (size < needed)
+    {
+        size += SESSION_LOG_PREALLOC;
+    }
+
+    // FAT finds contiguous clusters once instead of on every batch
+    if (storage_file_expand(log->file, size))
+    {
+        log->allocated = size;
+    }
+    else
+    {
+        FURI_LOG_W(TAG, "Preallocating %llu bytes failed", (unsigned long long)size);
+    }
+}
+
+// Writes data at the end of the log followed by an empty record. Expanded
+// clusters aren't zeroed, the terminator is what a reader stops at if the
+// session never got to close.
+static bool protopirate_session_log_write(ProtoPirateSessionLog *log, uint8_t *data, size_t size)
+{
+    memset(data + size, 0, sizeof(SessionLogRecord));
+    size_t total = size + sizeof(SessionLogRecord);
+
+    protopirate_session_log_preallocate(log, log->written + total);
+    if (!storage_file_seek(log->file, log->written, true))
+        return false;
+    if (storage_file_write(log->file, data, total) != total)
+        return false;
+
+    log->written += size;
+    return true;
+}
+
+ProtoPirateSessionLog *protopirate_session_log_open(void)
+{
+    if (!protopirate_storage_init())
+        return NULL;
+
+    ProtoPirateSessionLog *log = malloc(sizeof(ProtoPirateSessionLog));
+    log->storage = furi_record_open(RECORD_STORAGE);
+    log->file = storage_file_alloc(log->storage);
+    log->path = furi_string_alloc();
+    log->buffered = 0;
+    log->buffered_since = 0;
+    log->written = 0;
+    log->allocated = 0;
+    log->count = 0;
+
+    storage_simply_mkdir(log->storage, PROTOPIRATE_SESSION_FOLDER);
+
+    DateTime datetime;
+    furi_hal_rtc_get_datetime(&datetime);
+    furi_string_printf(
+        log->path,
+        "%s/session_%04u%02u%02u_%02u%02u%02u%s",
+        PROTOPIRATE_SESSION_FOLDER,
+        datetime.year,
+        datetime.month,
+        datetime.day,
+        datetime.hour,
+        datetime.minute,
+        datetime.second,
+        PROTOPIRATE_SESSION_EXTENSION);
+
+    bool ok = false;
+    do
+    {
+        if (!storage_file_open(log->file, furi_string_get_cstr(log->path), FSAM_WRITE, FSOM_CREATE_ALWAYS))
+        {
+            FURI_LOG_E(TAG, "Failed to create %s", furi_string_get_cstr(log->path));
+            break;
+        }
+
+        SessionLogHeader *header = (SessionLogHeader *)log->buffer;
+        header->magic = SESSION_LOG_MAGIC;
+        header->version = SESSION_LOG_VERSION;
+        header->reserved = 0;
+        if (!protopirate_session_log_write(log, log->buffer, sizeof(SessionLogHeader)))
+        {
+            FURI_LOG_E(TAG, "Failed to write header");
+            break;
+        }
+        ok = true;
+    } while (false);
+
+    if (!ok)
+    {
+        storage_file_close(log->file);
+        storage_file_free(log->file);
+        furi_record_close(RECORD_STORAGE);
+        furi_string_free(log->path);
+        free(log);
+        return NULL;
+    }
+
+    FURI_LOG_I(TAG, "Session log %s", furi_string_get_cstr(log->path));
+    return log;
+}
+
+bool protopirate_session_log_flush(ProtoPirateSessionLog *log)
+{
+    furi_assert(log);
+    if (log->buffered == 0)
+        return true;
+
+    bool result = protopirate_session_log_write(log, log->buffer, log->buffered);
+    if (!result)
+    {
+        FURI_LOG_E(TAG, "Failed to write %zu bytes", log->buffered);
+    }
+    log->buffered = 0;
+    return result;
+}
+
+bool protopirate_session_log_append(ProtoPirateSessionLog *log, FlipperFormat *flipper_format)
+{
+    furi_assert(log);
+    furi_assert(flipper_format);
+
+    Stream *stream = flipper_format_get_raw_stream(flipper_format);
+    size_t size = stream_size(stream);
+    size_t record_size = sizeof(SessionLogRecord) + size;
+    if (size == 0 || record_size > SESSION_LOG_BUFFER_SIZE)
+    {
+        FURI_LOG_E(TAG, "Capture of %zu bytes doesn't fit a record", size);
+        return false;
+    }
+
+    if (log->buffered + record_size > SESSION_LOG_BUFFER_SIZE)
+    {
+        protopirate_session_log_flush(log);
+    }
+
+    SessionLogRecord *record = (SessionLogRecord *)(log->buffer + log->buffered);
+    record->magic = SESSION_LOG_RECORD_MAGIC;
+    record->size = size;
+    record->timestamp = furi_hal_rtc_get_timestamp();
+
+    stream_rewind(stream);
+    if (stream_read(stream, log->buffer + log->buffered + sizeof(SessionLogRecord), size) != size)
+    {
+        return false;
+    }
+
+    if (log->buffered == 0)
+    {
+        log->buffered_since = furi_get_tick();
+    }
+    log->buffered += record_size;
+    log->count++;
+
+    return protopirate_session_log_flush_due(log);
+}
+
+bool protopirate_session_log_flush_due(ProtoPirateSessionLog *log)
+{
+    furi_assert(log);
+    if (log->buffered &&
+        furi_get_tick() - log->buffered_since >= furi_ms_to_ticks(SESSION_LOG_FLUSH_MS))
+    {
+        return protopirate_session_log_flush(log);
+    }
+    return true;
+}
+
+uint32_t protopirate_session_log_get_count(ProtoPirateSessionLog *log)
+{
+    furi_assert(log);
+    return log->count;
+}
+
+void protopirate_session_log_close(ProtoPirateSessionLog *log)
+{
+    furi_assert(log);
+    protopirate_session_log_flush(log);
+
+    // Drop the unused part of the preallocation, the terminator goes with it
+    if (storage_file_seek(log->file, log->written, true))
+    {
+        storage_file_truncate(log->file);
+    }
+
+    FURI_LOG_I(
+        TAG,
+        "Closed %s: %lu captures, %llu bytes",
+        furi_string_get_cstr(log->path),
+        log->count,
+        (unsigned long long)log->written);
+
+    storage_file_close(log->file);
+    storage_file_free(log->file);
+    furi_record_close(RECORD_STORAGE);
+    furi_string_free(log->path);
+    free(log);
+}
+
+// Marks the record at offset as exported and moves on past its payload
+static bool protopirate_session_log_mark_done(File *file, uint64_t offset, uint16_t size)
+{
+    uint16_t magic = SESSION_LOG_RECORD_DONE;
+    return storage_file_seek(file, offset, true) &&
+           storage_file_write(file, &magic, sizeof(magic)) == sizeof(magic) &&
+           storage_file_seek(file, offset + sizeof(SessionLogRecord) + size, true);
+}
+
+// One .sub per record not exported yet, false if the log is unreadable or a
+// save failed
+static bool protopirate_session_log_export_file(Storage *storage, const char *path, uint32_t *exported)
+{
+    File *file = storage_file_alloc(storage);
+    bool result = false;
+
+    do
+    {
+        if (!storage_file_open(file, path, FSAM_READ_WRITE, FSOM_OPEN_EXISTING))
+        {
+            FURI_LOG_E(TAG, "Failed to open %s", path);
+            break;
+        }
+
+        SessionLogHeader header;
+        if (storage_file_read(file, &header, sizeof(header)) != sizeof(header) ||
+            header.magic != SESSION_LOG_MAGIC || header.version != SESSION_LOG_VERSION)
+        {
+            FURI_LOG_E(TAG, "%s is not a session log", path);
+            break;
+        }
+
+        result = true;
+        SessionLogRecord record;
+        FuriString *protocol = furi_string_alloc();
+        uint64_t offset = storage_file_tell(file);
+
+        while (storage_file_read(file, &record, sizeof(record)) == sizeof(record) &&
+               (record.magic == SESSION_LOG_RECORD_MAGIC || record.magic == SESSION_LOG_RECORD_DONE) &&
+               record.size > 0)
+        {
+            uint64_t next = offset + sizeof(record) + record.size;
+            if (record.magic == SESSION_LOG_RECORD_DONE)
+            {
+                if (!storage_file_seek(file, next, true))
+                    break;
+                offset = next;
+                continue;
+            }
+
+            uint8_t *payload = malloc(record.size);
+            if (storage_file_read(file, payload, record.size) != record.size)
+            {
+                free(payload);
+                break;
+            }
+
+            FlipperFormat *flipper_format = flipper_format_string_alloc();
+            stream_write(flipper_format_get_raw_stream(flipper_format), payload, record.size);
+            free(payload);
+
+            flipper_format_rewind(flipper_format);
+            if (!flipper_format_read_string(flipper_format, "Protocol", protocol))
+            {
+                furi_string_set_str(protocol, "Unknown");
+            }
+            furi_string_replace_all(protocol, "/", "_");
+            furi_string_replace_all(protocol, " ", "_");
+
+            if (protopirate_storage_save_capture(flipper_format, furi_string_get_cstr(protocol), NULL))
+            {
+                (*exported)++;
+                // Without the mark a retry would save this one again
+                if (!protopirate_session_log_mark_done(file, offset, record.size))
+                {
+                    FURI_LOG_E(TAG, "Failed to mark a record of %s exported", path);
+                    result = false;
+                    flipper_format_free(flipper_format);
+                    break;
+                }
+            }
+            else
+            {
+                result = false;
+            }
+            flipper_format_free(flipper_format);
+            offset = next;
+        }
+
+        furi_string_free(protocol);
+    } while (false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    return result;
+}
+
+bool protopirate_session_log_export_all(uint32_t *out_exported)
+{
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    File *dir = storage_file_alloc(storage);
+    FileInfo file_info;
+    char name[64];
+
+    // Collect names first, files get removed while exporting
+    char(*names)[64] = malloc(sizeof(name) * SESSION_LOG_MAX_FILES);
+    size_t count = 0;
+    if (storage_dir_open(dir, PROTOPIRATE_SESSION_FOLDER))
+    {
+        while (count < SESSION_LOG_MAX_FILES && storage_dir_read(dir, &file_info, name, sizeof(name)))
+        {
+            if (!file_info_is_dir(&file_info) && strstr(name, PROTOPIRATE_SESSION_EXTENSION))
+            {
+                strlcpy(names[count++], name, sizeof(name));
+            }
+        }
+    }
+    storage_dir_close(dir);
+    storage_file_free(dir);
+
+    bool result = true;
+    uint32_t exported = 0;
+    FuriString *path = furi_string_alloc();
+
+    for (size_t i = 0; i < count; i++)
+    {
+        furi_string_printf(path, "%s/%s", PROTOPIRATE_SESSION_FOLDER, names[i]);
+        uint32_t file_exported = 0;
+        if (protopirate_session_log_export_file(storage, furi_string_get_cstr(path), &file_exported))
+        {
+            storage_simply_remove(storage, furi_string_get_cstr(path));
+        }
+        else
+        {
+            result = false;
+        }
+        FURI_LOG_I(TAG, "Exported %lu captures from %s", file_exported, names[i]);
+        exported += file_exported;
+    }
+
+    furi_string_free(path);
+    free(names);
+    furi_record_close(RECORD_STORAGE);
+
+    if (out_exported)
+    {
+        *out_exported = exported;
+    }
+    return result;
+}
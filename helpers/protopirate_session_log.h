@@ -0,0 +1,38 @@
+// helpers/protopirate_session_log.h
+#pragma once
+
+#include <furi.h>
+#include <flipper_format/flipper_format.h>
+#include "protopirate_storage.h"
+
+// Append-only capture log for long auto-save sessions. One preallocated file
+// per receiver session under PROTOPIRATE_SESSION_FOLDER, each record is the
+// serialized capture ("Key: value" lines, same as a .sub without the header)
+// behind a small length prefix. Records are buffered in RAM and written in
+// batches, a record of size 0 (the preallocated tail) ends the log.
+//
+// Not thread safe: open, append and close from one thread at a time.
+
+#define PROTOPIRATE_SESSION_FOLDER    PROTOPIRATE_APP_FOLDER "/sessions"
+#define PROTOPIRATE_SESSION_EXTENSION ".log"
+
+typedef struct ProtoPirateSessionLog ProtoPirateSessionLog;
+
+// New session file named after the RTC time, NULL if it can't be created
+ProtoPirateSessionLog *protopirate_session_log_open(void);
+// Flushes, trims the preallocated tail and frees the log
+void protopirate_session_log_close(ProtoPirateSessionLog *log);
+
+bool protopirate_session_log_append(ProtoPirateSessionLog *log, FlipperFormat *flipper_format);
+bool protopirate_session_log_flush(ProtoPirateSessionLog *log);
+// Flushes once the oldest buffered record is due, call it now and then while
+// no captures come in
+bool protopirate_session_log_flush_due(ProtoPirateSessionLog *log);
+uint32_t protopirate_session_log_get_count(ProtoPirateSessionLog *log);
+
+// Expands every session log into "Flipper SubGhz Key File" .sub files through
+// protopirate_storage_save_capture. Each record is marked done in the log once
+// its file is saved, so a later run only retries the ones that failed. A log
+// is deleted once all of its records were written. Returns false if any
+// record failed.
+bool protopirate_session_log_export_all(uint32_t *out_exported);
@@ -9,11 +9,18 @@
 #define SETTINGS_FILE_HEADER "ProtoPirate Settings"
 #define SETTINGS_FILE_VERSION 1
 
+// Off, so decoding stays as it was for old settings files without the key.
+// 60 us is the value to pick when noise breaks frames up, well below the
+// shortest pulse of any protocol, Fiat V0's 200 - 100 us.
+#define SETTINGS_GLITCH_FILTER_DEFAULT 0
+
 void protopirate_settings_set_defaults(ProtoPirateSettings* settings) {
     settings->frequency = 433920000;
     settings->preset_index = 0;
     settings->auto_save = false;
+    settings->auto_save_log = false;
     settings->hopping_enabled = false;
+    settings->glitch_filter_us = SETTINGS_GLITCH_FILTER_DEFAULT;
 }
 
 void protopirate_settings_load(ProtoPirateSettings* settings) {
@@ -60,13 +67,14 @@ void protopirate_settings_load(ProtoPirateSettings* settings) {
         }
         settings->preset_index = (uint8_t)preset_temp;
         
-        // Read auto-save
+        // Read auto-save, 2 is the session log
         uint32_t auto_save_temp = 0;
         if(!flipper_format_read_uint32(ff, "AutoSave", &auto_save_temp, 1)) {
             FURI_LOG_W(TAG, "Failed to read auto-save, using default");
             auto_save_temp = 0;
         }
-        settings->auto_save = (auto_save_temp == 1);
+        settings->auto_save = (auto_save_temp != 0);
+        settings->auto_save_log = (auto_save_temp == 2);
         
         // Read hopping
         uint32_t hopping_temp = 0;
@@ -76,9 +84,15 @@ void protopirate_settings_load(ProtoPirateSettings* settings) {
         }
         settings->hopping_enabled = (hopping_temp == 1);
         
-        FURI_LOG_I(TAG, "Settings loaded: freq=%lu, preset=%u, auto_save=%d, hopping=%d",
+        // Read glitch filter
+        if(!flipper_format_read_uint32(ff, "GlitchFilter", &settings->glitch_filter_us, 1)) {
+            FURI_LOG_W(TAG, "Failed to read glitch filter, using default");
+            settings->glitch_filter_us = SETTINGS_GLITCH_FILTER_DEFAULT;
+        }
+        
+        FURI_LOG_I(TAG, "Settings loaded: freq=%lu, preset=%u, auto_save=%d, hopping=%d, glitch=%lu",
             settings->frequency, settings->preset_index, 
-            settings->auto_save, settings->hopping_enabled);
+            settings->auto_save, settings->hopping_enabled, settings->glitch_filter_us);
             
     } while(false);
     
@@ -116,7 +130,7 @@ void protopirate_settings_save(ProtoPirateSettings* settings) {
             break;
         }
         
-        uint32_t auto_save_temp = settings->auto_save ? 1 : 0;
+        uint32_t auto_save_temp = settings->auto_save ? (settings->auto_save_log ? 2 : 1) : 0;
         if(!flipper_format_write_uint32(ff, "AutoSave", &auto_save_temp, 1)) {
             FURI_LOG_E(TAG, "Failed to write auto-save");
             break;
@@ -128,9 +142,14 @@ void protopirate_settings_save(ProtoPirateSettings* settings) {
             break;
         }
         
-        FURI_LOG_I(TAG, "Settings saved: freq=%lu, preset=%u, auto_save=%d, hopping=%d",
+        if(!flipper_format_write_uint32(ff, "GlitchFilter", &settings->glitch_filter_us, 1)) {
+            FURI_LOG_E(TAG, "Failed to write glitch filter");
+            break;
+        }
+        
+        FURI_LOG_I(TAG, "Settings saved: freq=%lu, preset=%u, auto_save=%d, hopping=%d, glitch=%lu",
             settings->frequency, settings->preset_index, 
-            settings->auto_save, settings->hopping_enabled);
+            settings->auto_save, settings->hopping_enabled, settings->glitch_filter_us);
             
     } while(false);
     
@@ -11,7 +11,9 @@ typedef struct {
     uint32_t frequency;
     uint8_t preset_index;
     bool auto_save;
+    bool auto_save_log; // auto-save to a session log instead of .sub files
     bool hopping_enabled;
+    uint32_t glitch_filter_us; // 0 for off, see protopirate_decoder_set_set_glitch_filter
 } ProtoPirateSettings;
 
 void protopirate_settings_load(ProtoPirateSettings* settings);
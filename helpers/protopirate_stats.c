@@ -0,0 +1,95 @@
+// helpers/protopirate_stats.c
+#include "protopirate_stats.h"
+#include "protopirate_trace.h"
+
+#ifdef PROTOPIRATE_HOST
+#include <time.h>
+
+uint32_t protopirate_stats_host_ticks(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+}
+#endif
+
+// Written from the worker thread only, the UI just reads
+ProtoPirateStatsEntry protopirate_stats[ProtoPirateTraceProtocolCount];
+bool protopirate_stats_enabled;
+
+void protopirate_stats_set_enabled(bool enabled) {
+    protopirate_stats_enabled = enabled;
+}
+
+void protopirate_stats_clear(void) {
+    memset(protopirate_stats, 0, sizeof(protopirate_stats));
+}
+
+void protopirate_stats_count(uint8_t protocol, uint8_t event) {
+    if(!protopirate_stats_enabled || protocol >= ProtoPirateTraceProtocolCount) return;
+    ProtoPirateStatsEntry* entry = &protopirate_stats[protocol];
+
+    switch(event) {
+    case ProtoPirateTraceEventSync:
+        entry->preambles++;
+        break;
+    case ProtoPirateTraceEventMismatch:
+        entry->resets[ProtoPirateStatsResetTiming]++;
+        break;
+    case ProtoPirateTraceEventEarlyEnd:
+        entry->resets[ProtoPirateStatsResetEarlyEnd]++;
+        break;
+    case ProtoPirateTraceEventBitCount:
+        entry->resets[ProtoPirateStatsResetBitCount]++;
+        break;
+    case ProtoPirateTraceEventDecoded:
+        entry->frames++;
+        break;
+    default:
+        break;
+    }
+}
+
+void protopirate_stats_get(uint8_t protocol, ProtoPirateStatsEntry* entry) {
+    furi_check(protocol < ProtoPirateTraceProtocolCount);
+    *entry = protopirate_stats[protocol];
+}
+
+const char* protopirate_stats_reset_name(uint8_t reason) {
+    switch(reason) {
+    case ProtoPirateStatsResetTiming:
+        return "timing";
+    case ProtoPirateStatsResetEarlyEnd:
+        return "early-end";
+    case ProtoPirateStatsResetBitCount:
+        return "bit-count";
+    default:
+        return "?";
+    }
+}
+
+void protopirate_stats_format_csv(FuriString* output) {
+    furi_string_printf(
+        output,
+        "protocol,pulses,preambles,reset_timing,reset_early_end,reset_bit_count,frames,"
+        "%s,%s_per_pulse\n",
+        PROTOPIRATE_STATS_TICK_UNIT,
+        PROTOPIRATE_STATS_TICK_UNIT);
+
+    for(uint8_t i = 0; i < ProtoPirateTraceProtocolCount; i++) {
+        ProtoPirateStatsEntry entry;
+        protopirate_stats_get(i, &entry);
+        uint32_t per_pulse = entry.pulses ? (uint32_t)(entry.ticks / entry.pulses) : 0;
+        furi_string_cat_printf(
+            output,
+            "%s,%lu,%lu,%lu,%lu,%lu,%lu,%llu,%lu\n",
+            protopirate_trace_protocol_name(i),
+            entry.pulses,
+            entry.preambles,
+            entry.resets[ProtoPirateStatsResetTiming],
+            entry.resets[ProtoPirateStatsResetEarlyEnd],
+            entry.resets[ProtoPirateStatsResetBitCount],
+            entry.frames,
+            (unsigned long long)entry.ticks,
+            per_pulse);
+    }
+}
@@ -0,0 +1,60 @@
+// helpers/protopirate_stats.h
+#pragma once
+
+#include <furi.h>
+
+// Per-protocol decoder counters for the live receiver. Pulses and feed() time
+// are counted by the decoder set, for the pulses it actually hands to that
+// decoder (idle ones skip most of them), preambles / resets / frames come from the
+// PROTOPIRATE_TRACE_EVENT points inside the decoders. Nothing is counted
+// until protopirate_stats_set_enabled(true).
+//
+// Time is DWT CYCCNT cycles on the device and nanoseconds on the host build.
+
+#ifdef PROTOPIRATE_HOST
+uint32_t protopirate_stats_host_ticks(void);
+#define PROTOPIRATE_STATS_TICKS() protopirate_stats_host_ticks()
+#define PROTOPIRATE_STATS_TICK_UNIT "ns"
+#else
+#include <furi_hal.h>
+#define PROTOPIRATE_STATS_TICKS()   (DWT->CYCCNT)
+#define PROTOPIRATE_STATS_TICK_UNIT "cyc"
+#endif
+
+typedef enum {
+    ProtoPirateStatsResetTiming, // pulse outside every timing window after sync
+    ProtoPirateStatsResetEarlyEnd, // end gap before the frame was complete
+    ProtoPirateStatsResetBitCount, // frame ended with a bit count the protocol rejects
+    ProtoPirateStatsResetCount,
+} ProtoPirateStatsReset;
+
+typedef struct {
+    uint32_t pulses;
+    uint32_t preambles;
+    uint32_t resets[ProtoPirateStatsResetCount];
+    uint32_t frames;
+    uint64_t ticks;
+} ProtoPirateStatsEntry;
+
+// Indexed by ProtoPirateTraceProtocol, which follows the registry order
+extern ProtoPirateStatsEntry protopirate_stats[];
+extern bool protopirate_stats_enabled;
+
+void protopirate_stats_set_enabled(bool enabled);
+void protopirate_stats_clear(void);
+
+void protopirate_stats_count(uint8_t protocol, uint8_t event);
+
+// What PROTOPIRATE_TRACE_EVENT calls from the decoders, only a flag test
+// while the receiver isn't counting
+static inline void protopirate_stats_event(uint8_t protocol, uint8_t event) {
+    if(protopirate_stats_enabled) protopirate_stats_count(protocol, event);
+}
+
+// Copy of one entry, fields may be a pulse apart while the worker is feeding
+void protopirate_stats_get(uint8_t protocol, ProtoPirateStatsEntry* entry);
+
+const char* protopirate_stats_reset_name(uint8_t reason);
+
+// One CSV line per protocol with a header, what gets dumped to SD
+void protopirate_stats_format_csv(FuriString* output);
@@ -1,16 +1,17 @@
 // helpers/protopirate_storage.c
 #include "protopirate_storage.h"
+#include "protopirate_trace.h"
+#include "protopirate_stats.h"
+#include "protopirate_key_file.h"
+#include <toolbox/stream/stream.h>
 #include <toolbox/stream/file_stream.h>
 #include <toolbox/dir_walk.h>
+#include <furi_hal_rtc.h>
 
 #define TAG "ProtoPirateStorage"
-#define MAX_FILES_TO_DISPLAY 50
 
-// Structure to hold file info for sorting
-typedef struct {
-    char name[64];
-    uint32_t timestamp;
-} FileEntry;
+#define INDEX_MAGIC   0x58495050 // "PPIX"
+#define INDEX_VERSION 3
 
 bool protopirate_storage_init()
 {
@@ -20,272 +21,754 @@ bool protopirate_storage_init()
     return result;
 }
 
+// Per-protocol capture counters, loaded once from PROTOPIRATE_SEQUENCE_FILE
+typedef struct
+{
+    char *protocol; // any length, it can come from a file the user picked
+    uint32_t next;
+} SequenceEntry;
+
+static SequenceEntry *g_sequences = NULL;
+static size_t g_sequence_count = 0;
+static bool g_sequences_loaded = false;
+
+static SequenceEntry *protopirate_storage_sequence_get(const char *protocol_name, bool create)
+{
+    for (size_t i = 0; i < g_sequence_count; i++)
+    {
+        if (strcmp(g_sequences[i].protocol, protocol_name) == 0)
+            return &g_sequences[i];
+    }
+    if (!create)
+        return NULL;
+
+    g_sequences = realloc(g_sequences, sizeof(SequenceEntry) * (g_sequence_count + 1));
+    SequenceEntry *entry = &g_sequences[g_sequence_count++];
+    entry->protocol = strdup(protocol_name);
+    entry->next = 0;
+    return entry;
+}
+
+// Seeds the counters from the names already on the card, <protocol>_<n>.sub
+static void protopirate_storage_sequence_scan(Storage *storage)
+{
+    File *dir = storage_file_alloc(storage);
+    FileInfo file_info;
+    char name[256];
+
+    if (storage_dir_open(dir, PROTOPIRATE_APP_FOLDER))
+    {
+        while (storage_dir_read(dir, &file_info, name, sizeof(name)))
+        {
+            if (file_info_is_dir(&file_info))
+                continue;
+
+            char *extension = strstr(name, PROTOPIRATE_APP_EXTENSION);
+            if (!extension)
+                continue;
+            *extension = '\0';
+
+            char *separator = strrchr(name, '_');
+            if (!separator || separator[1] == '\0')
+                continue;
+
+            char *end = NULL;
+            uint32_t index = strtoul(separator + 1, &end, 10);
+            if (*end != '\0')
+                continue;
+
+            *separator = '\0';
+            SequenceEntry *entry = protopirate_storage_sequence_get(name, true);
+            if (index + 1 > entry->next)
+            {
+                entry->next = index + 1;
+            }
+        }
+        storage_dir_close(dir);
+    }
+
+    storage_file_free(dir);
+    FURI_LOG_I(TAG, "Sequence rebuilt for %zu protocols", g_sequence_count);
+}
+
+static void protopirate_storage_sequence_load(Storage *storage)
+{
+    if (g_sequences_loaded)
+        return;
+    g_sequences_loaded = true;
+
+    File *file = storage_file_alloc(storage);
+    bool loaded = false;
+
+    if (storage_file_open(file, PROTOPIRATE_SEQUENCE_FILE, FSAM_READ, FSOM_OPEN_EXISTING))
+    {
+        size_t size = storage_file_size(file);
+        char *text = malloc(size + 1);
+        text[storage_file_read(file, text, size)] = '\0';
+
+        // The number is behind the last space, so a name may have spaces too
+        for (char *line = text; *line;)
+        {
+            char *end = strchr(line, '\n');
+            if (end)
+                *end = '\0';
+
+            char *separator = strrchr(line, ' ');
+            if (separator && separator != line)
+            {
+                *separator = '\0';
+                protopirate_storage_sequence_get(line, true)->next = strtoul(separator + 1, NULL, 10);
+            }
+
+            if (!end)
+                break;
+            line = end + 1;
+        }
+        free(text);
+        loaded = true;
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+
+    if (!loaded)
+    {
+        protopirate_storage_sequence_scan(storage);
+    }
+}
+
+static bool protopirate_storage_sequence_save(Storage *storage)
+{
+    FuriString *text = furi_string_alloc();
+    for (size_t i = 0; i < g_sequence_count; i++)
+    {
+        furi_string_cat_printf(text, "%s %lu\n", g_sequences[i].protocol, g_sequences[i].next);
+    }
+
+    File *file = storage_file_alloc(storage);
+    size_t size = furi_string_size(text);
+    bool result = false;
+    if (storage_file_open(file, PROTOPIRATE_SEQUENCE_FILE, FSAM_WRITE, FSOM_CREATE_ALWAYS))
+    {
+        result = storage_file_write(file, furi_string_get_cstr(text), size) == size;
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_string_free(text);
+    return result;
+}
+
 bool protopirate_storage_get_next_filename(
     const char *protocol_name,
     FuriString *out_filename)
 {
     Storage *storage = furi_record_open(RECORD_STORAGE);
-    FuriString *temp_path = furi_string_alloc();
-    uint32_t index = 0;
-    bool found = false;
+    protopirate_storage_sequence_load(storage);
+
+    SequenceEntry *entry = protopirate_storage_sequence_get(protocol_name, true);
 
-    // Find next available index
-    while (!found && index < 999)
+    // The counter only ever grows, this loop runs once unless someone copied
+    // files in behind our back
+    do
     {
         furi_string_printf(
-            temp_path,
+            out_filename,
             "%s/%s_%03lu%s",
             PROTOPIRATE_APP_FOLDER,
             protocol_name,
-            index,
+            entry->next,
             PROTOPIRATE_APP_EXTENSION);
+        entry->next++;
+    } while (storage_file_exists(storage, furi_string_get_cstr(out_filename)));
 
-        if (!storage_file_exists(storage, furi_string_get_cstr(temp_path)))
-        {
-            furi_string_set(out_filename, temp_path);
-            found = true;
-        }
-        else
+    if (!protopirate_storage_sequence_save(storage))
+    {
+        FURI_LOG_W(TAG, "Failed to write %s", PROTOPIRATE_SEQUENCE_FILE);
+    }
+
+    furi_record_close(RECORD_STORAGE);
+    return true;
+}
+
+// Index of saved captures, oldest first. Only the record count is kept in RAM,
+// records are read from PROTOPIRATE_INDEX_FILE when asked for, a save appends
+// one and a delete moves the ones behind it down.
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t entry_size;
+} __attribute__((packed)) IndexHeader;
+
+#define INDEX_TEMP_FILE PROTOPIRATE_APP_FOLDER "/.index.tmp"
+#define INDEX_CHUNK     16 // records per read
+
+static uint32_t g_index_count = 0;
+static bool g_index_loaded = false;
+
+// FNV-1a, 64 bits so a few thousand names never collide in practice
+static uint64_t protopirate_storage_name_hash(const char *name, size_t length)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (uint8_t)name[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+// File name without folder and extension, false if it isn't a .sub. A name
+// too long for the entry is cut and flagged, name_hash of the full one tells
+// it apart from other names starting the same.
+static bool protopirate_storage_entry_set_name(ProtoPirateStorageEntry *entry, const char *path)
+{
+    const char *name = strrchr(path, '/');
+    name = name ? name + 1 : path;
+
+    const char *extension = strstr(name, PROTOPIRATE_APP_EXTENSION);
+    if (!extension)
+        return false;
+
+    size_t length = extension - name;
+    entry->name_hash = protopirate_storage_name_hash(name, length);
+    entry->flags &= ~ProtoPirateStorageEntryTruncated;
+    if (length >= sizeof(entry->name))
+    {
+        length = sizeof(entry->name) - 1;
+        entry->flags |= ProtoPirateStorageEntryTruncated;
+    }
+
+    memcpy(entry->name, name, length);
+    entry->name[length] = '\0';
+    return true;
+}
+
+// Full path of a truncated entry, the .sub in the folder with its name at the
+// start and its name_hash
+static bool protopirate_storage_entry_find_path(const ProtoPirateStorageEntry *entry, FuriString *out_path)
+{
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    File *dir = storage_file_alloc(storage);
+    FileInfo file_info;
+    char name[256];
+    size_t length = strlen(entry->name);
+    bool found = false;
+
+    if (storage_dir_open(dir, PROTOPIRATE_APP_FOLDER))
+    {
+        while (!found && storage_dir_read(dir, &file_info, name, sizeof(name)))
         {
-            index++;
+            const char *extension = strstr(name, PROTOPIRATE_APP_EXTENSION);
+            found = !file_info_is_dir(&file_info) && extension && strncmp(name, entry->name, length) == 0 &&
+                    protopirate_storage_name_hash(name, extension - name) == entry->name_hash;
         }
     }
+    if (found)
+    {
+        furi_string_printf(out_path, "%s/%s", PROTOPIRATE_APP_FOLDER, name);
+    }
 
-    furi_string_free(temp_path);
+    storage_dir_close(dir);
+    storage_file_free(dir);
     furi_record_close(RECORD_STORAGE);
+    return true;
+}
 
-    return found;
+// Everything but the name
+static void protopirate_storage_entry_clear(ProtoPirateStorageEntry *entry)
+{
+    entry->protocol[0] = '\0';
+    entry->frequency = 0;
+    entry->serial = 0;
+    entry->button = 0;
+    entry->flags &= ProtoPirateStorageEntryTruncated;
+    entry->reserved = 0;
 }
 
-bool protopirate_storage_save_capture(
-    FlipperFormat *flipper_format,
-    const char *protocol_name,
-    FuriString *out_path)
+// The index fields out of a parsed key file
+static void protopirate_storage_entry_set_fields(ProtoPirateStorageEntry *entry, const ProtoPirateKeyFile *key_file)
 {
-    if (!protopirate_storage_init())
+    protopirate_storage_entry_clear(entry);
+    strlcpy(entry->protocol, furi_string_get_cstr(key_file->protocol), sizeof(entry->protocol));
+    entry->frequency = key_file->frequency;
+    if (key_file->fields & ProtoPirateKeyFileFieldSerial)
     {
-        FURI_LOG_E(TAG, "Failed to create app folder");
-        return false;
+        entry->serial = key_file->serial;
+        entry->flags |= ProtoPirateStorageEntrySerial;
     }
+    if (key_file->fields & ProtoPirateKeyFileFieldButton)
+    {
+        entry->button = key_file->button;
+        entry->flags |= ProtoPirateStorageEntryButton;
+    }
+}
 
-    FuriString *file_path = furi_string_alloc();
+// Only for files the index doesn't know yet, everything else comes from the index
+static void protopirate_storage_entry_scan(
+    Storage *storage,
+    ProtoPirateStorageEntry *entry,
+    ProtoPirateKeyFile *key_file,
+    FuriString *path)
+{
+    // A file that can't be read is still listed, the key file comes back empty
+    protopirate_key_file_load(key_file, storage, furi_string_get_cstr(path));
+    protopirate_storage_entry_set_fields(entry, key_file);
 
-    if (!protopirate_storage_get_next_filename(protocol_name, file_path))
+    if (storage_common_timestamp(storage, furi_string_get_cstr(path), &entry->timestamp) != FSE_OK)
     {
-        FURI_LOG_E(TAG, "Failed to get next filename");
-        furi_string_free(file_path);
-        return false;
+        entry->timestamp = 0;
     }
+}
 
-    Storage *storage = furi_record_open(RECORD_STORAGE);
+// Opens PROTOPIRATE_INDEX_FILE and checks its header, count is the number of
+// records behind it. Close the file either way.
+static bool protopirate_storage_index_open(File *file, FS_AccessMode access, uint32_t *count)
+{
+    IndexHeader header;
+    if (!storage_file_open(file, PROTOPIRATE_INDEX_FILE, access, FSOM_OPEN_EXISTING))
+        return false;
+    if (storage_file_read(file, &header, sizeof(header)) != sizeof(header) ||
+        header.magic != INDEX_MAGIC || header.version != INDEX_VERSION ||
+        header.entry_size != sizeof(ProtoPirateStorageEntry))
+        return false;
 
-    // Create a new flipper format file for saving
-    FlipperFormat *save_file = flipper_format_file_alloc(storage);
-    bool result = false;
+    *count = (storage_file_size(file) - sizeof(header)) / sizeof(ProtoPirateStorageEntry);
+    return true;
+}
 
-    do
+// An empty index at path, left open for the records
+static bool protopirate_storage_index_create(File *file, const char *path)
+{
+    IndexHeader header = {
+        .magic = INDEX_MAGIC,
+        .version = INDEX_VERSION,
+        .entry_size = sizeof(ProtoPirateStorageEntry),
+    };
+    return storage_file_open(file, path, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS) &&
+           storage_file_write(file, &header, sizeof(header)) == sizeof(header);
+}
+
+static bool protopirate_storage_index_seek(File *file, uint32_t record)
+{
+    return storage_file_seek(file, sizeof(IndexHeader) + sizeof(ProtoPirateStorageEntry) * record, true);
+}
+
+static bool protopirate_storage_index_read(File *file, uint32_t record, ProtoPirateStorageEntry *entries, uint32_t count)
+{
+    size_t size = sizeof(ProtoPirateStorageEntry) * count;
+    return protopirate_storage_index_seek(file, record) && storage_file_read(file, entries, size) == size;
+}
+
+static int protopirate_storage_index_compare_hash(const void *a, const void *b)
+{
+    uint64_t hash_a = *(const uint64_t *)a;
+    uint64_t hash_b = *(const uint64_t *)b;
+    return hash_a < hash_b ? -1 : hash_a > hash_b;
+}
+
+// Where a record goes when the index is rewritten
+typedef struct
+{
+    uint32_t timestamp;
+    uint32_t record;
+} IndexOrder;
+
+static int protopirate_storage_index_compare_order(const void *a, const void *b)
+{
+    const IndexOrder *order_a = a;
+    const IndexOrder *order_b = b;
+    if (order_a->timestamp != order_b->timestamp)
+        return order_a->timestamp < order_b->timestamp ? -1 : 1;
+    return order_a->record < order_b->record ? -1 : order_a->record > order_b->record;
+}
+
+// Flips the mark of one copy of hash in the sorted hashes from !mark to mark,
+// false if there is none left to flip
+static bool protopirate_storage_index_mark(const uint64_t *hashes, uint8_t *marks, uint32_t count, uint64_t hash, bool mark)
+{
+    uint32_t low = 0;
+    uint32_t high = count;
+    while (low < high)
     {
-        if (!flipper_format_file_open_new(save_file, furi_string_get_cstr(file_path)))
-        {
-            FURI_LOG_E(TAG, "Failed to create file");
-            break;
-        }
+        uint32_t middle = (low + high) / 2;
+        if (hashes[middle] < hash)
+            low = middle + 1;
+        else
+            high = middle;
+    }
 
-        // Write standard SubGhz file header
-        if (!flipper_format_write_header_cstr(save_file, "Flipper SubGhz Key File", 1))
+    for (; low < count && hashes[low] == hash; low++)
+    {
+        bool marked = marks[low / 8] & (1 << (low % 8));
+        if (marked != mark)
         {
-            FURI_LOG_E(TAG, "Failed to write header");
-            break;
+            marks[low / 8] ^= 1 << (low % 8);
+            return true;
         }
+    }
+    return false;
+}
+
+// Writes the records of file in order to INDEX_TEMP_FILE and puts that in
+// place of PROTOPIRATE_INDEX_FILE, file is closed for that
+static bool protopirate_storage_index_rewrite(Storage *storage, File *file, const IndexOrder *order, uint32_t count)
+{
+    File *temp = storage_file_alloc(storage);
+    ProtoPirateStorageEntry entry;
+    bool result = protopirate_storage_index_create(temp, INDEX_TEMP_FILE);
+
+    for (uint32_t i = 0; result && i < count; i++)
+    {
+        result = protopirate_storage_index_read(file, order[i].record, &entry, 1) &&
+                 storage_file_write(temp, &entry, sizeof(entry)) == sizeof(entry);
+    }
 
-        // Rewind source format to beginning
-        flipper_format_rewind(flipper_format);
+    storage_file_close(temp);
+    storage_file_free(temp);
+    storage_file_close(file);
 
-        // Copy ALL data from the source flipper format
-        FuriString *string_value = furi_string_alloc();
-        uint32_t uint32_value;
-        uint32_t *uint32_array = NULL;
-        uint32_t uint32_array_size = 0;
+    if (result)
+    {
+        storage_common_remove(storage, PROTOPIRATE_INDEX_FILE);
+        result = storage_common_rename(storage, INDEX_TEMP_FILE, PROTOPIRATE_INDEX_FILE) == FSE_OK;
+    }
+    if (!result)
+    {
+        FURI_LOG_W(TAG, "Failed to write %s", PROTOPIRATE_INDEX_FILE);
+        storage_common_remove(storage, INDEX_TEMP_FILE);
+    }
+    return result;
+}
 
-        // Protocol name
-        if (flipper_format_read_string(flipper_format, "Protocol", string_value))
+// Checks the index against one pass over the folder. Only name hashes are
+// kept in RAM for that, 8 bytes a capture, and files are opened just for
+// captures the index doesn't have (copied in from a PC or saved by an older
+// build). Those are appended, the file is only rewritten when a capture is
+// gone or the order is off.
+static void protopirate_storage_index_load(Storage *storage)
+{
+    if (g_index_loaded)
+        return;
+    g_index_loaded = true;
+
+    File *file = storage_file_alloc(storage);
+    ProtoPirateStorageEntry *chunk = malloc(sizeof(ProtoPirateStorageEntry) * INDEX_CHUNK);
+    uint32_t known = 0;
+    uint32_t last_timestamp = 0;
+    bool sorted = true;
+    bool valid = protopirate_storage_index_open(file, FSAM_READ_WRITE, &known);
+    if (!valid)
+        known = 0;
+
+    uint64_t *hashes = malloc(sizeof(uint64_t) * (known + 1));
+    uint8_t *seen = malloc(known / 8 + 1);
+    memset(seen, 0, known / 8 + 1);
+    for (uint32_t record = 0; record < known;)
+    {
+        uint32_t count = MIN((uint32_t)INDEX_CHUNK, known - record);
+        if (!protopirate_storage_index_read(file, record, chunk, count))
         {
-            flipper_format_write_string(save_file, "Protocol", string_value);
+            // Whatever is behind a bad read gets scanned again
+            known = record;
+            break;
         }
-
-        // Bit count
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Bit", &uint32_value, 1))
+        for (uint32_t i = 0; i < count; i++, record++)
         {
-            flipper_format_write_uint32(save_file, "Bit", &uint32_value, 1);
+            hashes[record] = chunk[i].name_hash;
+            sorted = sorted && chunk[i].timestamp >= last_timestamp;
+            last_timestamp = chunk[i].timestamp;
         }
+    }
+    qsort(hashes, known, sizeof(uint64_t), protopirate_storage_index_compare_hash);
 
-        // Key data
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_string(flipper_format, "Key", string_value))
+    // New captures go behind the known ones, right away
+    valid = valid && protopirate_storage_index_seek(file, known) && storage_file_truncate(file);
+    if (!valid)
+    {
+        storage_file_close(file);
+        known = 0;
+        valid = protopirate_storage_index_create(file, PROTOPIRATE_INDEX_FILE);
+    }
+
+    File *dir = storage_file_alloc(storage);
+    FileInfo file_info;
+    FuriString *path = furi_string_alloc();
+    ProtoPirateStorageEntry entry;
+    ProtoPirateKeyFile *key_file = protopirate_key_file_alloc();
+    char name[256];
+    uint32_t added = 0;
+
+    if (valid && storage_dir_open(dir, PROTOPIRATE_APP_FOLDER))
+    {
+        while (storage_dir_read(dir, &file_info, name, sizeof(name)))
         {
-            flipper_format_write_string(save_file, "Key", string_value);
+            if (file_info_is_dir(&file_info) || !protopirate_storage_entry_set_name(&entry, name))
+                continue;
+            if (protopirate_storage_index_mark(hashes, seen, known, entry.name_hash, true))
+                continue;
+
+            furi_string_printf(path, "%s/%s", PROTOPIRATE_APP_FOLDER, name);
+            protopirate_storage_entry_scan(storage, &entry, key_file, path);
+            if (storage_file_write(file, &entry, sizeof(entry)) != sizeof(entry))
+            {
+                FURI_LOG_W(TAG, "Failed to write %s", PROTOPIRATE_INDEX_FILE);
+                break;
+            }
+            sorted = sorted && entry.timestamp >= last_timestamp;
+            last_timestamp = entry.timestamp;
+            added++;
         }
-        else
+        storage_dir_close(dir);
+    }
+
+    storage_file_free(dir);
+    furi_string_free(path);
+    protopirate_key_file_free(key_file);
+
+    uint32_t total = known + added;
+    uint32_t removed = 0;
+    for (uint32_t i = 0; i < known; i++)
+    {
+        if (!(seen[i / 8] & (1 << (i % 8))))
+            removed++;
+    }
+    g_index_count = total;
+
+    // Drop what was deleted behind our back and put the rest in time order
+    if (valid && (removed || !sorted))
+    {
+        IndexOrder *order = malloc(sizeof(IndexOrder) * (total + 1));
+        uint32_t count = 0;
+        bool read = true;
+        for (uint32_t record = 0; read && record < total;)
         {
-            flipper_format_rewind(flipper_format);
-            if (flipper_format_get_value_count(flipper_format, "Key", &uint32_array_size) && uint32_array_size > 0)
+            uint32_t length = MIN((uint32_t)INDEX_CHUNK, total - record);
+            read = protopirate_storage_index_read(file, record, chunk, length);
+            for (uint32_t i = 0; read && i < length; i++, record++)
             {
-                uint32_array = malloc(sizeof(uint32_t) * uint32_array_size);
-                if (flipper_format_read_uint32(flipper_format, "Key", uint32_array, uint32_array_size))
+                if (record >= known ||
+                    protopirate_storage_index_mark(hashes, seen, known, chunk[i].name_hash, false))
                 {
-                    flipper_format_write_uint32(save_file, "Key", uint32_array, uint32_array_size);
+                    order[count].timestamp = chunk[i].timestamp;
+                    order[count].record = record;
+                    count++;
                 }
-                free(uint32_array);
-                uint32_array = NULL;
             }
         }
+        free(hashes);
+        hashes = NULL;
 
-        // Frequency
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Frequency", &uint32_value, 1))
+        qsort(order, count, sizeof(IndexOrder), protopirate_storage_index_compare_order);
+        if (read && protopirate_storage_index_rewrite(storage, file, order, count))
         {
-            flipper_format_write_uint32(save_file, "Frequency", &uint32_value, 1);
+            g_index_count = count;
         }
+        free(order);
+    }
 
-        // Preset
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_string(flipper_format, "Preset", string_value))
-        {
-            flipper_format_write_string(save_file, "Preset", string_value);
-        }
+    storage_file_close(file);
+    storage_file_free(file);
+    free(hashes);
+    free(seen);
+    free(chunk);
 
-        // Custom preset data if exists
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_get_value_count(flipper_format, "Custom_preset_module", &uint32_array_size) && uint32_array_size > 0)
-        {
-            if (flipper_format_read_string(flipper_format, "Custom_preset_module", string_value))
-            {
-                flipper_format_write_string(save_file, "Custom_preset_module", string_value);
-            }
-        }
+    FURI_LOG_I(TAG, "Index: %lu captures, %lu added, %lu removed", g_index_count, added, removed);
+}
 
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_get_value_count(flipper_format, "Custom_preset_data", &uint32_array_size) && uint32_array_size > 0)
+static void protopirate_storage_index_add(Storage *storage, const ProtoPirateStorageEntry *entry)
+{
+    // Before the first load the folder scan picks the capture up anyway
+    bool exists = storage_file_exists(storage, PROTOPIRATE_INDEX_FILE);
+    if (!exists && !g_index_loaded)
+        return;
+
+    // Appended as is, a capture older than the last one (clock set back) is
+    // sorted in by the next load
+    File *file = storage_file_alloc(storage);
+    bool result = exists ? storage_file_open(file, PROTOPIRATE_INDEX_FILE, FSAM_WRITE, FSOM_OPEN_APPEND)
+                         : protopirate_storage_index_create(file, PROTOPIRATE_INDEX_FILE);
+    result = result && storage_file_write(file, entry, sizeof(ProtoPirateStorageEntry)) ==
+                           sizeof(ProtoPirateStorageEntry);
+    storage_file_close(file);
+    storage_file_free(file);
+
+    if (!result)
+    {
+        FURI_LOG_W(TAG, "Failed to write %s", PROTOPIRATE_INDEX_FILE);
+    }
+    else if (g_index_loaded)
+    {
+        g_index_count = exists ? g_index_count + 1 : 1;
+    }
+}
+
+static void protopirate_storage_index_remove(Storage *storage, const char *file_path)
+{
+    ProtoPirateStorageEntry entry;
+    if (!g_index_loaded || !protopirate_storage_entry_set_name(&entry, file_path))
+        return;
+
+    File *file = storage_file_alloc(storage);
+    ProtoPirateStorageEntry *chunk = malloc(sizeof(ProtoPirateStorageEntry) * INDEX_CHUNK);
+    uint32_t count = 0;
+    uint32_t found = UINT32_MAX;
+
+    if (protopirate_storage_index_open(file, FSAM_READ_WRITE, &count))
+    {
+        for (uint32_t record = 0; found == UINT32_MAX && record < count;)
         {
-            uint8_t *custom_data = malloc(uint32_array_size);
-            if (flipper_format_read_hex(flipper_format, "Custom_preset_data", custom_data, uint32_array_size))
+            uint32_t length = MIN((uint32_t)INDEX_CHUNK, count - record);
+            if (!protopirate_storage_index_read(file, record, chunk, length))
+                break;
+            for (uint32_t i = 0; i < length && found == UINT32_MAX; i++, record++)
             {
-                flipper_format_write_hex(save_file, "Custom_preset_data", custom_data, uint32_array_size);
+                if (chunk[i].name_hash == entry.name_hash && strcmp(chunk[i].name, entry.name) == 0)
+                    found = record;
             }
-            free(custom_data);
         }
+    }
 
-        // Protocol-specific fields - TE
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "TE", &uint32_value, 1))
+    if (found != UINT32_MAX)
+    {
+        // Everything behind it one record down, then cut the last one
+        bool result = true;
+        for (uint32_t record = found + 1; result && record < count;)
         {
-            flipper_format_write_uint32(save_file, "TE", &uint32_value, 1);
+            uint32_t length = MIN((uint32_t)INDEX_CHUNK, count - record);
+            size_t size = sizeof(ProtoPirateStorageEntry) * length;
+            result = protopirate_storage_index_read(file, record, chunk, length) &&
+                     protopirate_storage_index_seek(file, record - 1) &&
+                     storage_file_write(file, chunk, size) == size;
+            record += length;
         }
+        result = result && protopirate_storage_index_seek(file, count - 1) && storage_file_truncate(file);
 
-        // Serial number
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Serial", &uint32_value, 1))
+        if (result)
         {
-            flipper_format_write_uint32(save_file, "Serial", &uint32_value, 1);
+            g_index_count = count - 1;
         }
-
-        // Button
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Btn", &uint32_value, 1))
+        else
         {
-            flipper_format_write_uint32(save_file, "Btn", &uint32_value, 1);
+            FURI_LOG_W(TAG, "Failed to write %s", PROTOPIRATE_INDEX_FILE);
         }
+    }
 
-        // Counter
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Cnt", &uint32_value, 1))
-        {
-            flipper_format_write_uint32(save_file, "Cnt", &uint32_value, 1);
-        }
+    storage_file_close(file);
+    storage_file_free(file);
+    free(chunk);
+}
 
-        // CRC
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "CRC", &uint32_value, 1))
-        {
-            flipper_format_write_uint32(save_file, "CRC", &uint32_value, 1);
-        }
+// Copies every "Key: value" line of source, in order, behind the header that's
+// already in destination. One pass over the source and a single write, the
+// index fields are picked up on the way by the key file line parser.
+static bool protopirate_storage_copy_fields(
+    FlipperFormat *source,
+    FlipperFormat *destination,
+    ProtoPirateStorageEntry *entry)
+{
+    Stream *stream = flipper_format_get_raw_stream(source);
+    FuriString *line = furi_string_alloc();
+    FuriString *fields = furi_string_alloc();
+    ProtoPirateKeyFile *key_file = protopirate_key_file_alloc();
+    bool header = false;
 
-        // Type (for VW)
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Type", &uint32_value, 1))
-        {
-            flipper_format_write_uint32(save_file, "Type", &uint32_value, 1);
-        }
+    stream_rewind(stream);
 
-        // Check (for VW)
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Check", &uint32_value, 1))
+    while (stream_read_line(stream, line))
+    {
+        furi_string_trim(line);
+        if (furi_string_empty(line) || furi_string_get_char(line, 0) == '#')
+            continue;
+
+        // A source loaded from a file brings its own header. Kia V3/V4 have a
+        // Version field as well, only the one right behind Filetype is skipped.
+        const char *text = furi_string_get_cstr(line);
+        size_t length;
+        const char *value = protopirate_key_file_split(text, &length);
+        if (protopirate_key_file_key_is(text, length, "Filetype"))
         {
-            flipper_format_write_uint32(save_file, "Check", &uint32_value, 1);
+            header = true;
+            continue;
         }
-
-        // Raw data arrays
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_get_value_count(flipper_format, "RAW_Data", &uint32_array_size) && uint32_array_size > 0)
+        if (header && protopirate_key_file_key_is(text, length, "Version"))
         {
-            uint32_array = malloc(sizeof(uint32_t) * uint32_array_size);
-            if (flipper_format_read_uint32(flipper_format, "RAW_Data", uint32_array, uint32_array_size))
-            {
-                flipper_format_write_uint32(save_file, "RAW_Data", uint32_array, uint32_array_size);
-            }
-            free(uint32_array);
+            header = false;
+            continue;
         }
+        header = false;
 
-        // DataHi/DataLo
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "DataHi", &uint32_value, 1))
-        {
-            flipper_format_write_uint32(save_file, "DataHi", &uint32_value, 1);
-        }
+        protopirate_key_file_parse_field(key_file, text, length, value);
+        furi_string_cat(fields, line);
+        furi_string_push_back(fields, '\n');
+    }
 
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "DataLo", &uint32_value, 1))
-        {
-            flipper_format_write_uint32(save_file, "DataLo", &uint32_value, 1);
-        }
+    size_t size = furi_string_size(fields);
+    bool result = stream_write(
+                      flipper_format_get_raw_stream(destination),
+                      (const uint8_t *)furi_string_get_cstr(fields),
+                      size) == size;
+    protopirate_storage_entry_set_fields(entry, key_file);
 
-        // RawCnt for Kia V2
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "RawCnt", &uint32_value, 1))
-        {
-            flipper_format_write_uint32(save_file, "RawCnt", &uint32_value, 1);
-        }
+    protopirate_key_file_free(key_file);
+    furi_string_free(line);
+    furi_string_free(fields);
+    return result;
+}
+
+bool protopirate_storage_save_capture(
+    FlipperFormat *flipper_format,
+    const char *protocol_name,
+    FuriString *out_path)
+{
+    if (!protopirate_storage_init())
+    {
+        FURI_LOG_E(TAG, "Failed to create app folder");
+        return false;
+    }
+
+    FuriString *file_path = furi_string_alloc();
 
-        // Encrypted/Decrypted for Kia V3/V4
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Encrypted", &uint32_value, 1))
+    if (!protopirate_storage_get_next_filename(protocol_name, file_path))
+    {
+        FURI_LOG_E(TAG, "Failed to get next filename");
+        furi_string_free(file_path);
+        return false;
+    }
+
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+
+    // Create a new flipper format file for saving
+    FlipperFormat *save_file = flipper_format_file_alloc(storage);
+    bool result = false;
+
+    do
+    {
+        if (!flipper_format_file_open_new(save_file, furi_string_get_cstr(file_path)))
         {
-            flipper_format_write_uint32(save_file, "Encrypted", &uint32_value, 1);
+            FURI_LOG_E(TAG, "Failed to create file");
+            break;
         }
 
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Decrypted", &uint32_value, 1))
+        // Write standard SubGhz file header
+        if (!flipper_format_write_header_cstr(save_file, "Flipper SubGhz Key File", 1))
         {
-            flipper_format_write_uint32(save_file, "Decrypted", &uint32_value, 1);
+            FURI_LOG_E(TAG, "Failed to write header");
+            break;
         }
 
-        // Version for Kia V3/V4
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Version", &uint32_value, 1))
+        ProtoPirateStorageEntry entry;
+        if (!protopirate_storage_copy_fields(flipper_format, save_file, &entry))
         {
-            flipper_format_write_uint32(save_file, "Version", &uint32_value, 1);
+            FURI_LOG_E(TAG, "Failed to write fields");
+            break;
         }
 
-        // BS byte for Ford
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "BS", &uint32_value, 1))
+        if (protopirate_storage_entry_set_name(&entry, furi_string_get_cstr(file_path)))
         {
-            flipper_format_write_uint32(save_file, "BS", &uint32_value, 1);
+            entry.timestamp = furi_hal_rtc_get_timestamp();
+            protopirate_storage_index_add(storage, &entry);
         }
 
-        furi_string_free(string_value);
-
         if (out_path)
         {
             furi_string_set(out_path, file_path);
@@ -303,109 +786,43 @@ bool protopirate_storage_save_capture(
     return result;
 }
 
-// Static array to hold sorted file entries
-static FileEntry *g_file_entries = NULL;
-static uint32_t g_file_count = 0;
-
-// Build the sorted file list
-static void protopirate_storage_build_file_list(void)
+uint32_t protopirate_storage_get_file_count()
 {
-    // Free previous list
-    if (g_file_entries)
-    {
-        free(g_file_entries);
-        g_file_entries = NULL;
-    }
-    g_file_count = 0;
-
     Storage *storage = furi_record_open(RECORD_STORAGE);
-    File *dir = storage_file_alloc(storage);
-    FileInfo file_info;
+    protopirate_storage_index_load(storage);
+    furi_record_close(RECORD_STORAGE);
+    return g_index_count;
+}
 
-    // First pass: count files
-    uint32_t total_count = 0;
-    if (storage_dir_open(dir, PROTOPIRATE_APP_FOLDER))
-    {
-        char name[256];
-        while (storage_dir_read(dir, &file_info, name, sizeof(name)))
-        {
-            if (!file_info_is_dir(&file_info) && strstr(name, PROTOPIRATE_APP_EXTENSION))
-            {
-                total_count++;
-            }
-        }
-        storage_dir_close(dir);
-    }
+uint32_t protopirate_storage_get_entries(uint32_t index, ProtoPirateStorageEntry *entries, uint32_t count)
+{
+    if (index >= g_index_count)
+        return 0;
+    count = MIN(count, g_index_count - index);
 
-    if (total_count == 0)
-    {
-        storage_file_free(dir);
-        furi_record_close(RECORD_STORAGE);
-        return;
-    }
+    // Newest first, so these are the records right before the newest index ones
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    File *file = storage_file_alloc(storage);
+    uint32_t records = 0;
+    bool result = protopirate_storage_index_open(file, FSAM_READ, &records) && records == g_index_count &&
+                  protopirate_storage_index_read(file, g_index_count - index - count, entries, count);
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
 
-    // Allocate array
-    g_file_entries = malloc(sizeof(FileEntry) * total_count);
-    if (!g_file_entries)
+    if (!result)
     {
-        storage_file_free(dir);
-        furi_record_close(RECORD_STORAGE);
-        return;
+        FURI_LOG_E(TAG, "Failed to read %s", PROTOPIRATE_INDEX_FILE);
+        return 0;
     }
 
-    // Second pass: collect file info
-    FuriString *full_path = furi_string_alloc();
-    if (storage_dir_open(dir, PROTOPIRATE_APP_FOLDER))
+    for (uint32_t i = 0; i < count / 2; i++)
     {
-        char name[256];
-        while (storage_dir_read(dir, &file_info, name, sizeof(name)) && g_file_count < total_count)
-        {
-            if (!file_info_is_dir(&file_info) && strstr(name, PROTOPIRATE_APP_EXTENSION))
-            {
-                // Copy name (without extension for display)
-                strncpy(g_file_entries[g_file_count].name, name, sizeof(g_file_entries[g_file_count].name) - 1);
-                g_file_entries[g_file_count].name[sizeof(g_file_entries[g_file_count].name) - 1] = '\0';
-
-                // Remove extension
-                char *dot = strrchr(g_file_entries[g_file_count].name, '.');
-                if (dot) *dot = '\0';
-
-                // Get file timestamp
-                furi_string_printf(full_path, "%s/%s", PROTOPIRATE_APP_FOLDER, name);
-
-                // File Count
-                g_file_entries[g_file_count].timestamp = total_count - g_file_count;
-
-                g_file_count++;
-            }
-        }
-        storage_dir_close(dir);
+        ProtoPirateStorageEntry entry = entries[i];
+        entries[i] = entries[count - 1 - i];
+        entries[count - 1 - i] = entry;
     }
-    furi_string_free(full_path);
-
-    // Reverse file count so newest files are first
-    if (g_file_count > 1)
-    {
-        // Reverse the array so newest (last found) is first
-        for (uint32_t i = 0; i < g_file_count / 2; i++)
-        {
-            FileEntry temp = g_file_entries[i];
-            g_file_entries[i] = g_file_entries[g_file_count - 1 - i];
-            g_file_entries[g_file_count - 1 - i] = temp;
-        }
-    }
-
-    storage_file_free(dir);
-    furi_record_close(RECORD_STORAGE);
-
-    FURI_LOG_I(TAG, "Built file list with %lu entries", g_file_count);
-}
-
-uint32_t protopirate_storage_get_file_count()
-{
-    // Rebuild the file list each time we're asked for count
-    protopirate_storage_build_file_list();
-    return g_file_count;
+    return count;
 }
 
 bool protopirate_storage_get_file_by_index(
@@ -413,21 +830,24 @@ bool protopirate_storage_get_file_by_index(
     FuriString *out_path,
     FuriString *out_name)
 {
-    if (!g_file_entries || index >= g_file_count)
+    ProtoPirateStorageEntry entry;
+    if (!protopirate_storage_get_entries(index, &entry, 1))
     {
         return false;
     }
 
-    if (out_path)
+    if (out_path &&
+        (!(entry.flags & ProtoPirateStorageEntryTruncated) ||
+         !protopirate_storage_entry_find_path(&entry, out_path)))
     {
         furi_string_printf(out_path, "%s/%s%s",
             PROTOPIRATE_APP_FOLDER,
-            g_file_entries[index].name,
+            entry.name,
             PROTOPIRATE_APP_EXTENSION);
     }
     if (out_name)
     {
-        furi_string_set_str(out_name, g_file_entries[index].name);
+        furi_string_set_str(out_name, entry.name);
     }
 
     return true;
@@ -438,6 +858,10 @@ bool protopirate_storage_delete_file(const char *file_path)
     Storage *storage = furi_record_open(RECORD_STORAGE);
     bool result = storage_simply_remove(storage, file_path);
     FURI_LOG_I(TAG, "Delete file %s: %s", file_path, result ? "OK" : "FAILED");
+    if (result)
+    {
+        protopirate_storage_index_remove(storage, file_path);
+    }
     furi_record_close(RECORD_STORAGE);
     return result;
 }
@@ -461,10 +885,72 @@ FlipperFormat *protopirate_storage_load_file(const char *file_path)
 // Call this when exiting the app to free memory
 void protopirate_storage_free_file_list(void)
 {
-    if (g_file_entries)
+    g_index_count = 0;
+    g_index_loaded = false;
+
+    for (size_t i = 0; i < g_sequence_count; i++)
     {
-        free(g_file_entries);
-        g_file_entries = NULL;
+        free(g_sequences[i].protocol);
     }
-    g_file_count = 0;
-}
\ No newline at end of file
+    free(g_sequences);
+    g_sequences = NULL;
+    g_sequence_count = 0;
+    g_sequences_loaded = false;
+}
+
+bool protopirate_storage_save_trace(void)
+{
+#ifdef PROTOPIRATE_TRACE
+    ProtoPirateTraceRecord *records = malloc(sizeof(ProtoPirateTraceRecord) * PROTOPIRATE_TRACE_SIZE);
+    size_t count = protopirate_trace_read(records, PROTOPIRATE_TRACE_SIZE);
+    bool result = false;
+
+    if (count > 0 && protopirate_storage_init())
+    {
+        Storage *storage = furi_record_open(RECORD_STORAGE);
+        File *file = storage_file_alloc(storage);
+        size_t size = sizeof(ProtoPirateTraceRecord) * count;
+
+        if (storage_file_open(file, PROTOPIRATE_TRACE_FILE, FSAM_WRITE, FSOM_CREATE_ALWAYS))
+        {
+            result = storage_file_write(file, records, size) == size;
+        }
+        FURI_LOG_I(TAG, "Trace: %zu events to %s %s", count, PROTOPIRATE_TRACE_FILE, result ? "OK" : "FAILED");
+
+        storage_file_close(file);
+        storage_file_free(file);
+        furi_record_close(RECORD_STORAGE);
+    }
+
+    free(records);
+    return result;
+#else
+    return false;
+#endif
+}
+
+bool protopirate_storage_save_stats(void)
+{
+    if (!protopirate_storage_init())
+        return false;
+
+    FuriString *csv = furi_string_alloc();
+    protopirate_stats_format_csv(csv);
+
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    File *file = storage_file_alloc(storage);
+    size_t size = furi_string_size(csv);
+    bool result = false;
+
+    if (storage_file_open(file, PROTOPIRATE_STATS_FILE, FSAM_WRITE, FSOM_CREATE_ALWAYS))
+    {
+        result = storage_file_write(file, furi_string_get_cstr(csv), size) == size;
+    }
+    FURI_LOG_I(TAG, "Stats to %s %s", PROTOPIRATE_STATS_FILE, result ? "OK" : "FAILED");
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    furi_string_free(csv);
+    return result;
+}
@@ -8,17 +8,53 @@
 #define PROTOPIRATE_APP_FOLDER EXT_PATH("subghz/protopirate")
 #define PROTOPIRATE_APP_EXTENSION ".sub"
 #define PROTOPIRATE_APP_FILE_VERSION 1
+#define PROTOPIRATE_TRACE_FILE PROTOPIRATE_APP_FOLDER "/trace.bin"
+#define PROTOPIRATE_STATS_FILE PROTOPIRATE_APP_FOLDER "/stats.csv"
+// Next capture number per protocol, "<protocol> <next>" per line
+#define PROTOPIRATE_SEQUENCE_FILE PROTOPIRATE_APP_FOLDER "/.sequence"
+// ProtoPirateStorageEntry records of every saved capture, oldest first
+#define PROTOPIRATE_INDEX_FILE PROTOPIRATE_APP_FOLDER "/.index"
+
+typedef enum {
+    ProtoPirateStorageEntrySerial = (1 << 0),
+    ProtoPirateStorageEntryButton = (1 << 1),
+    ProtoPirateStorageEntryTruncated = (1 << 2), // name is the start of a longer one
+} ProtoPirateStorageEntryFlags;
+
+typedef struct {
+    char name[64]; // without folder and extension
+    uint64_t name_hash; // of the whole name, tells truncated ones apart
+    char protocol[16];
+    uint32_t timestamp; // file mtime, seconds
+    uint32_t frequency;
+    uint32_t serial;
+    uint8_t button;
+    uint8_t flags; // ProtoPirateStorageEntryFlags
+    uint16_t reserved;
+} ProtoPirateStorageEntry;
 
 bool protopirate_storage_init();
 bool protopirate_storage_save_capture(
     FlipperFormat *flipper_format,
     const char *protocol_name,
     FuriString *out_path);
+// <protocol>_<n>.sub with n from PROTOPIRATE_SEQUENCE_FILE, rebuilt from one
+// directory scan if it's missing. Not thread safe.
 bool protopirate_storage_get_next_filename(
     const char *protocol_name,
     FuriString *out_filename);
+// Saved captures come from PROTOPIRATE_INDEX_FILE, checked against the folder
+// on first use and kept up to date by save_capture and delete_file after that.
+// Only the count is held in RAM, entries are read from the file a page at a
+// time. Index 0 is the newest. Not thread safe.
 uint32_t protopirate_storage_get_file_count();
+// Up to count entries from index on, newest first, returns how many were read
+uint32_t protopirate_storage_get_entries(uint32_t index, ProtoPirateStorageEntry *entries, uint32_t count);
 bool protopirate_storage_get_file_by_index(uint32_t index, FuriString *out_path, FuriString *out_name);
 bool protopirate_storage_delete_file(const char *file_path);
 FlipperFormat *protopirate_storage_load_file(const char *file_path);
-void protopirate_storage_free_file_list(void);
\ No newline at end of file
+void protopirate_storage_free_file_list(void);
+// Raw ProtoPirateTraceRecord dump of the decoder trace ring, no-op without PROTOPIRATE_TRACE
+bool protopirate_storage_save_trace(void);
+// protopirate_stats_format_csv() written to PROTOPIRATE_STATS_FILE
+bool protopirate_storage_save_stats(void);
\ No newline at end of file
@@ -0,0 +1,104 @@
+// helpers/protopirate_trace.c
+#include "protopirate_trace.h"
+
+#ifdef PROTOPIRATE_TRACE
+
+// Lock-free ring: writers claim a slot with one atomic add and publish it by
+// storing seq last, readers trust a slot only if seq matches what they expect
+static ProtoPirateTraceRecord trace_ring[PROTOPIRATE_TRACE_SIZE];
+static uint32_t trace_head;
+
+void protopirate_trace_push(
+    uint8_t protocol,
+    uint8_t event,
+    uint8_t step,
+    uint8_t bit_index,
+    uint32_t duration) {
+    uint32_t seq = __atomic_fetch_add(&trace_head, 1, __ATOMIC_RELAXED);
+    ProtoPirateTraceRecord* record = &trace_ring[seq & (PROTOPIRATE_TRACE_SIZE - 1)];
+
+    __atomic_store_n(&record->seq, UINT32_MAX, __ATOMIC_RELAXED);
+    record->duration = duration;
+    record->protocol = protocol;
+    record->event = event;
+    record->step = step;
+    record->bit_index = bit_index;
+    __atomic_store_n(&record->seq, seq, __ATOMIC_RELEASE);
+}
+
+size_t protopirate_trace_read(ProtoPirateTraceRecord* out, size_t max) {
+    uint32_t head = __atomic_load_n(&trace_head, __ATOMIC_ACQUIRE);
+    uint32_t available = MIN(head, (uint32_t)PROTOPIRATE_TRACE_SIZE);
+    if(max > available) max = available;
+
+    size_t count = 0;
+    for(uint32_t seq = head - max; seq != head; seq++) {
+        const ProtoPirateTraceRecord* record = &trace_ring[seq & (PROTOPIRATE_TRACE_SIZE - 1)];
+        if(__atomic_load_n(&record->seq, __ATOMIC_ACQUIRE) != seq) continue;
+
+        out[count] = *record;
+        // Overwritten while copying
+        if(__atomic_load_n(&record->seq, __ATOMIC_ACQUIRE) != seq) continue;
+        count++;
+    }
+    return count;
+}
+
+void protopirate_trace_clear(void) {
+    __atomic_store_n(&trace_head, 0, __ATOMIC_RELEASE);
+    memset(trace_ring, 0, sizeof(trace_ring));
+}
+
+#else
+
+size_t protopirate_trace_read(ProtoPirateTraceRecord* out, size_t max) {
+    UNUSED(out);
+    UNUSED(max);
+    return 0;
+}
+
+void protopirate_trace_clear(void) {
+}
+
+#endif
+
+static const char* const trace_protocol_names[ProtoPirateTraceProtocolCount] = {
+    [ProtoPirateTraceProtocolKiaV0] = "Kia V0",
+    [ProtoPirateTraceProtocolKiaV1] = "Kia V1",
+    [ProtoPirateTraceProtocolKiaV2] = "Kia V2",
+    [ProtoPirateTraceProtocolKiaV3V4] = "Kia V3/V4",
+    [ProtoPirateTraceProtocolKiaV5] = "Kia V5",
+    [ProtoPirateTraceProtocolHyundai] = "Hyundai",
+    [ProtoPirateTraceProtocolFordV0] = "Ford V0",
+    [ProtoPirateTraceProtocolSubaru] = "Subaru",
+    [ProtoPirateTraceProtocolSuzuki] = "Suzuki",
+    [ProtoPirateTraceProtocolMazda] = "Mazda",
+    [ProtoPirateTraceProtocolHonda] = "Honda",
+    [ProtoPirateTraceProtocolMitsubishi] = "Mitsubishi",
+    [ProtoPirateTraceProtocolVw] = "VW",
+    [ProtoPirateTraceProtocolPeugeot] = "Peugeot",
+    [ProtoPirateTraceProtocolCitroen] = "Citroen",
+    [ProtoPirateTraceProtocolBmw] = "BMW",
+    [ProtoPirateTraceProtocolFiatV0] = "Fiat V0",
+};
+
+const char* protopirate_trace_protocol_name(uint8_t protocol) {
+    return protocol < ProtoPirateTraceProtocolCount ? trace_protocol_names[protocol] : "?";
+}
+
+const char* protopirate_trace_event_name(uint8_t event) {
+    switch(event) {
+    case ProtoPirateTraceEventSync:
+        return "sync";
+    case ProtoPirateTraceEventMismatch:
+        return "mismatch";
+    case ProtoPirateTraceEventEarlyEnd:
+        return "early-end";
+    case ProtoPirateTraceEventDecoded:
+        return "decoded";
+    case ProtoPirateTraceEventBitCount:
+        return "bit-count";
+    default:
+        return "?";
+    }
+}
@@ -0,0 +1,93 @@
+// helpers/protopirate_trace.h
+#pragma once
+
+#include <furi.h>
+#include "protopirate_stats.h"
+
+// Hot-path decoder trace. feed() records fixed-size binary events instead of
+// formatting log strings per pulse. The ring is only built with PROTOPIRATE_TRACE
+// defined (cdefines in application.fam, or `make -C host TRACE=1`), without it
+// PROTOPIRATE_TRACE_EVENT only bumps the protopirate_stats counters.
+
+#define PROTOPIRATE_TRACE_SIZE 256 // events, power of two
+
+typedef enum {
+    ProtoPirateTraceProtocolKiaV0,
+    ProtoPirateTraceProtocolKiaV1,
+    ProtoPirateTraceProtocolKiaV2,
+    ProtoPirateTraceProtocolKiaV3V4,
+    ProtoPirateTraceProtocolKiaV5,
+    ProtoPirateTraceProtocolHyundai,
+    ProtoPirateTraceProtocolFordV0,
+    ProtoPirateTraceProtocolSubaru,
+    ProtoPirateTraceProtocolSuzuki,
+    ProtoPirateTraceProtocolMazda,
+    ProtoPirateTraceProtocolHonda,
+    ProtoPirateTraceProtocolMitsubishi,
+    ProtoPirateTraceProtocolVw,
+    ProtoPirateTraceProtocolPeugeot,
+    ProtoPirateTraceProtocolCitroen,
+    ProtoPirateTraceProtocolBmw,
+    ProtoPirateTraceProtocolFiatV0,
+    ProtoPirateTraceProtocolCount,
+} ProtoPirateTraceProtocol;
+
+typedef enum {
+    ProtoPirateTraceEventSync, // preamble accepted, data starts
+    ProtoPirateTraceEventMismatch, // pulse outside every timing window
+    ProtoPirateTraceEventEarlyEnd, // end gap before the frame was complete
+    ProtoPirateTraceEventDecoded, // frame handed to the callback
+    ProtoPirateTraceEventBitCount, // frame ended with a bit count the protocol rejects
+} ProtoPirateTraceEvent;
+
+// Frame end with the wrong bit count: short of min_bits is an early end,
+// anything else the protocol rejects is a bit count mismatch
+#define PROTOPIRATE_TRACE_END_EVENT(bits, min_bits) \
+    ((bits) < (min_bits) ? ProtoPirateTraceEventEarlyEnd : ProtoPirateTraceEventBitCount)
+
+typedef struct {
+    uint32_t seq;
+    uint32_t duration;
+    uint8_t protocol;
+    uint8_t event;
+    uint8_t step;
+    uint8_t bit_index;
+} ProtoPirateTraceRecord;
+
+#ifdef PROTOPIRATE_TRACE
+
+void protopirate_trace_push(
+    uint8_t protocol,
+    uint8_t event,
+    uint8_t step,
+    uint8_t bit_index,
+    uint32_t duration);
+
+#define PROTOPIRATE_TRACE_EVENT(protocol, event, step, bit_index, duration) \
+    do {                                                                      \
+        protopirate_stats_event(protocol, event);                             \
+        protopirate_trace_push(protocol, event, step, bit_index, duration);   \
+    } while(0)
+
+#else
+
+// Release builds keep the stats hook, so every trace point on the feed() path
+// still costs a protopirate_stats_enabled test, plus a protopirate_stats_count
+// call while the receiver counts. The other arguments are only consumed.
+#define PROTOPIRATE_TRACE_EVENT(protocol, event, step, bit_index, duration) \
+    do {                                                                      \
+        protopirate_stats_event(protocol, event);                             \
+        UNUSED(step);                                                         \
+        UNUSED(bit_index);                                                    \
+        UNUSED(duration);                                                     \
+    } while(0)
+
+#endif
+
+// Copies up to max events, oldest first. Safe while decoders keep pushing,
+// records overwritten during the copy are skipped. Returns 0 without PROTOPIRATE_TRACE
+size_t protopirate_trace_read(ProtoPirateTraceRecord* out, size_t max);
+void protopirate_trace_clear(void);
+
+const char* protopirate_trace_protocol_name(uint8_t protocol);
+const char* protopirate_trace_event_name(uint8_t event);
@@ -12,6 +12,7 @@ typedef enum
     ProtoPirateViewReceiver,
     ProtoPirateViewReceiverInfo,
     ProtoPirateViewAbout,
+    ProtoPirateViewStats,
 } ProtoPirateView;
 
 typedef enum
@@ -21,6 +22,7 @@ typedef enum
     ProtoPirateCustomEventViewReceiverConfig,
     ProtoPirateCustomEventViewReceiverBack,
     ProtoPirateCustomEventViewReceiverUnlock,
+    ProtoPirateCustomEventViewReceiverStats,
     // Custom events for scenes
     ProtoPirateCustomEventSceneReceiverUpdate,
     ProtoPirateCustomEventSceneSettingLock,
@@ -34,6 +36,7 @@ typedef enum
     ProtoPirateCustomEventEmulateExit,
     // Sub decode
     ProtoPirateCustomEventSubDecodeSave,
+    ProtoPirateCustomEventSubDecodeSelect,
 } ProtoPirateCustomEvent;
 
 typedef enum
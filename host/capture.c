@@ -0,0 +1,48 @@
+// host/capture.c
+#include "capture.h"
+
+#include <flipper_format/flipper_format.h>
+
+bool host_capture_load(HostCapture* capture, const char* path) {
+    memset(capture, 0, sizeof(HostCapture));
+
+    bool ok = false;
+    size_t capacity = 0;
+    FlipperFormat* ff = flipper_format_file_alloc(NULL);
+    FuriString* value = furi_string_alloc();
+    uint32_t version = 0;
+
+    do {
+        if(!flipper_format_file_open_existing(ff, path)) break;
+        if(!flipper_format_read_header(ff, value, &version)) break;
+        if(!flipper_format_read_string(ff, "Protocol", value)) break;
+        if(!furi_string_equal(value, "RAW")) break;
+
+        while(flipper_format_read_string(ff, "RAW_Data", value)) {
+            const char* p = furi_string_get_cstr(value);
+            char* end = NULL;
+            for(long sample = strtol(p, &end, 10); end != p; sample = strtol(p, &end, 10)) {
+                p = end;
+                if(sample == 0) continue;
+                if(capture->count == capacity) {
+                    capacity = capacity ? capacity * 2 : 4096;
+                    capture->samples = realloc(capture->samples, capacity * sizeof(int32_t));
+                    furi_check(capture->samples);
+                }
+                capture->samples[capture->count++] = (int32_t)sample;
+                capture->duration_us += (uint64_t)(sample > 0 ? sample : -sample);
+            }
+        }
+        ok = capture->count > 0;
+    } while(false);
+
+    furi_string_free(value);
+    flipper_format_free(ff);
+    if(!ok) host_capture_free(capture);
+    return ok;
+}
+
+void host_capture_free(HostCapture* capture) {
+    free(capture->samples);
+    memset(capture, 0, sizeof(HostCapture));
+}
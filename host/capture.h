@@ -0,0 +1,15 @@
+// host/capture.h
+#pragma once
+
+#include <furi.h>
+
+// A RAW .sub file loaded into memory, level in the sign like RAW_Data
+typedef struct {
+    int32_t* samples;
+    size_t count;
+    uint64_t duration_us;
+} HostCapture;
+
+// false if the file can't be opened or is not a RAW capture
+bool host_capture_load(HostCapture* capture, const char* path);
+void host_capture_free(HostCapture* capture);
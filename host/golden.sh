@@ -0,0 +1,45 @@
+#!/bin/sh
+# host/golden.sh
+# Decodes every capture in ../reference and synthetic/ and compares the
+# frames (key, serial, button, counter, bits and saved fields) with golden/.
+#   ./golden.sh check     fail on any difference
+#   ./golden.sh update    rewrite golden/ after an intended output change
+set -u
+
+mode=${1:-check}
+decoder=./protopirate-decode
+out=build/golden
+failed=0
+
+mkdir -p "$out"
+for sub in ../reference/*.sub synthetic/*.sub; do
+    set_name=$(basename "$(dirname "$sub")")
+    name=$(basename "$sub" .sub)
+    expected="golden/$set_name/$name.txt"
+    actual="$out/$set_name-$name.txt"
+
+    "$decoder" "$sub" > "$actual" 2>/dev/null
+    status=$?
+
+    # 1 only means an unsupported Key file, anything above is a crash
+    if [ $status -gt 1 ]; then
+        echo "FAIL $set_name/$name (exit $status)"
+        failed=$((failed + 1))
+    elif [ "$mode" = update ]; then
+        mkdir -p "golden/$set_name"
+        cp "$actual" "$expected"
+    elif ! diff -u "$expected" "$actual" > "$actual.diff" 2>&1; then
+        echo "FAIL $set_name/$name"
+        cat "$actual.diff"
+        failed=$((failed + 1))
+    else
+        echo "ok   $set_name/$name"
+    fi
+done
+
+if [ $failed -ne 0 ]; then
+    echo "$failed capture(s) failed"
+    exit 1
+elif [ "$mode" = update ]; then
+    echo "golden/ updated"
+fi
@@ -0,0 +1,131 @@
+// host/protopirate_bench.c
+// Replays RAW captures through every decoder in protopirate_protocol_registry
+// and reports the feed() cost. One CSV row per file and protocol, plus an
+// "(all)" row for the whole decoder set as the receiver runs it.
+#include <furi.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "capture.h"
+#include "../protocols/protocol_items.h"
+#include "../helpers/protopirate_decoder_set.h"
+
+#define BENCH_MIN_NS     (100ULL * 1000 * 1000)
+#define BENCH_MAX_ROUNDS 1000
+
+typedef struct {
+    size_t decodes;
+} BenchCounter;
+
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void bench_rx_callback(SubGhzProtocolDecoderBase* decoder_base, void* context) {
+    UNUSED(decoder_base);
+    BenchCounter* counter = context;
+    counter->decodes++;
+}
+
+static void bench_print_row(
+    const char* file,
+    const char* protocol,
+    const HostCapture* capture,
+    size_t rounds,
+    uint64_t elapsed_ns,
+    size_t decodes) {
+    uint64_t pulses = (uint64_t)capture->count * rounds;
+    double ns_per_pulse = (double)elapsed_ns / (double)pulses;
+    printf(
+        "\"%s\",\"%s\",%zu,%zu,%llu,%.2f,%.0f,%zu\n",
+        file,
+        protocol,
+        capture->count,
+        rounds,
+        (unsigned long long)elapsed_ns,
+        ns_per_pulse,
+        1e9 / ns_per_pulse,
+        decodes);
+}
+
+// Feeds the capture round after round until BENCH_MIN_NS have passed, decodes
+// are counted on the first round only so they don't scale with the round count
+static void bench_protocol(const char* file, const HostCapture* capture, const SubGhzProtocol* protocol) {
+    BenchCounter counter = {0};
+    const SubGhzProtocolDecoder* vtable = protocol->decoder;
+    SubGhzProtocolDecoderBase* decoder = vtable->alloc(NULL);
+    decoder->callback = bench_rx_callback;
+    decoder->context = &counter;
+
+    size_t rounds = 0;
+    size_t decodes = 0;
+    uint64_t start = bench_now_ns();
+    uint64_t elapsed = 0;
+    do {
+        vtable->reset(decoder);
+        for(size_t i = 0; i < capture->count; i++) {
+            int32_t sample = capture->samples[i];
+            vtable->feed(decoder, sample > 0, (uint32_t)(sample > 0 ? sample : -sample));
+        }
+        if(rounds++ == 0) decodes = counter.decodes;
+        elapsed = bench_now_ns() - start;
+    } while(elapsed < BENCH_MIN_NS && rounds < BENCH_MAX_ROUNDS);
+
+    bench_print_row(file, protocol->name, capture, rounds, elapsed, decodes);
+    vtable->free(decoder);
+}
+
+static void bench_decoder_set(const char* file, const HostCapture* capture) {
+    BenchCounter counter = {0};
+    ProtoPirateDecoderSet* set = protopirate_decoder_set_alloc(NULL);
+    protopirate_decoder_set_set_callback(set, bench_rx_callback, &counter);
+
+    size_t rounds = 0;
+    size_t decodes = 0;
+    uint64_t start = bench_now_ns();
+    uint64_t elapsed = 0;
+    do {
+        protopirate_decoder_set_reset(set);
+        for(size_t i = 0; i < capture->count; i++) {
+            int32_t sample = capture->samples[i];
+            protopirate_decoder_set_feed(
+                set, sample > 0, (uint32_t)(sample > 0 ? sample : -sample));
+        }
+        if(rounds++ == 0) decodes = counter.decodes;
+        elapsed = bench_now_ns() - start;
+    } while(elapsed < BENCH_MIN_NS && rounds < BENCH_MAX_ROUNDS);
+
+    bench_print_row(file, "(all)", capture, rounds, elapsed, decodes);
+    protopirate_decoder_set_free(set);
+}
+
+int main(int argc, char** argv) {
+    if(argc < 2) {
+        fprintf(stderr, "usage: %s file.sub... > bench.csv\n", argv[0]);
+        return 2;
+    }
+
+    printf("file,protocol,pulses,rounds,total_ns,ns_per_pulse,pulses_per_sec,decodes\n");
+    for(int i = 1; i < argc; i++) {
+        const char* file = strrchr(argv[i], '/');
+        file = file ? file + 1 : argv[i];
+
+        HostCapture capture;
+        if(!host_capture_load(&capture, argv[i])) {
+            fprintf(stderr, "skip %s: not a RAW capture\n", file);
+            continue;
+        }
+
+        for(size_t p = 0; p < protopirate_protocol_registry.size; p++) {
+            const SubGhzProtocol* protocol = protopirate_protocol_registry.items[p];
+            if(!protocol->decoder || !protocol->decoder->feed) continue;
+            bench_protocol(file, &capture, protocol);
+        }
+        bench_decoder_set(file, &capture);
+
+        host_capture_free(&capture);
+    }
+    return 0;
+}
@@ -0,0 +1,248 @@
+// host/protopirate_decode.c
+// Runs .sub captures through the ProtoPirate decoders on a PC.
+// RAW files are streamed through every decoder, Key files are deserialized
+// by their own protocol and printed with get_string.
+#include <furi.h>
+#include <flipper_format/flipper_format.h>
+#include <stdio.h>
+
+#include "../protocols/protocol_items.h"
+#include "../helpers/protopirate_decoder_set.h"
+#include "../helpers/protopirate_trace.h"
+#include "../helpers/protopirate_stats.h"
+#include "capture.h"
+
+#define TAG "ProtoPirateDecodeCli"
+
+typedef struct {
+    FuriString* text;
+    FlipperFormat* data;
+    SubGhzRadioPreset preset;
+    uint32_t sample_offset;
+    uint64_t time_us;
+    size_t frames;
+} DecodeCliContext;
+
+static void decode_cli_print_text(FuriString* text) {
+    furi_string_replace_all(text, "\r\n", "\n");
+    furi_string_replace_all(text, "\r", "\n");
+
+    const char* p = furi_string_get_cstr(text);
+    while(*p) {
+        const char* end = strchr(p, '\n');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+        if(len) printf("  %.*s\n", (int)len, p);
+        if(!end) break;
+        p = end + 1;
+    }
+}
+
+// Saved fields as they would land in the .sub, minus the file/radio header
+static void decode_cli_print_saved(FlipperFormat* data, FuriString* text) {
+    flipper_format_shim_get_text(data, text);
+    const char* p = strstr(furi_string_get_cstr(text), "\nProtocol: ");
+    p = p ? strchr(p + 1, '\n') : NULL;
+    while(p && *++p) {
+        const char* end = strchr(p, '\n');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+        printf("  | %.*s\n", (int)len, p);
+        p = end;
+    }
+}
+
+static void decode_cli_rx_callback(SubGhzProtocolDecoderBase* decoder_base, void* context) {
+    DecodeCliContext* ctx = context;
+    ctx->frames++;
+
+    furi_string_reset(ctx->text);
+    decoder_base->protocol->decoder->get_string(decoder_base, ctx->text);
+
+    printf(
+        "frame %zu: %s @ sample %u, %u.%03u s\n",
+        ctx->frames,
+        decoder_base->protocol->name,
+        (unsigned)ctx->sample_offset,
+        (unsigned)(ctx->time_us / 1000000),
+        (unsigned)(ctx->time_us / 1000 % 1000));
+    decode_cli_print_text(ctx->text);
+
+    flipper_format_shim_clear(ctx->data);
+    if(decoder_base->protocol->decoder->serialize(decoder_base, ctx->data, &ctx->preset) ==
+       SubGhzProtocolStatusOk) {
+        decode_cli_print_saved(ctx->data, ctx->text);
+    } else {
+        printf("  | serialize failed\n");
+    }
+}
+
+static void decode_cli_print_trace(void) {
+    ProtoPirateTraceRecord records[PROTOPIRATE_TRACE_SIZE];
+    size_t count = protopirate_trace_read(records, COUNT_OF(records));
+    printf("trace: %zu events\n", count);
+    for(size_t i = 0; i < count; i++) {
+        printf(
+            "  #%u %s %s step=%u bits=%u dur=%u\n",
+            (unsigned)records[i].seq,
+            protopirate_trace_protocol_name(records[i].protocol),
+            protopirate_trace_event_name(records[i].event),
+            records[i].step,
+            records[i].bit_index,
+            (unsigned)records[i].duration);
+    }
+}
+
+static uint32_t decode_cli_glitch_us = 0;
+
+// Same samples the bench feeds, capture.c is the one RAW_Data parser
+static bool decode_cli_raw(const HostCapture* capture) {
+    DecodeCliContext ctx = {
+        .text = furi_string_alloc(),
+        .data = flipper_format_string_alloc(),
+        .preset = {.name = furi_string_alloc_set("AM650"), .frequency = 433920000},
+    };
+    ProtoPirateDecoderSet* set = protopirate_decoder_set_alloc(NULL);
+    protopirate_decoder_set_set_callback(set, decode_cli_rx_callback, &ctx);
+    protopirate_decoder_set_set_glitch_filter(set, decode_cli_glitch_us);
+
+    for(size_t i = 0; i < capture->count; i++) {
+        int32_t sample = capture->samples[i];
+        bool level = sample > 0;
+        uint32_t duration = level ? (uint32_t)sample : (uint32_t)-sample;
+        protopirate_decoder_set_feed(set, level, duration);
+        ctx.sample_offset++;
+        ctx.time_us += duration;
+    }
+    protopirate_decoder_set_flush(set);
+
+    printf("%u samples, %zu frames", (unsigned)ctx.sample_offset, ctx.frames);
+    if(decode_cli_glitch_us) {
+        printf(", %u glitches merged", (unsigned)protopirate_decoder_set_get_glitches(set));
+    }
+    printf("\n");
+
+    protopirate_decoder_set_free(set);
+    furi_string_free(ctx.preset.name);
+    flipper_format_free(ctx.data);
+    furi_string_free(ctx.text);
+    return ctx.sample_offset > 0;
+}
+
+static const SubGhzProtocol* decode_cli_find_protocol(const char* name) {
+    for(size_t i = 0; i < protopirate_protocol_registry.size; i++) {
+        const SubGhzProtocol* protocol = protopirate_protocol_registry.items[i];
+        if(strcasecmp(protocol->name, name) == 0) return protocol;
+    }
+    return NULL;
+}
+
+static bool decode_cli_key(FlipperFormat* ff, const char* protocol_name) {
+    const SubGhzProtocol* protocol = decode_cli_find_protocol(protocol_name);
+    if(!protocol || !protocol->decoder || !protocol->decoder->deserialize) {
+        printf("unsupported protocol: %s\n", protocol_name);
+        return false;
+    }
+
+    bool ok = false;
+    void* decoder = protocol->decoder->alloc(NULL);
+    flipper_format_rewind(ff);
+    if(protocol->decoder->deserialize(decoder, ff) == SubGhzProtocolStatusOk) {
+        FuriString* text = furi_string_alloc();
+        protocol->decoder->get_string(decoder, text);
+        printf("key: %s\n", protocol->name);
+        decode_cli_print_text(text);
+        furi_string_free(text);
+        ok = true;
+    } else {
+        printf("deserialize failed: %s\n", protocol->name);
+    }
+    protocol->decoder->free(decoder);
+    return ok;
+}
+
+static bool decode_cli_trace = false;
+
+static bool decode_cli_file(const char* path) {
+    bool ok = false;
+    FlipperFormat* ff = flipper_format_file_alloc(NULL);
+    FuriString* filetype = furi_string_alloc();
+    FuriString* protocol = furi_string_alloc();
+    uint32_t version = 0;
+
+    printf("file: %s\n", path);
+    do {
+        if(!flipper_format_file_open_existing(ff, path)) {
+            printf("cannot open\n");
+            break;
+        }
+        if(!flipper_format_read_header(ff, filetype, &version)) {
+            printf("bad header\n");
+            break;
+        }
+        if(!flipper_format_read_string(ff, "Protocol", protocol)) {
+            printf("missing Protocol\n");
+            break;
+        }
+
+        if(furi_string_equal(protocol, "RAW")) {
+            // An empty capture fails to load and decodes as 0 samples
+            HostCapture capture;
+            host_capture_load(&capture, path);
+            protopirate_trace_clear();
+            ok = decode_cli_raw(&capture);
+            host_capture_free(&capture);
+            if(decode_cli_trace) decode_cli_print_trace();
+        } else {
+            ok = decode_cli_key(ff, furi_string_get_cstr(protocol));
+        }
+    } while(false);
+    printf("\n");
+
+    furi_string_free(protocol);
+    furi_string_free(filetype);
+    flipper_format_free(ff);
+    return ok;
+}
+
+static void decode_cli_usage(const char* argv0) {
+    fprintf(stderr, "usage: %s [-v] [-t] [-s] [-g us] file.sub...\n", argv0);
+    fprintf(stderr, "  -t  dump the decoder trace ring (build with make TRACE=1)\n");
+    fprintf(stderr, "  -s  print per-protocol decoder stats for all files as CSV\n");
+    fprintf(stderr, "  -g  merge pulses shorter than us into their neighbours, off by default\n");
+}
+
+int main(int argc, char** argv) {
+    int first = 1;
+    for(; first < argc && argv[first][0] == '-'; first++) {
+        if(strcmp(argv[first], "-v") == 0) {
+            furi_log_set_level(FuriLogLevelDebug);
+        } else if(strcmp(argv[first], "-vv") == 0) {
+            furi_log_set_level(FuriLogLevelTrace);
+        } else if(strcmp(argv[first], "-t") == 0) {
+            decode_cli_trace = true;
+        } else if(strcmp(argv[first], "-s") == 0) {
+            protopirate_stats_set_enabled(true);
+        } else if(strcmp(argv[first], "-g") == 0 && first + 1 < argc) {
+            decode_cli_glitch_us = strtoul(argv[++first], NULL, 10);
+        } else {
+            decode_cli_usage(argv[0]);
+            return 2;
+        }
+    }
+    if(first == argc) {
+        decode_cli_usage(argv[0]);
+        return 2;
+    }
+
+    int failed = 0;
+    for(int i = first; i < argc; i++) {
+        if(!decode_cli_file(argv[i])) failed++;
+    }
+
+    if(protopirate_stats_enabled) {
+        FuriString* csv = furi_string_alloc();
+        protopirate_stats_format_csv(csv);
+        printf("stats:\n%s", furi_string_get_cstr(csv));
+        furi_string_free(csv);
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,262 @@
+// host/shim/flipper_format.c
+#include <flipper_format/flipper_format.h>
+
+#include <stdio.h>
+#include <ctype.h>
+
+typedef struct {
+    char* key;
+    char* value;
+} FlipperFormatLine;
+
+struct FlipperFormat {
+    FlipperFormatLine* lines;
+    size_t count;
+    size_t capacity;
+    size_t position;
+};
+
+static void flipper_format_append(FlipperFormat* ff, const char* key, const char* value) {
+    if(ff->count == ff->capacity) {
+        ff->capacity = ff->capacity ? ff->capacity * 2 : 32;
+        ff->lines = realloc(ff->lines, ff->capacity * sizeof(FlipperFormatLine));
+        furi_check(ff->lines);
+    }
+    ff->lines[ff->count].key = strdup(key);
+    ff->lines[ff->count].value = strdup(value);
+    ff->count++;
+    ff->position = ff->count;
+}
+
+// Forward search from the current position, same as the firmware stream seek
+static const char* flipper_format_seek(FlipperFormat* ff, const char* key) {
+    for(size_t i = ff->position; i < ff->count; i++) {
+        if(strcmp(ff->lines[i].key, key) == 0) {
+            ff->position = i + 1;
+            return ff->lines[i].value;
+        }
+    }
+    ff->position = ff->count;
+    return NULL;
+}
+
+FlipperFormat* flipper_format_string_alloc(void) {
+    FlipperFormat* ff = calloc(1, sizeof(FlipperFormat));
+    furi_check(ff);
+    return ff;
+}
+
+FlipperFormat* flipper_format_file_alloc(Storage* storage) {
+    UNUSED(storage);
+    return flipper_format_string_alloc();
+}
+
+void flipper_format_shim_clear(FlipperFormat* ff) {
+    for(size_t i = 0; i < ff->count; i++) {
+        free(ff->lines[i].key);
+        free(ff->lines[i].value);
+    }
+    ff->count = 0;
+    ff->position = 0;
+}
+
+bool flipper_format_file_open_existing(FlipperFormat* ff, const char* path) {
+    FILE* file = fopen(path, "r");
+    if(!file) return false;
+
+    flipper_format_shim_clear(ff);
+
+    char* line = NULL;
+    size_t line_size = 0;
+    ssize_t len;
+    while((len = getline(&line, &line_size, file)) >= 0) {
+        while(len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r')) line[--len] = '\0';
+        if(len == 0 || line[0] == '#') continue;
+
+        char* colon = strchr(line, ':');
+        if(!colon) continue;
+        *colon = '\0';
+        char* value = colon + 1;
+        while(*value == ' ') value++;
+        flipper_format_append(ff, line, value);
+    }
+
+    free(line);
+    fclose(file);
+    ff->position = 0;
+    return true;
+}
+
+void flipper_format_free(FlipperFormat* ff) {
+    if(!ff) return;
+    flipper_format_shim_clear(ff);
+    free(ff->lines);
+    free(ff);
+}
+
+bool flipper_format_rewind(FlipperFormat* ff) {
+    ff->position = 0;
+    return true;
+}
+
+bool flipper_format_get_value_count(FlipperFormat* ff, const char* key, uint32_t* count) {
+    size_t position = ff->position;
+    const char* value = flipper_format_seek(ff, key);
+    ff->position = position;
+    if(!value) return false;
+
+    uint32_t values = 0;
+    bool in_value = false;
+    for(const char* p = value; *p; p++) {
+        if(isspace((unsigned char)*p)) {
+            in_value = false;
+        } else if(!in_value) {
+            in_value = true;
+            values++;
+        }
+    }
+    *count = values;
+    return true;
+}
+
+bool flipper_format_read_header(FlipperFormat* ff, FuriString* filetype, uint32_t* version) {
+    return flipper_format_read_string(ff, "Filetype", filetype) &&
+           flipper_format_read_uint32(ff, "Version", version, 1);
+}
+
+bool flipper_format_write_header(FlipperFormat* ff, FuriString* filetype, const uint32_t version) {
+    return flipper_format_write_header_cstr(ff, furi_string_get_cstr(filetype), version);
+}
+
+bool flipper_format_write_header_cstr(FlipperFormat* ff, const char* filetype, const uint32_t version) {
+    return flipper_format_write_string_cstr(ff, "Filetype", filetype) &&
+           flipper_format_write_uint32(ff, "Version", &version, 1);
+}
+
+bool flipper_format_read_string(FlipperFormat* ff, const char* key, FuriString* data) {
+    const char* value = flipper_format_seek(ff, key);
+    if(!value) return false;
+    furi_string_set_str(data, value);
+    return true;
+}
+
+bool flipper_format_write_string(FlipperFormat* ff, const char* key, FuriString* data) {
+    flipper_format_append(ff, key, furi_string_get_cstr(data));
+    return true;
+}
+
+bool flipper_format_write_string_cstr(FlipperFormat* ff, const char* key, const char* data) {
+    flipper_format_append(ff, key, data);
+    return true;
+}
+
+// Parses data_size numbers with strtoll/strtoull from the value of key
+static bool flipper_format_read_numbers(
+    FlipperFormat* ff,
+    const char* key,
+    void* data,
+    uint16_t data_size,
+    bool is_signed) {
+    const char* value = flipper_format_seek(ff, key);
+    if(!value) return false;
+
+    const char* p = value;
+    for(uint16_t i = 0; i < data_size; i++) {
+        char* end = NULL;
+        if(is_signed) {
+            long long v = strtoll(p, &end, 10);
+            if(end == p) return false;
+            ((int32_t*)data)[i] = (int32_t)v;
+        } else {
+            unsigned long long v = strtoull(p, &end, 10);
+            if(end == p) return false;
+            ((uint32_t*)data)[i] = (uint32_t)v;
+        }
+        p = end;
+    }
+    return true;
+}
+
+bool flipper_format_read_uint32(
+    FlipperFormat* ff,
+    const char* key,
+    uint32_t* data,
+    const uint16_t data_size) {
+    return flipper_format_read_numbers(ff, key, data, data_size, false);
+}
+
+bool flipper_format_read_int32(
+    FlipperFormat* ff,
+    const char* key,
+    int32_t* data,
+    const uint16_t data_size) {
+    return flipper_format_read_numbers(ff, key, data, data_size, true);
+}
+
+bool flipper_format_write_uint32(
+    FlipperFormat* ff,
+    const char* key,
+    const uint32_t* data,
+    const uint16_t data_size) {
+    FuriString* value = furi_string_alloc();
+    for(uint16_t i = 0; i < data_size; i++) {
+        furi_string_cat_printf(value, i ? " %lu" : "%lu", data[i]);
+    }
+    flipper_format_append(ff, key, furi_string_get_cstr(value));
+    furi_string_free(value);
+    return true;
+}
+
+bool flipper_format_write_int32(
+    FlipperFormat* ff,
+    const char* key,
+    const int32_t* data,
+    const uint16_t data_size) {
+    FuriString* value = furi_string_alloc();
+    for(uint16_t i = 0; i < data_size; i++) {
+        furi_string_cat_printf(value, i ? " %ld" : "%ld", data[i]);
+    }
+    flipper_format_append(ff, key, furi_string_get_cstr(value));
+    furi_string_free(value);
+    return true;
+}
+
+bool flipper_format_read_hex(
+    FlipperFormat* ff,
+    const char* key,
+    uint8_t* data,
+    const uint16_t data_size) {
+    const char* value = flipper_format_seek(ff, key);
+    if(!value) return false;
+
+    const char* p = value;
+    for(uint16_t i = 0; i < data_size; i++) {
+        while(*p == ' ') p++;
+        if(!isxdigit((unsigned char)p[0]) || !isxdigit((unsigned char)p[1])) return false;
+        char byte[3] = {p[0], p[1], '\0'};
+        data[i] = (uint8_t)strtoul(byte, NULL, 16);
+        p += 2;
+    }
+    return true;
+}
+
+bool flipper_format_write_hex(
+    FlipperFormat* ff,
+    const char* key,
+    const uint8_t* data,
+    const uint16_t data_size) {
+    FuriString* value = furi_string_alloc();
+    for(uint16_t i = 0; i < data_size; i++) {
+        furi_string_cat_printf(value, i ? " %02X" : "%02X", data[i]);
+    }
+    flipper_format_append(ff, key, furi_string_get_cstr(value));
+    furi_string_free(value);
+    return true;
+}
+
+void flipper_format_shim_get_text(FlipperFormat* ff, FuriString* output) {
+    furi_string_reset(output);
+    for(size_t i = 0; i < ff->count; i++) {
+        furi_string_cat_printf(output, "%s: %s\n", ff->lines[i].key, ff->lines[i].value);
+    }
+}
@@ -0,0 +1,86 @@
+// host/shim/flipper_format/flipper_format.h
+// Line based "Key: value" reader/writer with the firmware FlipperFormat semantics:
+// reads seek forward from the current position, a miss leaves it at the end
+#pragma once
+
+#include <furi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct FlipperFormat FlipperFormat;
+typedef struct Storage Storage;
+
+FlipperFormat* flipper_format_string_alloc(void);
+FlipperFormat* flipper_format_file_alloc(Storage* storage);
+bool flipper_format_file_open_existing(FlipperFormat* flipper_format, const char* path);
+void flipper_format_free(FlipperFormat* flipper_format);
+
+bool flipper_format_rewind(FlipperFormat* flipper_format);
+bool flipper_format_get_value_count(
+    FlipperFormat* flipper_format,
+    const char* key,
+    uint32_t* count);
+
+bool flipper_format_read_header(
+    FlipperFormat* flipper_format,
+    FuriString* filetype,
+    uint32_t* version);
+bool flipper_format_write_header(
+    FlipperFormat* flipper_format,
+    FuriString* filetype,
+    const uint32_t version);
+bool flipper_format_write_header_cstr(
+    FlipperFormat* flipper_format,
+    const char* filetype,
+    const uint32_t version);
+
+bool flipper_format_read_string(FlipperFormat* flipper_format, const char* key, FuriString* data);
+bool flipper_format_write_string(FlipperFormat* flipper_format, const char* key, FuriString* data);
+bool flipper_format_write_string_cstr(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const char* data);
+
+bool flipper_format_read_uint32(
+    FlipperFormat* flipper_format,
+    const char* key,
+    uint32_t* data,
+    const uint16_t data_size);
+bool flipper_format_write_uint32(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const uint32_t* data,
+    const uint16_t data_size);
+
+bool flipper_format_read_int32(
+    FlipperFormat* flipper_format,
+    const char* key,
+    int32_t* data,
+    const uint16_t data_size);
+bool flipper_format_write_int32(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const int32_t* data,
+    const uint16_t data_size);
+
+bool flipper_format_read_hex(
+    FlipperFormat* flipper_format,
+    const char* key,
+    uint8_t* data,
+    const uint16_t data_size);
+bool flipper_format_write_hex(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const uint8_t* data,
+    const uint16_t data_size);
+
+// Host only: drop all content (stream_clean on the device)
+void flipper_format_shim_clear(FlipperFormat* flipper_format);
+// Host only: the document as it would be written to a file
+void flipper_format_shim_get_text(FlipperFormat* flipper_format, FuriString* output);
+
+#ifdef __cplusplus
+}
+#endif
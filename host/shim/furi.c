@@ -0,0 +1,224 @@
+// host/shim/furi.c
+#include "furi.h"
+
+#include <stdio.h>
+#include <time.h>
+
+struct FuriString {
+    char* data;
+    size_t size;
+    size_t capacity;
+};
+
+static FuriLogLevel furi_log_level = FuriLogLevelNone;
+
+void furi_crash(const char* message) {
+    fprintf(stderr, "furi_crash: %s\n", message ? message : "");
+    abort();
+}
+
+void furi_log_set_level(FuriLogLevel level) {
+    furi_log_level = level;
+}
+
+// long is 32 bit on the Cortex-M4, so the firmware sources print uint32_t with
+// %lu / %lX. Drop a single 'l' length modifier so the host reads 32 bit values too
+static void furi_shim_format_fixup(const char* format, char* out, size_t out_size) {
+    size_t o = 0;
+    bool in_spec = false;
+    for(const char* p = format; *p && o + 1 < out_size; p++) {
+        if(!in_spec) {
+            if(*p == '%') in_spec = true;
+            out[o++] = *p;
+            continue;
+        }
+        if(*p == '%') {
+            in_spec = false;
+            out[o++] = *p;
+        } else if(*p == 'l') {
+            if(p[1] == 'l') {
+                out[o++] = *p++;
+                if(o + 1 < out_size) out[o++] = *p;
+            }
+        } else {
+            out[o++] = *p;
+            if(strchr("diouxXcspfFeEgGaAn", *p)) in_spec = false;
+        }
+    }
+    out[o] = '\0';
+}
+
+static int furi_shim_vformat(char** out, const char* format, va_list args) {
+    char fixed[512];
+    furi_shim_format_fixup(format, fixed, sizeof(fixed));
+    return vasprintf(out, fixed, args);
+}
+
+void furi_log_print_format(FuriLogLevel level, const char* tag, const char* format, ...) {
+    if(level > furi_log_level) return;
+    static const char* level_names = "?EWIDT";
+    char* text = NULL;
+    va_list args;
+    va_start(args, format);
+    int len = furi_shim_vformat(&text, format, args);
+    va_end(args);
+    if(len >= 0) {
+        fprintf(stderr, "[%c][%s] %s\n", level_names[level], tag, text);
+        free(text);
+    }
+}
+
+uint32_t furi_get_tick(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+static void furi_string_reserve(FuriString* string, size_t size) {
+    if(size + 1 <= string->capacity) return;
+    size_t capacity = string->capacity ? string->capacity : 16;
+    while(capacity < size + 1) capacity *= 2;
+    string->data = realloc(string->data, capacity);
+    furi_check(string->data);
+    string->capacity = capacity;
+}
+
+FuriString* furi_string_alloc(void) {
+    FuriString* string = calloc(1, sizeof(FuriString));
+    furi_check(string);
+    furi_string_reserve(string, 0);
+    string->data[0] = '\0';
+    return string;
+}
+
+FuriString*(furi_string_alloc_set)(const FuriString* source) {
+    FuriString* string = furi_string_alloc();
+    furi_string_set_str(string, source->data);
+    return string;
+}
+
+FuriString* furi_string_alloc_set_str(const char cstr_source[]) {
+    FuriString* string = furi_string_alloc();
+    furi_string_set_str(string, cstr_source);
+    return string;
+}
+
+FuriString* furi_string_alloc_printf(const char format[], ...) {
+    FuriString* string = furi_string_alloc();
+    va_list args;
+    va_start(args, format);
+    furi_string_vprintf(string, format, args);
+    va_end(args);
+    return string;
+}
+
+void furi_string_free(FuriString* string) {
+    if(!string) return;
+    free(string->data);
+    free(string);
+}
+
+void furi_string_reset(FuriString* string) {
+    string->size = 0;
+    string->data[0] = '\0';
+}
+
+void(furi_string_set)(FuriString* string, FuriString* source) {
+    if(string == source) return;
+    furi_string_set_str(string, source->data);
+}
+
+void furi_string_set_str(FuriString* string, const char cstr[]) {
+    size_t len = strlen(cstr);
+    furi_string_reserve(string, len);
+    memmove(string->data, cstr, len + 1);
+    string->size = len;
+}
+
+int furi_string_vprintf(FuriString* string, const char format[], va_list args) {
+    furi_string_reset(string);
+    char* text = NULL;
+    int len = furi_shim_vformat(&text, format, args);
+    if(len < 0) return len;
+    furi_string_cat_str(string, text);
+    free(text);
+    return len;
+}
+
+int furi_string_printf(FuriString* string, const char format[], ...) {
+    va_list args;
+    va_start(args, format);
+    int len = furi_string_vprintf(string, format, args);
+    va_end(args);
+    return len;
+}
+
+int furi_string_cat_printf(FuriString* string, const char format[], ...) {
+    char* text = NULL;
+    va_list args;
+    va_start(args, format);
+    int len = furi_shim_vformat(&text, format, args);
+    va_end(args);
+    if(len < 0) return len;
+    furi_string_cat_str(string, text);
+    free(text);
+    return len;
+}
+
+void(furi_string_cat)(FuriString* string, const FuriString* string2) {
+    furi_string_cat_str(string, string2->data);
+}
+
+void furi_string_cat_str(FuriString* string, const char string2[]) {
+    size_t len = strlen(string2);
+    furi_string_reserve(string, string->size + len);
+    memcpy(string->data + string->size, string2, len + 1);
+    string->size += len;
+}
+
+const char* furi_string_get_cstr(const FuriString* string) {
+    return string->data;
+}
+
+size_t furi_string_size(const FuriString* string) {
+    return string->size;
+}
+
+bool furi_string_empty(const FuriString* string) {
+    return string->size == 0;
+}
+
+bool(furi_string_equal)(const FuriString* string1, const FuriString* string2) {
+    return strcmp(string1->data, string2->data) == 0;
+}
+
+bool furi_string_equal_str(const FuriString* string1, const char string2[]) {
+    return strcmp(string1->data, string2) == 0;
+}
+
+int(furi_string_cmp)(const FuriString* string1, const FuriString* string2) {
+    return strcmp(string1->data, string2->data);
+}
+
+int furi_string_cmp_str(const FuriString* string1, const char string2[]) {
+    return strcmp(string1->data, string2);
+}
+
+void furi_string_replace_all_str(FuriString* string, const char find[], const char replace[]) {
+    size_t find_len = strlen(find);
+    if(find_len == 0) return;
+    FuriString* out = furi_string_alloc();
+    const char* p = string->data;
+    const char* hit;
+    while((hit = strstr(p, find)) != NULL) {
+        furi_string_reserve(out, out->size + (size_t)(hit - p));
+        memcpy(out->data + out->size, p, (size_t)(hit - p));
+        out->size += (size_t)(hit - p);
+        out->data[out->size] = '\0';
+        furi_string_cat_str(out, replace);
+        p = hit + find_len;
+    }
+    furi_string_cat_str(out, p);
+    furi_string_set_str(string, out->data);
+    furi_string_free(out);
+}
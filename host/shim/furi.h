@@ -0,0 +1,98 @@
+// host/shim/furi.h
+// Minimal stand-in for the furi core so protocols/*.c build on a Linux host
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UNUSED(x)   (void)(x)
+#define COUNT_OF(x) (sizeof(x) / sizeof(x[0]))
+
+#ifndef MIN
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+__attribute__((noreturn)) void furi_crash(const char* message);
+
+#define furi_check(x)                                          \
+    do {                                                       \
+        if(!(x)) furi_crash("furi_check failed: " #x);         \
+    } while(0)
+#define furi_assert(x) furi_check(x)
+
+// Logging, quiet unless furi_log_set_level() raises it
+typedef enum {
+    FuriLogLevelNone = 0,
+    FuriLogLevelError,
+    FuriLogLevelWarn,
+    FuriLogLevelInfo,
+    FuriLogLevelDebug,
+    FuriLogLevelTrace,
+} FuriLogLevel;
+
+void furi_log_set_level(FuriLogLevel level);
+void furi_log_print_format(FuriLogLevel level, const char* tag, const char* format, ...);
+
+#define FURI_LOG_E(tag, ...) furi_log_print_format(FuriLogLevelError, tag, __VA_ARGS__)
+#define FURI_LOG_W(tag, ...) furi_log_print_format(FuriLogLevelWarn, tag, __VA_ARGS__)
+#define FURI_LOG_I(tag, ...) furi_log_print_format(FuriLogLevelInfo, tag, __VA_ARGS__)
+#define FURI_LOG_D(tag, ...) furi_log_print_format(FuriLogLevelDebug, tag, __VA_ARGS__)
+#define FURI_LOG_T(tag, ...) furi_log_print_format(FuriLogLevelTrace, tag, __VA_ARGS__)
+
+uint32_t furi_get_tick(void);
+
+// FuriString
+typedef struct FuriString FuriString;
+
+FuriString* furi_string_alloc(void);
+FuriString* furi_string_alloc_set(const FuriString* source);
+FuriString* furi_string_alloc_set_str(const char cstr_source[]);
+FuriString* furi_string_alloc_printf(const char format[], ...);
+void furi_string_free(FuriString* string);
+
+void furi_string_reset(FuriString* string);
+void furi_string_set(FuriString* string, FuriString* source);
+void furi_string_set_str(FuriString* string, const char cstr[]);
+int furi_string_printf(FuriString* string, const char format[], ...);
+int furi_string_vprintf(FuriString* string, const char format[], va_list args);
+int furi_string_cat_printf(FuriString* string, const char format[], ...);
+void furi_string_cat(FuriString* string, const FuriString* string2);
+void furi_string_cat_str(FuriString* string, const char string2[]);
+
+const char* furi_string_get_cstr(const FuriString* string);
+size_t furi_string_size(const FuriString* string);
+bool furi_string_empty(const FuriString* string);
+bool furi_string_equal(const FuriString* string1, const FuriString* string2);
+bool furi_string_equal_str(const FuriString* string1, const char string2[]);
+int furi_string_cmp(const FuriString* string1, const FuriString* string2);
+int furi_string_cmp_str(const FuriString* string1, const char string2[]);
+void furi_string_replace_all_str(FuriString* string, const char find[], const char replace[]);
+
+// Same generic dispatch as the firmware header, FuriString* or C string
+#define FURI_STRING_SELECT(func_furi, func_cstr, arg) \
+    _Generic((arg), char*: func_cstr, const char*: func_cstr, default: func_furi)
+
+#define furi_string_alloc_set(a) \
+    FURI_STRING_SELECT(furi_string_alloc_set, furi_string_alloc_set_str, a)(a)
+#define furi_string_set(a, b)   FURI_STRING_SELECT(furi_string_set, furi_string_set_str, b)(a, b)
+#define furi_string_cat(a, b)   FURI_STRING_SELECT(furi_string_cat, furi_string_cat_str, b)(a, b)
+#define furi_string_equal(a, b) FURI_STRING_SELECT(furi_string_equal, furi_string_equal_str, b)(a, b)
+#define furi_string_cmp(a, b)   FURI_STRING_SELECT(furi_string_cmp, furi_string_cmp_str, b)(a, b)
+#define furi_string_replace_all(a, b, c) furi_string_replace_all_str(a, b, c)
+
+#ifdef __cplusplus
+}
+#endif
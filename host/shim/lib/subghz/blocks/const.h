@@ -0,0 +1,11 @@
+// host/shim/lib/subghz/blocks/const.h
+#pragma once
+
+#include <stdint.h>
+
+typedef struct {
+    const uint16_t te_long;
+    const uint16_t te_short;
+    const uint16_t te_delta;
+    const uint8_t min_count_bit_for_found;
+} SubGhzBlockConst;
@@ -0,0 +1,15 @@
+// host/shim/lib/subghz/blocks/encoder.h
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <lib/toolbox/level_duration.h>
+
+typedef struct {
+    bool is_running;
+    size_t repeat;
+    size_t front;
+    size_t size_upload;
+    LevelDuration* upload;
+} SubGhzProtocolBlockEncoder;
@@ -0,0 +1,5 @@
+// host/shim/lib/subghz/environment.h
+#pragma once
+
+// Opaque on the host, the ProtoPirate decoders never look inside it
+typedef struct SubGhzEnvironment SubGhzEnvironment;
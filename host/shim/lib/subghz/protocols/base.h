@@ -0,0 +1,24 @@
+// host/shim/lib/subghz/protocols/base.h
+#pragma once
+
+#include "../types.h"
+
+typedef struct SubGhzProtocolDecoderBase SubGhzProtocolDecoderBase;
+
+typedef void (*SubGhzProtocolDecoderBaseRxCallback)(
+    SubGhzProtocolDecoderBase* instance,
+    void* context);
+
+struct SubGhzProtocolDecoderBase {
+    // Decoder general section
+    const SubGhzProtocol* protocol;
+
+    // Callback section
+    SubGhzProtocolDecoderBaseRxCallback callback;
+    void* context;
+};
+
+typedef struct {
+    // Decoder general section
+    const SubGhzProtocol* protocol;
+} SubGhzProtocolEncoderBase;
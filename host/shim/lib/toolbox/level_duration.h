@@ -0,0 +1,53 @@
+// host/shim/lib/toolbox/level_duration.h
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define LEVEL_DURATION_RESET      0U
+#define LEVEL_DURATION_LEVEL_LOW  1U
+#define LEVEL_DURATION_LEVEL_HIGH 2U
+#define LEVEL_DURATION_WAIT       3U
+#define LEVEL_DURATION_RESERVED   0x800000U
+
+typedef struct {
+    uint32_t duration : 30;
+    uint8_t level     : 2;
+} LevelDuration;
+
+static inline LevelDuration level_duration_make(bool level, uint32_t duration) {
+    LevelDuration level_duration;
+    level_duration.level = level ? LEVEL_DURATION_LEVEL_HIGH : LEVEL_DURATION_LEVEL_LOW;
+    level_duration.duration = duration;
+    return level_duration;
+}
+
+static inline LevelDuration level_duration_reset(void) {
+    LevelDuration level_duration;
+    level_duration.level = LEVEL_DURATION_RESET;
+    level_duration.duration = 0;
+    return level_duration;
+}
+
+static inline LevelDuration level_duration_wait(void) {
+    LevelDuration level_duration;
+    level_duration.level = LEVEL_DURATION_WAIT;
+    level_duration.duration = 0;
+    return level_duration;
+}
+
+static inline bool level_duration_is_reset(LevelDuration level_duration) {
+    return level_duration.level == LEVEL_DURATION_RESET;
+}
+
+static inline bool level_duration_is_wait(LevelDuration level_duration) {
+    return level_duration.level == LEVEL_DURATION_WAIT;
+}
+
+static inline bool level_duration_get_level(LevelDuration level_duration) {
+    return level_duration.level == LEVEL_DURATION_LEVEL_HIGH;
+}
+
+static inline uint32_t level_duration_get_duration(LevelDuration level_duration) {
+    return level_duration.duration;
+}
@@ -0,0 +1,224 @@
+#!/usr/bin/env python3
+# host/synthetic/gen_synthetic.py
+# Writes one RAW .sub per protocol with a clean, known frame repeated a few
+# times. The timings follow what each decoder in protocols/ expects, so the
+# files double as test captures for the Sub-GHz app on a Flipper.
+#
+#   python3 gen_synthetic.py        (run from host/synthetic)
+
+import os
+
+REPEATS = 3
+FRAME_GAP = 20000
+LINE_SAMPLES = 64
+
+
+class Pulses:
+    # Merges neighbours of the same level the way a real RAW capture would
+    def __init__(self):
+        self.items = []
+
+    def add(self, level, duration):
+        if self.items and self.items[-1][0] == level:
+            self.items[-1][1] += duration
+        else:
+            self.items.append([level, duration])
+
+    def pairs(self, high, low, count):
+        for _ in range(count):
+            self.add(True, high)
+            self.add(False, low)
+
+    def halves(self, levels, te):
+        for level in levels:
+            self.add(level, te)
+
+
+def bits_of(value, count):
+    return [(value >> (count - 1 - i)) & 1 for i in range(count)]
+
+
+def manchester(bits, one, zero):
+    levels = []
+    for bit in bits:
+        levels += one if bit else zero
+    return levels
+
+
+def crc8_bmw(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x31) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+# Kia V0 / Hyundai: 61 bit PWM, the decoder seeds the leading 1 at the sync
+def frame_kia_v0(p):
+    cnt, serial, btn, crc = 0x1234, 0xABCDEF1, 0x2, 0x5A
+    data = (cnt << 40) | (serial << 12) | (btn << 8) | crc
+    p.pairs(250, 250, 20)
+    p.pairs(500, 500, 1)
+    for bit in bits_of(data, 59):
+        p.pairs(500 if bit else 250, 500 if bit else 250, 1)
+    p.add(True, 1000)
+
+
+# Kia V1: 800us Manchester, 10 = 1 / 01 = 0, after a long-pulse preamble
+def frame_kia_v1(p):
+    serial, btn, cnt, crc = 0x1A2B3C4D, 0x01, 0x2C, 0x3E
+    data = (serial << 24) | (btn << 16) | (cnt << 8) | crc
+    p.pairs(1600, 1600, 7)
+    p.add(True, 1600)
+    p.add(False, 800)
+    p.add(True, 800)
+    p.halves(manchester(bits_of(data, 56), [True, False], [False, True]), 800)
+
+
+# Kia V2: 500us Manchester, 53 bits, short high + short low ends the preamble
+def frame_kia_v2(p):
+    serial, btn, raw_cnt, crc = 0x5A6B7C8D, 0x3, 0x0A5, 0x6
+    data = (1 << 52) | (serial << 20) | (btn << 16) | (raw_cnt << 4) | crc
+    p.pairs(1000, 1000, 12)
+    p.pairs(500, 500, 1)
+    p.halves(manchester(bits_of(data, 53), [True, False], [False, True]), 500)
+
+
+# Ford V0 / Mazda: long preamble, 3.5ms gap, 80 bit Manchester with an implicit leading 1
+def frame_ford_like(p, key1, key2):
+    p.add(True, 250)
+    for _ in range(6):
+        p.add(False, 500)
+        p.add(True, 500)
+    p.add(False, 500)
+    p.add(True, 250)
+    p.add(False, 3500)
+    bits = bits_of((key1 << 16) | key2, 80)
+    bits[0] = 1
+    p.halves(manchester(bits, [True, False], [False, True]), 250)
+
+
+def frame_ford_v0(p):
+    frame_ford_like(p, 0xC3A5F00D12345678, 0x9ABC)
+
+
+def frame_mazda(p):
+    frame_ford_like(p, 0xD1E2F30415263748, 0x5A69)
+
+
+# Suzuki: 257+ short pairs, then 64 bit PWM on the high pulse, 2ms gap
+def frame_suzuki(p):
+    cnt, serial, btn, tail = 0x4321, 0x0ABCDEF, 0x3, 0x5A5
+    data = (0xF << 60) | (cnt << 44) | (serial << 16) | (btn << 12) | tail
+    p.pairs(250, 250, 260)
+    for bit in bits_of(data, 64):
+        p.add(True, 500 if bit else 250)
+        p.add(False, 250)
+    p.items[-1][1] = 2000
+    p.add(True, 250)
+
+
+# Honda: short pairs, long low, then short-long = 0 / long-short = 1
+def frame_honda(p):
+    data = 0x5A12345678ABCD03
+    p.pairs(432, 432, 12)
+    p.items[-1][1] = 864
+    for bit in bits_of(data, 64):
+        p.pairs(864, 432, 1) if bit else p.pairs(432, 864, 1)
+    p.add(True, 3000)
+
+
+# Mitsubishi: short pairs, long sync pair, short-short = 0 / long-long = 1
+def frame_mitsubishi(p):
+    data = 0x0123456789ABCDEF
+    p.pairs(320, 320, 12)
+    p.pairs(640, 640, 1)
+    for bit in bits_of(data, 64):
+        p.pairs(640 if bit else 320, 640 if bit else 320, 1)
+    p.add(True, 2000)
+
+
+# VW: short sync run, long/short/medium start, then 80 bit Manchester
+def frame_vw(p):
+    vw_type, key, check = 0xB3, 0x0011223344556677, 0x21
+    p.pairs(500, 500, 20)
+    p.add(True, 1000)
+    p.add(False, 500)
+    p.pairs(750, 750, 2)
+    bits = bits_of((vw_type << 72) | (key << 8) | check, 80)
+    p.halves(manchester(bits, [True, False], [False, True]), 500)
+
+
+# Peugeot / Citroen: short warm-up, 4.4ms gap, 66 bit PWM, low 12 bits set
+def frame_psa(p, data):
+    p.pairs(370, 370, 12)
+    p.items[-1][1] = 4400
+    for bit in bits_of(data, 66):
+        p.pairs(772, 370, 1) if bit else p.pairs(370, 772, 1)
+    p.add(True, 3000)
+
+
+def frame_peugeot(p):
+    frame_psa(p, 0x2_1234_5678_9ABC_F0FF)
+
+
+def frame_citroen(p):
+    frame_psa(p, 0x1_8765_4321_0FED_F1FF)
+
+
+# BMW: like Kia V0 framing, 64 bits, top byte is CRC8 of the low seven
+def frame_bmw(p):
+    body = 0x0012345678ABCD
+    crc = crc8_bmw(body.to_bytes(7, "little"))
+    data = (crc << 56) | body
+    p.pairs(350, 350, 20)
+    p.pairs(700, 700, 1)
+    for bit in bits_of(data, 64):
+        p.pairs(700 if bit else 350, 700 if bit else 350, 1)
+    p.add(True, 1500)
+
+
+FRAMES = {
+    "Kia V0": (frame_kia_v0, 433920000),
+    "Kia V1": (frame_kia_v1, 315000000),
+    "Kia V2": (frame_kia_v2, 315000000),
+    "Ford V0": (frame_ford_v0, 433920000),
+    "Mazda": (frame_mazda, 433920000),
+    "Suzuki": (frame_suzuki, 433920000),
+    "Honda": (frame_honda, 433920000),
+    "Mitsubishi": (frame_mitsubishi, 433920000),
+    "VW": (frame_vw, 433920000),
+    "Peugeot": (frame_peugeot, 433920000),
+    "Citroen": (frame_citroen, 433920000),
+    "BMW": (frame_bmw, 868350000),
+}
+
+
+def write_sub(path, frequency, pulses):
+    samples = [d if level else -d for level, d in pulses.items]
+    with open(path, "w") as f:
+        f.write("Filetype: Flipper SubGhz RAW File\n")
+        f.write("Version: 1\n")
+        f.write("Frequency: %d\n" % frequency)
+        f.write("Preset: FuriHalSubGhzPresetOok650Async\n")
+        f.write("Protocol: RAW\n")
+        for i in range(0, len(samples), LINE_SAMPLES):
+            f.write("RAW_Data: %s\n" % " ".join(str(s) for s in samples[i : i + LINE_SAMPLES]))
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    for name, (frame, frequency) in FRAMES.items():
+        p = Pulses()
+        p.add(False, FRAME_GAP)
+        for _ in range(REPEATS):
+            frame(p)
+            p.add(False, FRAME_GAP)
+        file_name = name.lower().replace(" ", "_") + ".sub"
+        write_sub(os.path.join(here, file_name), frequency, p)
+        print("wrote", file_name)
+
+
+if __name__ == "__main__":
+    main()
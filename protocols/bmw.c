@@ -1,4 +1,5 @@
 #include "bmw.h"
+#include "../helpers/protopirate_pwm.h"
 
 #define TAG "SubGhzProtocolBMW_868"
 
@@ -14,6 +15,7 @@ typedef struct SubGhzProtocolDecoderBMW {
     SubGhzBlockDecoder decoder;
     SubGhzBlockGeneric generic;
     uint16_t header_count;
+    uint8_t high_class;
     uint8_t crc_type; // 0 = unknown, 8 = CRC8, 16 = CRC16
 } SubGhzProtocolDecoderBMW;
 
@@ -23,17 +25,11 @@ typedef struct SubGhzProtocolEncoderBMW {
     SubGhzBlockGeneric generic;
 } SubGhzProtocolEncoderBMW;
 
-typedef enum {
-    BMWDecoderStepReset = 0,
-    BMWDecoderStepCheckPreambula,
-    BMWDecoderStepSaveDuration,
-    BMWDecoderStepCheckDuration,
-} BMWDecoderStep;
-
 static void subghz_protocol_decoder_bmw_reset_internal(SubGhzProtocolDecoderBMW* instance) {
     memset(&instance->decoder, 0, sizeof(instance->decoder));
     memset(&instance->generic, 0, sizeof(instance->generic));
-    instance->decoder.parser_step = BMWDecoderStepReset;
+    instance->generic.protocol_name = instance->base.protocol->name;
+    instance->decoder.parser_step = ProtoPiratePwmStepReset;
     instance->header_count = 0;
     instance->crc_type = 0;
 }
@@ -69,6 +65,14 @@ const SubGhzProtocol bmw_protocol = {
     .encoder = &subghz_protocol_bmw_encoder,
 };
 
+const ProtoPirateEntry bmw_protocol_entry = {
+    .block_const = &subghz_protocol_bmw_const,
+    .decoder_size = sizeof(SubGhzProtocolDecoderBMW),
+    .te = ProtoPirateEntryTeShort,
+    .level = ProtoPirateEntryLevelHigh,
+    .feed_pulse = subghz_protocol_decoder_bmw_feed_pulse,
+};
+
 // ----------------- Allocation / Reset / Free -------------------
 
 void* subghz_protocol_decoder_bmw_alloc(SubGhzEnvironment* environment) {
@@ -125,117 +129,54 @@ uint16_t subghz_protocol_bmw_crc16(uint8_t* data, size_t len) {
 
 // ----------------- Decoder Feed -------------------
 
-void subghz_protocol_decoder_bmw_feed(void* context, bool level, uint32_t duration) {
-    furi_assert(context);
+// CRC-8 over the frame, or CRC-16 if that doesn't match
+static bool subghz_protocol_bmw_check_crc(void* context) {
     SubGhzProtocolDecoderBMW* instance = context;
-
-    switch(instance->decoder.parser_step) {
-    case BMWDecoderStepReset:
-        if(level && (DURATION_DIFF(duration, subghz_protocol_bmw_const.te_short) <
-                     subghz_protocol_bmw_const.te_delta)) {
-            instance->decoder.parser_step = BMWDecoderStepCheckPreambula;
-            instance->decoder.te_last = duration;
-            instance->header_count = 0;
-            instance->decoder.decode_data = 0;
-            instance->decoder.decode_count_bit = 0;
-        }
-        break;
-
-    case BMWDecoderStepCheckPreambula:
-        if(level) {
-            if((DURATION_DIFF(duration, subghz_protocol_bmw_const.te_short) <
-                subghz_protocol_bmw_const.te_delta) ||
-               (DURATION_DIFF(duration, subghz_protocol_bmw_const.te_long) <
-                subghz_protocol_bmw_const.te_delta)) {
-                instance->decoder.te_last = duration;
-            } else {
-                instance->decoder.parser_step = BMWDecoderStepReset;
-            }
-        } else if(
-            (DURATION_DIFF(duration, subghz_protocol_bmw_const.te_short) <
-             subghz_protocol_bmw_const.te_delta) &&
-            (DURATION_DIFF(instance->decoder.te_last, subghz_protocol_bmw_const.te_short) <
-             subghz_protocol_bmw_const.te_delta)) {
-            instance->header_count++;
-        } else if(
-            (DURATION_DIFF(duration, subghz_protocol_bmw_const.te_long) <
-             subghz_protocol_bmw_const.te_delta) &&
-            (DURATION_DIFF(instance->decoder.te_last, subghz_protocol_bmw_const.te_long) <
-             subghz_protocol_bmw_const.te_delta)) {
-            if(instance->header_count > 15) {
-                instance->decoder.parser_step = BMWDecoderStepSaveDuration;
-                instance->decoder.decode_data = 0ULL;
-                instance->decoder.decode_count_bit = 0;
-            } else {
-                instance->decoder.parser_step = BMWDecoderStepReset;
-            }
-        } else {
-            instance->decoder.parser_step = BMWDecoderStepReset;
-        }
-        break;
-
-    case BMWDecoderStepSaveDuration:
-        if(level) {
-            if(duration >=
-               (subghz_protocol_bmw_const.te_long + subghz_protocol_bmw_const.te_delta * 2UL)) {
-                if(instance->decoder.decode_count_bit >=
-                   subghz_protocol_bmw_const.min_count_bit_for_found) {
-                    instance->generic.data = instance->decoder.decode_data;
-                    instance->generic.data_count_bit = instance->decoder.decode_count_bit;
-
-                    // Perform CRC check with both CRC8 and CRC16
-                    uint8_t* raw_bytes = (uint8_t*)&instance->generic.data;
-                    size_t raw_len = (instance->generic.data_count_bit + 7) / 8;
-                    uint8_t crc8 = subghz_protocol_bmw_crc8(raw_bytes, raw_len - 1);
-                    if(crc8 == raw_bytes[raw_len - 1]) {
-                        instance->crc_type = 8;
-                    } else {
-                        uint16_t crc16 = subghz_protocol_bmw_crc16(raw_bytes, raw_len - 2);
-                        uint16_t rx_crc16 = (raw_bytes[raw_len - 2] << 8) | raw_bytes[raw_len - 1];
-                        if(crc16 == rx_crc16) {
-                            instance->crc_type = 16;
-                        } else {
-                            instance->crc_type = 0; // invalid
-                        }
-                    }
-
-                    if(instance->crc_type != 0 && instance->base.callback) {
-                        instance->base.callback(&instance->base, instance->base.context);
-                    }
-                }
-                subghz_protocol_decoder_bmw_reset_internal(instance);
-            } else {
-                instance->decoder.te_last = duration;
-                instance->decoder.parser_step = BMWDecoderStepCheckDuration;
-            }
+    uint8_t* raw_bytes = (uint8_t*)&instance->generic.data;
+    size_t raw_len = (instance->generic.data_count_bit + 7) / 8;
+    uint8_t crc8 = subghz_protocol_bmw_crc8(raw_bytes, raw_len - 1);
+    if(crc8 == raw_bytes[raw_len - 1]) {
+        instance->crc_type = 8;
+    } else {
+        uint16_t crc16 = subghz_protocol_bmw_crc16(raw_bytes, raw_len - 2);
+        uint16_t rx_crc16 = (raw_bytes[raw_len - 2] << 8) | raw_bytes[raw_len - 1];
+        if(crc16 == rx_crc16) {
+            instance->crc_type = 16;
         } else {
-            instance->decoder.parser_step = BMWDecoderStepReset;
+            instance->crc_type = 0; // invalid
         }
-        break;
-
-    case BMWDecoderStepCheckDuration:
-        if(!level) {
-            if((DURATION_DIFF(instance->decoder.te_last, subghz_protocol_bmw_const.te_short) <
-                subghz_protocol_bmw_const.te_delta) &&
-               (DURATION_DIFF(duration, subghz_protocol_bmw_const.te_short) <
-                subghz_protocol_bmw_const.te_delta)) {
-                subghz_protocol_blocks_add_bit(&instance->decoder, 0);
-                instance->decoder.parser_step = BMWDecoderStepSaveDuration;
-            } else if(
-                (DURATION_DIFF(instance->decoder.te_last, subghz_protocol_bmw_const.te_long) <
-                 subghz_protocol_bmw_const.te_delta) &&
-                (DURATION_DIFF(duration, subghz_protocol_bmw_const.te_long) <
-                 subghz_protocol_bmw_const.te_delta)) {
-                subghz_protocol_blocks_add_bit(&instance->decoder, 1);
-                instance->decoder.parser_step = BMWDecoderStepSaveDuration;
-            } else {
-                instance->decoder.parser_step = BMWDecoderStepReset;
-            }
-        } else {
-            instance->decoder.parser_step = BMWDecoderStepReset;
-        }
-        break;
     }
+    return instance->crc_type != 0;
+}
+
+// Short pairs, a long pair as sync, then short-short 0 and long-long 1
+static const ProtoPiratePwm bmw_pwm = {
+    .block_const = &subghz_protocol_bmw_const,
+    .trace = ProtoPirateTraceProtocolBmw,
+    .preamble_long = true,
+    .sync = PROTOPIRATE_PWM_LONG(subghz_protocol_bmw_const),
+    .sync_after_long = true,
+    .sync_header_count = 16,
+    .zero =
+        {
+            .high = ProtoPiratePulseClassShort,
+            .low = ProtoPiratePulseClassShort,
+        },
+    .one =
+        {
+            .high = ProtoPiratePulseClassLong,
+            .low = ProtoPiratePulseClassLong,
+        },
+    .end = subghz_protocol_bmw_const.te_long + subghz_protocol_bmw_const.te_delta * 2UL,
+    .frame = subghz_protocol_bmw_check_crc,
+};
+
+void subghz_protocol_decoder_bmw_feed(void* context, bool level, uint32_t duration) {
+    protopirate_pwm_feed(&bmw_pwm, context, level, duration);
+}
+
+void subghz_protocol_decoder_bmw_feed_pulse(void* context, ProtoPiratePulse pulse) {
+    protopirate_pwm_feed_pulse(&bmw_pwm, context, pulse);
 }
 
 // ----------------- Utils -------------------
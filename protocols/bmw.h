@@ -10,15 +10,18 @@
 #include <lib/subghz/blocks/math.h>
 #include <flipper_format/flipper_format.h>
 #include <lib/toolbox/manchester_decoder.h>
+#include "../helpers/protopirate_entry.h"
 
 #define BMW_PROTOCOL_NAME "BMW"
 
 extern const SubGhzProtocol bmw_protocol;
+extern const ProtoPirateEntry bmw_protocol_entry;
 
 void* subghz_protocol_decoder_bmw_alloc(SubGhzEnvironment* environment);
 void subghz_protocol_decoder_bmw_free(void* context);
 void subghz_protocol_decoder_bmw_reset(void* context);
 void subghz_protocol_decoder_bmw_feed(void* context, bool level, uint32_t duration);
+void subghz_protocol_decoder_bmw_feed_pulse(void* context, ProtoPiratePulse pulse);
 uint8_t subghz_protocol_decoder_bmw_get_hash_data(void* context);
 SubGhzProtocolStatus subghz_protocol_decoder_bmw_serialize(
     void* context,
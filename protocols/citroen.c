@@ -1,4 +1,5 @@
 #include "citroen.h"
+#include "../helpers/protopirate_pwm.h"
 
 #define TAG "SubGhzProtocolCitroen"
 
@@ -14,6 +15,7 @@ typedef struct SubGhzProtocolDecoderCitroen {
     SubGhzBlockDecoder decoder;
     SubGhzBlockGeneric generic;
     uint16_t header_count;
+    uint8_t high_class;
     uint8_t packet_count;
 } SubGhzProtocolDecoderCitroen;
 
@@ -23,17 +25,11 @@ typedef struct SubGhzProtocolEncoderCitroen {
     SubGhzBlockGeneric generic;
 } SubGhzProtocolEncoderCitroen;
 
-typedef enum {
-    CitroenDecoderStepReset = 0,
-    CitroenDecoderStepCheckPreamble,
-    CitroenDecoderStepSaveDuration,
-    CitroenDecoderStepCheckDuration,
-} CitroenDecoderStep;
-
 static void subghz_protocol_decoder_citroen_reset_internal(SubGhzProtocolDecoderCitroen* instance) {
     memset(&instance->decoder, 0, sizeof(instance->decoder));
     memset(&instance->generic, 0, sizeof(instance->generic));
-    instance->decoder.parser_step = CitroenDecoderStepReset;
+    instance->generic.protocol_name = instance->base.protocol->name;
+    instance->decoder.parser_step = ProtoPiratePwmStepReset;
     instance->header_count = 0;
     instance->packet_count = 0;
 }
@@ -69,6 +65,14 @@ const SubGhzProtocol citroen_protocol = {
     .encoder = &subghz_protocol_citroen_encoder,
 };
 
+const ProtoPirateEntry citroen_protocol_entry = {
+    .block_const = &subghz_protocol_citroen_const,
+    .decoder_size = sizeof(SubGhzProtocolDecoderCitroen),
+    .te = ProtoPirateEntryTeShort,
+    .level = ProtoPirateEntryLevelHigh,
+    .feed_pulse = subghz_protocol_decoder_citroen_feed_pulse,
+};
+
 // ----------------- Allocation / Reset / Free -------------------
 
 void* subghz_protocol_decoder_citroen_alloc(SubGhzEnvironment* environment) {
@@ -101,7 +105,8 @@ static uint8_t reverse8(uint8_t byte) {
 }
 
 // Parse Citroën/PSA data structure
-static bool subghz_protocol_citroen_parse_data(SubGhzProtocolDecoderCitroen* instance) {
+static bool subghz_protocol_citroen_parse_data(void* context) {
+    SubGhzProtocolDecoderCitroen* instance = context;
     uint8_t* b = (uint8_t*)&instance->generic.data;
     
     // PSA structure (similar to Peugeot Keeloq)
@@ -130,102 +135,38 @@ static bool subghz_protocol_citroen_parse_data(SubGhzProtocolDecoderCitroen* ins
     instance->generic.btn = button_bits;
     instance->generic.cnt = (encrypted >> 16) & 0xFFFF; // Counter
     
+    instance->packet_count++;
     return true;
 }
 
 // ----------------- Decoder Feed -------------------
 
+// Warm-up of short pairs, a ~4400 us low, then short-long 0 and long-short 1
+static const ProtoPiratePwm citroen_pwm = {
+    .block_const = &subghz_protocol_citroen_const,
+    .trace = ProtoPirateTraceProtocolCitroen,
+    .sync = PROTOPIRATE_PWM_WINDOW(4400, 500),
+    .sync_header_count = 10,
+    .zero =
+        {
+            .high = ProtoPiratePulseClassShort,
+            .low = ProtoPiratePulseClassLong,
+        },
+    .one =
+        {
+            .high = ProtoPiratePulseClassLong,
+            .low = ProtoPiratePulseClassShort,
+        },
+    .end = subghz_protocol_citroen_const.te_long * 3,
+    .frame = subghz_protocol_citroen_parse_data,
+};
+
 void subghz_protocol_decoder_citroen_feed(void* context, bool level, uint32_t duration) {
-    furi_assert(context);
-    SubGhzProtocolDecoderCitroen* instance = context;
+    protopirate_pwm_feed(&citroen_pwm, context, level, duration);
+}
 
-    switch(instance->decoder.parser_step) {
-    case CitroenDecoderStepReset:
-        if(level && (DURATION_DIFF(duration, subghz_protocol_citroen_const.te_short) <
-                     subghz_protocol_citroen_const.te_delta)) {
-            instance->decoder.parser_step = CitroenDecoderStepCheckPreamble;
-            instance->decoder.te_last = duration;
-            instance->header_count = 0;
-            instance->decoder.decode_data = 0;
-            instance->decoder.decode_count_bit = 0;
-        }
-        break;
-
-    case CitroenDecoderStepCheckPreamble:
-        if(level) {
-            if((DURATION_DIFF(duration, subghz_protocol_citroen_const.te_short) <
-                subghz_protocol_citroen_const.te_delta)) {
-                instance->decoder.te_last = duration;
-            } else {
-                instance->decoder.parser_step = CitroenDecoderStepReset;
-            }
-        } else {
-            if((DURATION_DIFF(duration, subghz_protocol_citroen_const.te_short) <
-                subghz_protocol_citroen_const.te_delta) &&
-               (DURATION_DIFF(instance->decoder.te_last, subghz_protocol_citroen_const.te_short) <
-                subghz_protocol_citroen_const.te_delta)) {
-                instance->header_count++;
-            } else if((DURATION_DIFF(duration, 4400) < 500) && instance->header_count >= 10) {
-                instance->decoder.parser_step = CitroenDecoderStepSaveDuration;
-                instance->decoder.decode_data = 0ULL;
-                instance->decoder.decode_count_bit = 0;
-            } else {
-                instance->decoder.parser_step = CitroenDecoderStepReset;
-            }
-        }
-        break;
-
-    case CitroenDecoderStepSaveDuration:
-        if(level) {
-            if(duration >= (subghz_protocol_citroen_const.te_long * 3)) {
-                if(instance->decoder.decode_count_bit >= 
-                   subghz_protocol_citroen_const.min_count_bit_for_found) {
-                    
-                    instance->generic.data = instance->decoder.decode_data;
-                    instance->generic.data_count_bit = instance->decoder.decode_count_bit;
-
-                    if(subghz_protocol_citroen_parse_data(instance)) {
-                        instance->packet_count++;
-                        
-                        if(instance->base.callback) {
-                            instance->base.callback(&instance->base, instance->base.context);
-                        }
-                    }
-                }
-                subghz_protocol_decoder_citroen_reset_internal(instance);
-            } else {
-                instance->decoder.te_last = duration;
-                instance->decoder.parser_step = CitroenDecoderStepCheckDuration;
-            }
-        } else {
-            instance->decoder.parser_step = CitroenDecoderStepReset;
-        }
-        break;
-
-    case CitroenDecoderStepCheckDuration:
-        if(!level) {
-            // PWM decoding
-            if((DURATION_DIFF(instance->decoder.te_last, subghz_protocol_citroen_const.te_short) <
-                subghz_protocol_citroen_const.te_delta) &&
-               (DURATION_DIFF(duration, subghz_protocol_citroen_const.te_long) <
-                subghz_protocol_citroen_const.te_delta)) {
-                subghz_protocol_blocks_add_bit(&instance->decoder, 0);
-                instance->decoder.parser_step = CitroenDecoderStepSaveDuration;
-            } else if(
-                (DURATION_DIFF(instance->decoder.te_last, subghz_protocol_citroen_const.te_long) <
-                 subghz_protocol_citroen_const.te_delta) &&
-                (DURATION_DIFF(duration, subghz_protocol_citroen_const.te_short) <
-                 subghz_protocol_citroen_const.te_delta)) {
-                subghz_protocol_blocks_add_bit(&instance->decoder, 1);
-                instance->decoder.parser_step = CitroenDecoderStepSaveDuration;
-            } else {
-                instance->decoder.parser_step = CitroenDecoderStepReset;
-            }
-        } else {
-            instance->decoder.parser_step = CitroenDecoderStepReset;
-        }
-        break;
-    }
+void subghz_protocol_decoder_citroen_feed_pulse(void* context, ProtoPiratePulse pulse) {
+    protopirate_pwm_feed_pulse(&citroen_pwm, context, pulse);
 }
 
 // ----------------- API -------------------
@@ -9,15 +9,18 @@
 #include <lib/subghz/blocks/generic.h>
 #include <lib/subghz/blocks/math.h>
 #include <flipper_format/flipper_format.h>
+#include "../helpers/protopirate_entry.h"
 
 #define CITROEN_PROTOCOL_NAME "Citroen"
 
 extern const SubGhzProtocol citroen_protocol;
+extern const ProtoPirateEntry citroen_protocol_entry;
 
 void* subghz_protocol_decoder_citroen_alloc(SubGhzEnvironment* environment);
 void subghz_protocol_decoder_citroen_free(void* context);
 void subghz_protocol_decoder_citroen_reset(void* context);
 void subghz_protocol_decoder_citroen_feed(void* context, bool level, uint32_t duration);
+void subghz_protocol_decoder_citroen_feed_pulse(void* context, ProtoPiratePulse pulse);
 uint8_t subghz_protocol_decoder_citroen_get_hash_data(void* context);
 SubGhzProtocolStatus subghz_protocol_decoder_citroen_serialize(
     void* context,
@@ -1,5 +1,6 @@
 #include "fiat_v0.h"
-#include <lib/toolbox/manchester_decoder.h>
+#include "../helpers/protopirate_trace.h"
+#include "../helpers/protopirate_manchester.h"
 
 #define TAG "FiatProtocolV0"
 
@@ -10,12 +11,17 @@ static const SubGhzBlockConst subghz_protocol_fiat_v0_const = {
     .min_count_bit_for_found = 64,
 };
 
+static const ProtoPirateManchester fiat_v0_manchester = {
+    .block_const = &subghz_protocol_fiat_v0_const,
+    .coding = ProtoPirateManchesterCodingMid,
+    .start = ManchesterStateMid1,
+};
+
 struct SubGhzProtocolDecoderFiatV0 {
     SubGhzProtocolDecoderBase base;
     SubGhzBlockDecoder decoder;
     SubGhzBlockGeneric generic;
     ManchesterState manchester_state;
-    uint8_t decoder_state;
     uint16_t preamble_count;
     uint32_t data_low;
     uint32_t data_high;
@@ -66,6 +72,19 @@ const SubGhzProtocol fiat_protocol_v0 = {
     .encoder = &subghz_protocol_fiat_v0_encoder,
 };
 
+static uint64_t fiat_v0_key_extra(const void* context) {
+    const SubGhzProtocolDecoderFiatV0* instance = context;
+    return instance->endbyte;
+}
+
+const ProtoPirateEntry fiat_protocol_v0_entry = {
+    .block_const = &subghz_protocol_fiat_v0_const,
+    .decoder_size = sizeof(SubGhzProtocolDecoderFiatV0),
+    .te = ProtoPirateEntryTeShort,
+    .level = ProtoPirateEntryLevelHigh,
+    .key_extra = fiat_v0_key_extra,
+};
+
 void* subghz_protocol_decoder_fiat_v0_alloc(SubGhzEnvironment* environment) {
     UNUSED(environment);
     SubGhzProtocolDecoderFiatV0* instance = malloc(sizeof(SubGhzProtocolDecoderFiatV0));
@@ -84,7 +103,6 @@ void subghz_protocol_decoder_fiat_v0_reset(void* context) {
     furi_assert(context);
     SubGhzProtocolDecoderFiatV0* instance = context;
     instance->decoder.parser_step = FiatV0DecoderStepReset;
-    instance->decoder_state = 0;
     instance->preamble_count = 0;
     instance->data_low = 0;
     instance->data_high = 0;
@@ -101,11 +119,10 @@ void subghz_protocol_decoder_fiat_v0_feed(void* context, bool level, uint32_t du
     furi_assert(context);
     SubGhzProtocolDecoderFiatV0* instance = context;
     uint32_t te_short = (uint32_t)subghz_protocol_fiat_v0_const.te_short;
-    uint32_t te_long = (uint32_t)subghz_protocol_fiat_v0_const.te_long;
     uint32_t te_delta = (uint32_t)subghz_protocol_fiat_v0_const.te_delta;
     uint32_t gap_threshold = 800;
     uint32_t diff;
-    switch(instance->decoder_state) {
+    switch(instance->decoder.parser_step) {
     case FiatV0DecoderStepReset:
         if(!level) {
             return;
@@ -118,15 +135,11 @@ void subghz_protocol_decoder_fiat_v0_feed(void* context, bool level, uint32_t du
         if(diff < te_delta) {
             instance->data_low = 0;
             instance->data_high = 0;
-            instance->decoder_state = FiatV0DecoderStepPreamble;
+            instance->decoder.parser_step = FiatV0DecoderStepPreamble;
             instance->te_last = duration;
             instance->preamble_count = 0;
             instance->bit_count = 0;
-            manchester_advance(
-                instance->manchester_state,
-                ManchesterEventReset,
-                &instance->manchester_state,
-                NULL);
+            instance->manchester_state = fiat_v0_manchester.start;
         }
         break;
     case FiatV0DecoderStepPreamble:
@@ -145,17 +158,23 @@ void subghz_protocol_decoder_fiat_v0_feed(void* context, bool level, uint32_t du
                         diff = duration - gap_threshold;
                     }
                     if(diff < te_delta) {
-                        instance->decoder_state = FiatV0DecoderStepData;
+                        instance->decoder.parser_step = FiatV0DecoderStepData;
                         instance->preamble_count = 0;
                         instance->data_low = 0;
                         instance->data_high = 0;
                         instance->bit_count = 0;
                         instance->te_last = duration;
+                        PROTOPIRATE_TRACE_EVENT(
+                            ProtoPirateTraceProtocolFiatV0,
+                            ProtoPirateTraceEventSync,
+                            FiatV0DecoderStepPreamble,
+                            0,
+                            duration);
                         return;
                     }
                 }
             } else {
-                instance->decoder_state = FiatV0DecoderStepReset;
+                instance->decoder.parser_step = FiatV0DecoderStepReset;
                 if(instance->preamble_count >= 0x96) {
                     if(duration < gap_threshold) {
                         diff = gap_threshold - duration;
@@ -163,12 +182,18 @@ void subghz_protocol_decoder_fiat_v0_feed(void* context, bool level, uint32_t du
                         diff = duration - gap_threshold;
                     }
                     if(diff < te_delta) {
-                        instance->decoder_state = FiatV0DecoderStepData;
+                        instance->decoder.parser_step = FiatV0DecoderStepData;
                         instance->preamble_count = 0;
                         instance->data_low = 0;
                         instance->data_high = 0;
                         instance->bit_count = 0;
                         instance->te_last = duration;
+                        PROTOPIRATE_TRACE_EVENT(
+                            ProtoPirateTraceProtocolFiatV0,
+                            ProtoPirateTraceEventSync,
+                            FiatV0DecoderStepPreamble,
+                            0,
+                            duration);
                         return;
                     }
                 }
@@ -179,7 +204,7 @@ void subghz_protocol_decoder_fiat_v0_feed(void* context, bool level, uint32_t du
                 instance->preamble_count++;
                 instance->te_last = duration;
             } else {
-                instance->decoder_state = FiatV0DecoderStepReset;
+                instance->decoder.parser_step = FiatV0DecoderStepReset;
             }
             if(instance->preamble_count >= 0x96) {
                 if(duration >= 799) {
@@ -188,47 +213,31 @@ void subghz_protocol_decoder_fiat_v0_feed(void* context, bool level, uint32_t du
                     diff = gap_threshold - duration;
                 }
                 if(diff < te_delta) {
-                    instance->decoder_state = FiatV0DecoderStepData;
+                    instance->decoder.parser_step = FiatV0DecoderStepData;
                     instance->preamble_count = 0;
                     instance->data_low = 0;
                     instance->data_high = 0;
                     instance->bit_count = 0;
                     instance->te_last = duration;
+                    PROTOPIRATE_TRACE_EVENT(
+                        ProtoPirateTraceProtocolFiatV0,
+                        ProtoPirateTraceEventSync,
+                        FiatV0DecoderStepPreamble,
+                        0,
+                        duration);
                     return;
                 }
             }
         }
         break;
     case FiatV0DecoderStepData:
-        ManchesterEvent event = ManchesterEventReset;
-        if(duration < te_short) {
-            diff = te_short - duration;
-            if(diff < te_delta) {
-                event = level ? ManchesterEventShortLow : ManchesterEventShortHigh;
-            }
-        } else {
-            diff = duration - te_short;
-            if(diff < te_delta) {
-                event = level ? ManchesterEventShortLow : ManchesterEventShortHigh;
-            } else {
-                if(duration < te_long) {
-                    diff = te_long - duration;
-                } else {
-                    diff = duration - te_long;
-                }
-                if(diff < te_delta) {
-                    event = level ? ManchesterEventLongLow : ManchesterEventLongHigh;
-                }
-            }
-        }
+        ProtoPirateManchesterEvent event =
+            protopirate_manchester_event(&fiat_v0_manchester, level, duration);
 
-        if(event != ManchesterEventReset) {
+        if(event != ProtoPirateManchesterEventNone) {
             bool data_bit_bool;
-            if(manchester_advance(
-                   instance->manchester_state,
-                   event,
-                   &instance->manchester_state,
-                   &data_bit_bool)) {
+            if(protopirate_manchester_advance(
+                   &fiat_v0_manchester, &instance->manchester_state, event, &data_bit_bool)) {
                 uint32_t new_bit = data_bit_bool ? 1 : 0;
 
                 uint32_t carry = (instance->data_low >> 31) & 1;
@@ -256,6 +265,12 @@ void subghz_protocol_decoder_fiat_v0_feed(void* context, bool level, uint32_t du
                         instance->endbyte; // still exported as btn for UI compatibility
                     instance->generic.cnt = instance->hop;
 
+                    PROTOPIRATE_TRACE_EVENT(
+                        ProtoPirateTraceProtocolFiatV0,
+                        ProtoPirateTraceEventDecoded,
+                        FiatV0DecoderStepData,
+                        instance->final_count,
+                        duration);
                     if(instance->base.callback) {
                         instance->base.callback(&instance->base, instance->base.context);
                     }
@@ -263,7 +278,7 @@ void subghz_protocol_decoder_fiat_v0_feed(void* context, bool level, uint32_t du
                     instance->data_low = 0;
                     instance->data_high = 0;
                     instance->bit_count = 0;
-                    instance->decoder_state = FiatV0DecoderStepReset;
+                    instance->decoder.parser_step = FiatV0DecoderStepReset;
                 }
             }
         }
@@ -9,12 +9,14 @@
 #include <lib/subghz/blocks/math.h>
 #include <lib/toolbox/manchester_decoder.h>
 #include <flipper_format/flipper_format.h>
+#include "../helpers/protopirate_entry.h"
 
 #define FIAT_PROTOCOL_V0_NAME "Fiat V0"
 
 typedef struct SubGhzProtocolDecoderFiatV0 SubGhzProtocolDecoderFiatV0;
 
 extern const SubGhzProtocol fiat_protocol_v0;
+extern const ProtoPirateEntry fiat_protocol_v0_entry;
 
 void* subghz_protocol_decoder_fiat_v0_alloc(SubGhzEnvironment* environment);
 void subghz_protocol_decoder_fiat_v0_free(void* context);
@@ -1,4 +1,6 @@
 #include "ford_v0.h"
+#include "../helpers/protopirate_trace.h"
+#include "../helpers/protopirate_manchester.h"
 
 #define TAG "FordProtocolV0"
 
@@ -9,6 +11,12 @@ static const SubGhzBlockConst subghz_protocol_ford_v0_const = {
     .min_count_bit_for_found = 64,
 };
 
+static const ProtoPirateManchester ford_v0_manchester = {
+    .block_const = &subghz_protocol_ford_v0_const,
+    .coding = ProtoPirateManchesterCodingMid,
+    .start = ManchesterStateMid1,
+};
+
 typedef struct SubGhzProtocolDecoderFordV0
 {
     SubGhzProtocolDecoderBase base;
@@ -78,6 +86,20 @@ const SubGhzProtocol ford_protocol_v0 = {
     .encoder = &subghz_protocol_ford_v0_encoder,
 };
 
+static uint64_t ford_v0_key_extra(const void *context)
+{
+    const SubGhzProtocolDecoderFordV0 *instance = context;
+    return instance->key2;
+}
+
+const ProtoPirateEntry ford_protocol_v0_entry = {
+    .block_const = &subghz_protocol_ford_v0_const,
+    .decoder_size = sizeof(SubGhzProtocolDecoderFordV0),
+    .te = ProtoPirateEntryTeShort,
+    .level = ProtoPirateEntryLevelHigh,
+    .key_extra = ford_v0_key_extra,
+};
+
 static void ford_v0_add_bit(SubGhzProtocolDecoderFordV0 *instance, bool bit)
 {
     uint32_t low = (uint32_t)instance->data_low;
@@ -234,7 +256,7 @@ void subghz_protocol_decoder_ford_v0_feed(void *context, bool level, uint32_t du
             instance->decoder.te_last = duration;
             instance->header_count = 0;
             instance->bit_count = 0;
-            manchester_advance(instance->manchester_state, ManchesterEventReset, &instance->manchester_state, NULL);
+            instance->manchester_state = ford_v0_manchester.start;
         }
         break;
 
@@ -280,6 +302,12 @@ void subghz_protocol_decoder_ford_v0_feed(void *context, bool level, uint32_t du
             instance->data_high = 0;
             instance->bit_count = 1;
             instance->decoder.parser_step = FordV0DecoderStepData;
+            PROTOPIRATE_TRACE_EVENT(
+                ProtoPirateTraceProtocolFordV0,
+                ProtoPirateTraceEventSync,
+                FordV0DecoderStepGap,
+                instance->header_count,
+                duration);
         }
         else if (!level && duration > gap_threshold + 250)
         {
@@ -289,24 +317,23 @@ void subghz_protocol_decoder_ford_v0_feed(void *context, bool level, uint32_t du
 
     case FordV0DecoderStepData:
     {
-        ManchesterEvent event;
+        ProtoPirateManchesterEvent event =
+            protopirate_manchester_event(&ford_v0_manchester, level, duration);
 
-        if (DURATION_DIFF(duration, te_short) < te_delta)
-        {
-            event = level ? ManchesterEventShortLow : ManchesterEventShortHigh;
-        }
-        else if (DURATION_DIFF(duration, te_long) < te_delta)
-        {
-            event = level ? ManchesterEventLongLow : ManchesterEventLongHigh;
-        }
-        else
+        if (event == ProtoPirateManchesterEventNone)
         {
+            PROTOPIRATE_TRACE_EVENT(
+                ProtoPirateTraceProtocolFordV0,
+                ProtoPirateTraceEventMismatch,
+                FordV0DecoderStepData,
+                instance->bit_count,
+                duration);
             instance->decoder.parser_step = FordV0DecoderStepReset;
             break;
         }
 
         bool data_bit;
-        if (manchester_advance(instance->manchester_state, event, &instance->manchester_state, &data_bit))
+        if (protopirate_manchester_advance(&ford_v0_manchester, &instance->manchester_state, event, &data_bit))
         {
             ford_v0_add_bit(instance, data_bit);
 
@@ -318,6 +345,13 @@ void subghz_protocol_decoder_ford_v0_feed(void *context, bool level, uint32_t du
                 instance->generic.btn = instance->button;
                 instance->generic.cnt = instance->count;
 
+                PROTOPIRATE_TRACE_EVENT(
+                    ProtoPirateTraceProtocolFordV0,
+                    ProtoPirateTraceEventDecoded,
+                    FordV0DecoderStepData,
+                    instance->bit_count,
+                    duration);
+
                 if (instance->base.callback)
                 {
                     instance->base.callback(&instance->base, instance->base.context);
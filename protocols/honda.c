@@ -1,4 +1,5 @@
 #include "honda.h"
+#include "../helpers/protopirate_pwm.h"
 
 #define TAG "SubGhzProtocolHonda"
 
@@ -14,6 +15,7 @@ typedef struct SubGhzProtocolDecoderHonda {
     SubGhzBlockDecoder decoder;
     SubGhzBlockGeneric generic;
     uint16_t header_count;
+    uint8_t high_class;
 } SubGhzProtocolDecoderHonda;
 
 typedef struct SubGhzProtocolEncoderHonda {
@@ -22,17 +24,11 @@ typedef struct SubGhzProtocolEncoderHonda {
     SubGhzBlockGeneric generic;
 } SubGhzProtocolEncoderHonda;
 
-typedef enum {
-    HondaDecoderStepReset = 0,
-    HondaDecoderStepCheckPreamble,
-    HondaDecoderStepSaveDuration,
-    HondaDecoderStepCheckDuration,
-} HondaDecoderStep;
-
 static void subghz_protocol_decoder_honda_reset_internal(SubGhzProtocolDecoderHonda* instance) {
     memset(&instance->decoder, 0, sizeof(instance->decoder));
     memset(&instance->generic, 0, sizeof(instance->generic));
-    instance->decoder.parser_step = HondaDecoderStepReset;
+    instance->generic.protocol_name = instance->base.protocol->name;
+    instance->decoder.parser_step = ProtoPiratePwmStepReset;
     instance->header_count = 0;
 }
 
@@ -67,6 +63,14 @@ const SubGhzProtocol honda_protocol = {
     .encoder = &subghz_protocol_honda_encoder,
 };
 
+const ProtoPirateEntry honda_protocol_entry = {
+    .block_const = &subghz_protocol_honda_const,
+    .decoder_size = sizeof(SubGhzProtocolDecoderHonda),
+    .te = ProtoPirateEntryTeShort,
+    .level = ProtoPirateEntryLevelHigh,
+    .feed_pulse = subghz_protocol_decoder_honda_feed_pulse,
+};
+
 // ----------------- Allocation / Reset / Free -------------------
 
 void* subghz_protocol_decoder_honda_alloc(SubGhzEnvironment* environment) {
@@ -91,7 +95,8 @@ void subghz_protocol_decoder_honda_reset(void* context) {
 
 // ----------------- Honda Protocol Parsing -------------------
 
-static bool subghz_protocol_honda_parse_data(SubGhzProtocolDecoderHonda* instance) {
+static bool subghz_protocol_honda_parse_data(void* context) {
+    SubGhzProtocolDecoderHonda* instance = context;
     uint8_t* b = (uint8_t*)&instance->generic.data;
     
     // Honda protocol structure (from rtl_433):
@@ -122,103 +127,32 @@ static bool subghz_protocol_honda_parse_data(SubGhzProtocolDecoderHonda* instanc
 
 // ----------------- Decoder Feed -------------------
 
-void subghz_protocol_decoder_honda_feed(void* context, bool level, uint32_t duration) {
-    furi_assert(context);
-    SubGhzProtocolDecoderHonda* instance = context;
-
-    switch(instance->decoder.parser_step) {
-    case HondaDecoderStepReset:
-        if(level && (DURATION_DIFF(duration, subghz_protocol_honda_const.te_short) <
-                     subghz_protocol_honda_const.te_delta)) {
-            instance->decoder.parser_step = HondaDecoderStepCheckPreamble;
-            instance->decoder.te_last = duration;
-            instance->header_count = 0;
-            instance->decoder.decode_data = 0;
-            instance->decoder.decode_count_bit = 0;
-        }
-        break;
-
-    case HondaDecoderStepCheckPreamble:
-        if(level) {
-            if((DURATION_DIFF(duration, subghz_protocol_honda_const.te_short) <
-                subghz_protocol_honda_const.te_delta)) {
-                instance->decoder.te_last = duration;
-            } else {
-                instance->decoder.parser_step = HondaDecoderStepReset;
-            }
-        } else {
-            // Looking for preamble pattern
-            if((DURATION_DIFF(duration, subghz_protocol_honda_const.te_short) <
-                subghz_protocol_honda_const.te_delta) &&
-               (DURATION_DIFF(instance->decoder.te_last, subghz_protocol_honda_const.te_short) <
-                subghz_protocol_honda_const.te_delta)) {
-                instance->header_count++;
-            } else if((DURATION_DIFF(duration, subghz_protocol_honda_const.te_long) <
-                       subghz_protocol_honda_const.te_delta * 2) && 
-                      instance->header_count >= 10) {
-                // Long gap after preamble - start of data
-                instance->decoder.parser_step = HondaDecoderStepSaveDuration;
-                instance->decoder.decode_data = 0ULL;
-                instance->decoder.decode_count_bit = 0;
-            } else {
-                instance->decoder.parser_step = HondaDecoderStepReset;
-            }
-        }
-        break;
-
-    case HondaDecoderStepSaveDuration:
-        if(level) {
-            if(duration >= (subghz_protocol_honda_const.te_long * 3)) {
-                // End of transmission
-                if(instance->decoder.decode_count_bit >= 
-                   subghz_protocol_honda_const.min_count_bit_for_found) {
-                    
-                    instance->generic.data = instance->decoder.decode_data;
-                    instance->generic.data_count_bit = instance->decoder.decode_count_bit;
+// Short pairs, a long-ish low, then short-long 0 and long-short 1
+static const ProtoPiratePwm honda_pwm = {
+    .block_const = &subghz_protocol_honda_const,
+    .trace = ProtoPirateTraceProtocolHonda,
+    .sync = PROTOPIRATE_PWM_WINDOW(subghz_protocol_honda_const.te_long, subghz_protocol_honda_const.te_delta * 2),
+    .sync_header_count = 10,
+    .zero =
+        {
+            .high = ProtoPiratePulseClassShort,
+            .low = ProtoPiratePulseClassLong,
+        },
+    .one =
+        {
+            .high = ProtoPiratePulseClassLong,
+            .low = ProtoPiratePulseClassShort,
+        },
+    .end = subghz_protocol_honda_const.te_long * 3,
+    .frame = subghz_protocol_honda_parse_data,
+};
 
-                    // Parse Honda protocol structure
-                    if(subghz_protocol_honda_parse_data(instance)) {
-                        if(instance->base.callback) {
-                            instance->base.callback(&instance->base, instance->base.context);
-                        }
-                    }
-                }
-                subghz_protocol_decoder_honda_reset_internal(instance);
-            } else {
-                instance->decoder.te_last = duration;
-                instance->decoder.parser_step = HondaDecoderStepCheckDuration;
-            }
-        } else {
-            instance->decoder.parser_step = HondaDecoderStepReset;
-        }
-        break;
+void subghz_protocol_decoder_honda_feed(void* context, bool level, uint32_t duration) {
+    protopirate_pwm_feed(&honda_pwm, context, level, duration);
+}
 
-    case HondaDecoderStepCheckDuration:
-        if(!level) {
-            // Manchester decoding (differential)
-            if((DURATION_DIFF(instance->decoder.te_last, subghz_protocol_honda_const.te_short) <
-                subghz_protocol_honda_const.te_delta) &&
-               (DURATION_DIFF(duration, subghz_protocol_honda_const.te_long) <
-                subghz_protocol_honda_const.te_delta)) {
-                // Short-Long = 0
-                subghz_protocol_blocks_add_bit(&instance->decoder, 0);
-                instance->decoder.parser_step = HondaDecoderStepSaveDuration;
-            } else if(
-                (DURATION_DIFF(instance->decoder.te_last, subghz_protocol_honda_const.te_long) <
-                 subghz_protocol_honda_const.te_delta) &&
-                (DURATION_DIFF(duration, subghz_protocol_honda_const.te_short) <
-                 subghz_protocol_honda_const.te_delta)) {
-                // Long-Short = 1
-                subghz_protocol_blocks_add_bit(&instance->decoder, 1);
-                instance->decoder.parser_step = HondaDecoderStepSaveDuration;
-            } else {
-                instance->decoder.parser_step = HondaDecoderStepReset;
-            }
-        } else {
-            instance->decoder.parser_step = HondaDecoderStepReset;
-        }
-        break;
-    }
+void subghz_protocol_decoder_honda_feed_pulse(void* context, ProtoPiratePulse pulse) {
+    protopirate_pwm_feed_pulse(&honda_pwm, context, pulse);
 }
 
 // ----------------- API -------------------
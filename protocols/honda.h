@@ -9,15 +9,18 @@
 #include <lib/subghz/blocks/generic.h>
 #include <lib/subghz/blocks/math.h>
 #include <flipper_format/flipper_format.h>
+#include "../helpers/protopirate_entry.h"
 
 #define HONDA_PROTOCOL_NAME "Honda"
 
 extern const SubGhzProtocol honda_protocol;
+extern const ProtoPirateEntry honda_protocol_entry;
 
 void* subghz_protocol_decoder_honda_alloc(SubGhzEnvironment* environment);
 void subghz_protocol_decoder_honda_free(void* context);
 void subghz_protocol_decoder_honda_reset(void* context);
 void subghz_protocol_decoder_honda_feed(void* context, bool level, uint32_t duration);
+void subghz_protocol_decoder_honda_feed_pulse(void* context, ProtoPiratePulse pulse);
 uint8_t subghz_protocol_decoder_honda_get_hash_data(void* context);
 SubGhzProtocolStatus subghz_protocol_decoder_honda_serialize(
     void* context,
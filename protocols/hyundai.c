@@ -1,4 +1,5 @@
 #include "hyundai.h"
+#include "../helpers/protopirate_trace.h"
 
 #define TAG "HyundaiProtocol"
 
@@ -59,6 +60,13 @@ const SubGhzProtocol hyundai_protocol = {
     .encoder = &subghz_protocol_hyundai_encoder,
 };
 
+const ProtoPirateEntry hyundai_protocol_entry = {
+    .block_const = &subghz_protocol_hyundai_const,
+    .decoder_size = sizeof(SubGhzProtocolDecoderHyundai),
+    .te = ProtoPirateEntryTeShort,
+    .level = ProtoPirateEntryLevelHigh,
+};
+
 void *subghz_protocol_decoder_hyundai_alloc(SubGhzEnvironment *environment)
 {
     UNUSED(environment);
@@ -127,6 +135,12 @@ void subghz_protocol_decoder_hyundai_feed(void *context, bool level, uint32_t du
                 instance->decoder.decode_data = 0;
                 instance->decoder.decode_count_bit = 1;
                 subghz_protocol_blocks_add_bit(&instance->decoder, 1);
+                PROTOPIRATE_TRACE_EVENT(
+                    ProtoPirateTraceProtocolHyundai,
+                    ProtoPirateTraceEventSync,
+                    HyundaiDecoderStepCheckPreambula,
+                    instance->header_count,
+                    duration);
             }
             else
             {
@@ -150,9 +164,26 @@ void subghz_protocol_decoder_hyundai_feed(void *context, bool level, uint32_t du
                 {
                     instance->generic.data = instance->decoder.decode_data;
                     instance->generic.data_count_bit = instance->decoder.decode_count_bit;
+                    PROTOPIRATE_TRACE_EVENT(
+                        ProtoPirateTraceProtocolHyundai,
+                        ProtoPirateTraceEventDecoded,
+                        HyundaiDecoderStepSaveDuration,
+                        instance->decoder.decode_count_bit,
+                        duration);
                     if (instance->base.callback)
                         instance->base.callback(&instance->base, instance->base.context);
                 }
+                else
+                {
+                    PROTOPIRATE_TRACE_EVENT(
+                        ProtoPirateTraceProtocolHyundai,
+                        PROTOPIRATE_TRACE_END_EVENT(
+                            instance->decoder.decode_count_bit,
+                            subghz_protocol_hyundai_const.min_count_bit_for_found),
+                        HyundaiDecoderStepSaveDuration,
+                        instance->decoder.decode_count_bit,
+                        duration);
+                }
                 instance->decoder.decode_data = 0;
                 instance->decoder.decode_count_bit = 0;
                 break;
@@ -186,6 +217,12 @@ void subghz_protocol_decoder_hyundai_feed(void *context, bool level, uint32_t du
             }
             else
             {
+                PROTOPIRATE_TRACE_EVENT(
+                    ProtoPirateTraceProtocolHyundai,
+                    ProtoPirateTraceEventMismatch,
+                    HyundaiDecoderStepCheckDuration,
+                    instance->decoder.decode_count_bit,
+                    duration);
                 instance->decoder.parser_step = HyundaiDecoderStepReset;
             }
         }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "kia_generic.h"
+#include "../helpers/protopirate_entry.h"
 
 #define HYUNDAI_PROTOCOL_NAME "Hyundai"
 
@@ -10,6 +11,7 @@ typedef struct SubGhzProtocolEncoderHyundai SubGhzProtocolEncoderHyundai;
 extern const SubGhzProtocolDecoder subghz_protocol_hyundai_decoder;
 extern const SubGhzProtocolEncoder subghz_protocol_hyundai_encoder;
 extern const SubGhzProtocol hyundai_protocol;
+extern const ProtoPirateEntry hyundai_protocol_entry;
 
 void* subghz_protocol_decoder_hyundai_alloc(SubGhzEnvironment* environment);
 void subghz_protocol_decoder_hyundai_free(void* context);
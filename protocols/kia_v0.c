@@ -1,4 +1,5 @@
 #include "kia_v0.h"
+#include "../helpers/protopirate_pwm.h"
 
 #define TAG "KiaProtocolV0"
 
@@ -15,6 +16,7 @@ struct SubGhzProtocolDecoderKIA
     SubGhzBlockDecoder decoder;
     SubGhzBlockGeneric generic;
     uint16_t header_count;
+    uint8_t high_class;
 };
 
 struct SubGhzProtocolEncoderKIA
@@ -34,14 +36,6 @@ struct SubGhzProtocolEncoderKIA
     bool send_high;
 };
 
-typedef enum
-{
-    KIADecoderStepReset = 0,
-    KIADecoderStepCheckPreambula,
-    KIADecoderStepSaveDuration,
-    KIADecoderStepCheckDuration,
-} KIADecoderStep;
-
 // Forward declarations for encoder
 void *subghz_protocol_encoder_kia_alloc(SubGhzEnvironment *environment);
 void subghz_protocol_encoder_kia_free(void *context);
@@ -77,6 +71,14 @@ const SubGhzProtocol kia_protocol_v0 = {
     .encoder = &subghz_protocol_kia_encoder,
 };
 
+const ProtoPirateEntry kia_protocol_v0_entry = {
+    .block_const = &subghz_protocol_kia_const,
+    .decoder_size = sizeof(SubGhzProtocolDecoderKIA),
+    .te = ProtoPirateEntryTeShort,
+    .level = ProtoPirateEntryLevelHigh,
+    .feed_pulse = subghz_protocol_decoder_kia_feed_pulse,
+};
+
 // Encoder implementation
 void *subghz_protocol_encoder_kia_alloc(SubGhzEnvironment *environment)
 {
@@ -382,139 +384,42 @@ void subghz_protocol_decoder_kia_reset(void *context)
 {
     furi_assert(context);
     SubGhzProtocolDecoderKIA *instance = context;
-    instance->decoder.parser_step = KIADecoderStepReset;
+    instance->decoder.parser_step = ProtoPiratePwmStepReset;
 }
 
+// Short pairs, a long pair as sync, then short-short 0 and long-long 1. Like
+// Flipper's own Kia decoder the sync counts as a 1 and one bit more.
+static const ProtoPiratePwm kia_v0_pwm = {
+    .block_const = &subghz_protocol_kia_const,
+    .trace = ProtoPirateTraceProtocolKiaV0,
+    .preamble_long = true,
+    .sync = PROTOPIRATE_PWM_LONG(subghz_protocol_kia_const),
+    .sync_after_long = true,
+    .sync_header_count = 16,
+    .start_data = 1,
+    .start_count_bit = 2,
+    .zero =
+        {
+            .high = ProtoPiratePulseClassShort,
+            .low = ProtoPiratePulseClassShort,
+        },
+    .one =
+        {
+            .high = ProtoPiratePulseClassLong,
+            .low = ProtoPiratePulseClassLong,
+        },
+    .end = subghz_protocol_kia_const.te_long + subghz_protocol_kia_const.te_delta * 2UL,
+    .max_count_bit = subghz_protocol_kia_const.min_count_bit_for_found,
+};
+
 void subghz_protocol_decoder_kia_feed(void *context, bool level, uint32_t duration)
 {
-    furi_assert(context);
-    SubGhzProtocolDecoderKIA *instance = context;
+    protopirate_pwm_feed(&kia_v0_pwm, context, level, duration);
+}
 
-    switch (instance->decoder.parser_step)
-    {
-    case KIADecoderStepReset:
-        if ((level) && (DURATION_DIFF(duration, subghz_protocol_kia_const.te_short) < subghz_protocol_kia_const.te_delta))
-        {
-            instance->decoder.parser_step = KIADecoderStepCheckPreambula;
-            instance->decoder.te_last = duration;
-            instance->header_count = 0;
-        }
-        break;
-    case KIADecoderStepCheckPreambula:
-        if (level)
-        {
-            if ((DURATION_DIFF(duration, subghz_protocol_kia_const.te_short) < subghz_protocol_kia_const.te_delta) ||
-                (DURATION_DIFF(duration, subghz_protocol_kia_const.te_long) < subghz_protocol_kia_const.te_delta))
-            {
-                instance->decoder.te_last = duration;
-            }
-            else
-            {
-                instance->decoder.parser_step = KIADecoderStepReset;
-            }
-        }
-        else if (
-            (DURATION_DIFF(duration, subghz_protocol_kia_const.te_short) < subghz_protocol_kia_const.te_delta) &&
-            (DURATION_DIFF(instance->decoder.te_last, subghz_protocol_kia_const.te_short) < subghz_protocol_kia_const.te_delta))
-        {
-            instance->header_count++;
-            break;
-        }
-        else if (
-            (DURATION_DIFF(duration, subghz_protocol_kia_const.te_long) < subghz_protocol_kia_const.te_delta) &&
-            (DURATION_DIFF(instance->decoder.te_last, subghz_protocol_kia_const.te_long) < subghz_protocol_kia_const.te_delta))
-        {
-            if (instance->header_count > 15)
-            {
-                instance->decoder.parser_step = KIADecoderStepSaveDuration;
-                instance->decoder.decode_data = 0;
-                instance->decoder.decode_count_bit = 1;
-                subghz_protocol_blocks_add_bit(&instance->decoder, 1);
-                FURI_LOG_I(TAG, "Starting data decode after %u header pulses", instance->header_count);
-            }
-            else
-            {
-                instance->decoder.parser_step = KIADecoderStepReset;
-            }
-        }
-        else
-        {
-            instance->decoder.parser_step = KIADecoderStepReset;
-        }
-        break;
-    case KIADecoderStepSaveDuration:
-        if (level)
-        {
-            if (duration >=
-                (subghz_protocol_kia_const.te_long + subghz_protocol_kia_const.te_delta * 2UL))
-            {
-                // Signal ended too early!
-                FURI_LOG_W(TAG, "Signal ended at %u bits (expected 61). Duration: %lu", 
-                          instance->decoder.decode_count_bit, duration);
-                
-                instance->decoder.parser_step = KIADecoderStepReset;
-                if (instance->decoder.decode_count_bit ==
-                    subghz_protocol_kia_const.min_count_bit_for_found)
-                {
-                    instance->generic.data = instance->decoder.decode_data;
-                    instance->generic.data_count_bit = instance->decoder.decode_count_bit;
-                    if (instance->base.callback)
-                        instance->base.callback(&instance->base, instance->base.context);
-                }
-                else
-                {
-                    FURI_LOG_E(TAG, "Incomplete signal: only %u bits", instance->decoder.decode_count_bit);
-                }
-                instance->decoder.decode_data = 0;
-                instance->decoder.decode_count_bit = 0;
-                break;
-            }
-            else
-            {
-                instance->decoder.te_last = duration;
-                instance->decoder.parser_step = KIADecoderStepCheckDuration;
-            }
-        }
-        else
-        {
-            instance->decoder.parser_step = KIADecoderStepReset;
-        }
-        break;
-    case KIADecoderStepCheckDuration:
-        if (!level)
-        {
-            if ((DURATION_DIFF(instance->decoder.te_last, subghz_protocol_kia_const.te_short) < subghz_protocol_kia_const.te_delta) &&
-                (DURATION_DIFF(duration, subghz_protocol_kia_const.te_short) < subghz_protocol_kia_const.te_delta))
-            {
-                subghz_protocol_blocks_add_bit(&instance->decoder, 0);
-                if (instance->decoder.decode_count_bit % 10 == 0) {
-                    FURI_LOG_D(TAG, "Decoded %u bits so far", instance->decoder.decode_count_bit);
-                }
-                instance->decoder.parser_step = KIADecoderStepSaveDuration;
-            }
-            else if (
-                (DURATION_DIFF(instance->decoder.te_last, subghz_protocol_kia_const.te_long) < subghz_protocol_kia_const.te_delta) &&
-                (DURATION_DIFF(duration, subghz_protocol_kia_const.te_long) < subghz_protocol_kia_const.te_delta))
-            {
-                subghz_protocol_blocks_add_bit(&instance->decoder, 1);
-                if (instance->decoder.decode_count_bit % 10 == 0) {
-                    FURI_LOG_D(TAG, "Decoded %u bits so far", instance->decoder.decode_count_bit);
-                }
-                instance->decoder.parser_step = KIADecoderStepSaveDuration;
-            }
-            else
-            {
-                FURI_LOG_W(TAG, "Timing mismatch at bit %u. Last: %lu, Current: %lu", 
-                          instance->decoder.decode_count_bit, instance->decoder.te_last, duration);
-                instance->decoder.parser_step = KIADecoderStepReset;
-            }
-        }
-        else
-        {
-            instance->decoder.parser_step = KIADecoderStepReset;
-        }
-        break;
-    }
+void subghz_protocol_decoder_kia_feed_pulse(void *context, ProtoPiratePulse pulse)
+{
+    protopirate_pwm_feed_pulse(&kia_v0_pwm, context, pulse);
 }
 
 static void subghz_protocol_kia_check_remote_controller(SubGhzBlockGeneric *instance)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "kia_generic.h"
+#include "../helpers/protopirate_entry.h"
 
 #define KIA_PROTOCOL_V0_NAME "Kia V0"
 
@@ -10,11 +11,13 @@ typedef struct SubGhzProtocolEncoderKIA SubGhzProtocolEncoderKIA;
 extern const SubGhzProtocolDecoder subghz_protocol_kia_decoder;
 extern const SubGhzProtocolEncoder subghz_protocol_kia_encoder;
 extern const SubGhzProtocol kia_protocol_v0;
+extern const ProtoPirateEntry kia_protocol_v0_entry;
 
 void* subghz_protocol_decoder_kia_alloc(SubGhzEnvironment* environment);
 void subghz_protocol_decoder_kia_free(void* context);
 void subghz_protocol_decoder_kia_reset(void* context);
 void subghz_protocol_decoder_kia_feed(void* context, bool level, uint32_t duration);
+void subghz_protocol_decoder_kia_feed_pulse(void* context, ProtoPiratePulse pulse);
 uint8_t subghz_protocol_decoder_kia_get_hash_data(void* context);
 SubGhzProtocolStatus subghz_protocol_decoder_kia_serialize(
     void* context,
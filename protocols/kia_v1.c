@@ -1,4 +1,6 @@
 #include "kia_v1.h"
+#include "../helpers/protopirate_trace.h"
+#include "../helpers/protopirate_manchester.h"
 
 #define TAG "KiaV1"
 
@@ -10,6 +12,14 @@ static const SubGhzBlockConst kia_protocol_v1_const = {
     .min_count_bit_for_found = 56,
 };
 
+// Half-bits are collected during the frame and decoded at its end, 10 is a 1.
+// The frame can start up to 7 half-bits in (RTL-433 uses a -1 bit offset).
+static const ProtoPirateManchester kia_v1_manchester = {
+    .block_const = &kia_protocol_v1_const,
+    .offset = 0,
+    .offset_count = 8,
+};
+
 struct SubGhzProtocolDecoderKiaV1
 {
     SubGhzProtocolDecoderBase base;
@@ -17,7 +27,7 @@ struct SubGhzProtocolDecoderKiaV1
     SubGhzBlockGeneric generic;
     uint16_t header_count;
 
-    uint8_t raw_bits[24];
+    uint64_t raw_bits[3]; // half-bits, see protopirate_manchester_push_half
     uint16_t raw_bit_count;
 };
 
@@ -64,97 +74,33 @@ const SubGhzProtocol kia_protocol_v1 = {
     .encoder = &kia_protocol_v1_encoder,
 };
 
-static void kia_v1_add_raw_bit(SubGhzProtocolDecoderKiaV1 *instance, bool bit)
-{
-    if (instance->raw_bit_count < 192)
-    {
-        uint16_t byte_idx = instance->raw_bit_count / 8;
-        uint8_t bit_idx = 7 - (instance->raw_bit_count % 8);
-        if (bit)
-        {
-            instance->raw_bits[byte_idx] |= (1 << bit_idx);
-        }
-        else
-        {
-            instance->raw_bits[byte_idx] &= ~(1 << bit_idx);
-        }
-        instance->raw_bit_count++;
-    }
-}
+const ProtoPirateEntry kia_protocol_v1_entry = {
+    .block_const = &kia_protocol_v1_const,
+    .decoder_size = sizeof(SubGhzProtocolDecoderKiaV1),
+    .te = ProtoPirateEntryTeLong,
+    .level = ProtoPirateEntryLevelHigh,
+};
 
-static inline bool kia_v1_get_raw_bit(SubGhzProtocolDecoderKiaV1 *instance, uint16_t idx)
+static void kia_v1_add_raw_bit(SubGhzProtocolDecoderKiaV1 *instance, bool bit)
 {
-    uint16_t byte_idx = idx / 8;
-    uint8_t bit_idx = 7 - (idx % 8);
-    return (instance->raw_bits[byte_idx] >> bit_idx) & 1;
+    protopirate_manchester_push_half(instance->raw_bits, &instance->raw_bit_count, 192, bit);
 }
 
 static bool kia_v1_manchester_decode(SubGhzProtocolDecoderKiaV1 *instance)
 {
     if (instance->raw_bit_count < 113)
     {
-        FURI_LOG_D(TAG, "Not enough raw bits: %u", instance->raw_bit_count);
         return false;
     }
 
-    FURI_LOG_D(
-        TAG,
-        "Raw: %02X %02X %02X %02X %02X %02X",
-        instance->raw_bits[0],
-        instance->raw_bits[1],
-        instance->raw_bits[2],
-        instance->raw_bits[3],
-        instance->raw_bits[4],
-        instance->raw_bits[5]);
-
-    // Try different offsets to find best alignment (RTL-433 uses -1 bit offset)
-    uint16_t best_bits = 0;
-    uint64_t best_data = 0;
-    uint16_t best_offset = 0;
-
-    for (uint16_t offset = 0; offset < 8; offset++)
-    {
-        uint64_t data = 0;
-        uint16_t decoded_bits = 0;
-
-        for (uint16_t i = offset; i + 1 < instance->raw_bit_count && decoded_bits < 56; i += 2)
-        {
-            bool bit1 = kia_v1_get_raw_bit(instance, i);
-            bool bit2 = kia_v1_get_raw_bit(instance, i + 1);
-
-            uint8_t two_bits = (bit1 << 1) | bit2;
-
-            // V1 uses: 10=1, 01=0
-            if (two_bits == 0x02)
-            { // 10 = decoded 1
-                data = (data << 1) | 1;
-                decoded_bits++;
-            }
-            else if (two_bits == 0x01)
-            { // 01 = decoded 0
-                data = (data << 1);
-                decoded_bits++;
-            }
-            else
-            {
-                break;
-            }
-        }
-
-        if (decoded_bits > best_bits)
-        {
-            best_bits = decoded_bits;
-            best_data = data;
-            best_offset = offset;
-        }
-    }
-
-    FURI_LOG_I(TAG, "Best: offset=%u bits=%u data=%014llX", best_offset, best_bits, best_data);
+    instance->decoder.decode_count_bit = protopirate_manchester_decode_halves(
+        &kia_v1_manchester,
+        instance->raw_bits,
+        instance->raw_bit_count,
+        kia_protocol_v1_const.min_count_bit_for_found,
+        &instance->decoder.decode_data);
 
-    instance->decoder.decode_data = best_data;
-    instance->decoder.decode_count_bit = best_bits;
-
-    return best_bits >= kia_protocol_v1_const.min_count_bit_for_found;
+    return instance->decoder.decode_count_bit >= kia_protocol_v1_const.min_count_bit_for_found;
 }
 
 void *kia_protocol_decoder_v1_alloc(SubGhzEnvironment *environment)
@@ -180,7 +126,6 @@ void kia_protocol_decoder_v1_reset(void *context)
     instance->decoder.parser_step = KiaV1DecoderStepReset;
     instance->header_count = 0;
     instance->raw_bit_count = 0;
-    memset(instance->raw_bits, 0, sizeof(instance->raw_bits));
 }
 
 void kia_protocol_decoder_v1_feed(void *context, bool level, uint32_t duration)
@@ -251,10 +196,14 @@ void kia_protocol_decoder_v1_feed(void *context, bool level, uint32_t duration)
         if (level && (DURATION_DIFF(duration, kia_protocol_v1_const.te_short) <
                       kia_protocol_v1_const.te_delta))
         {
-            FURI_LOG_I(TAG, "Sync! hdr=%u", instance->header_count);
+            PROTOPIRATE_TRACE_EVENT(
+                ProtoPirateTraceProtocolKiaV1,
+                ProtoPirateTraceEventSync,
+                KiaV1DecoderStepFoundShortLow,
+                instance->header_count,
+                duration);
             instance->decoder.parser_step = KiaV1DecoderStepCollectRawBits;
             instance->raw_bit_count = 0;
-            memset(instance->raw_bits, 0, sizeof(instance->raw_bits));
             // Add the sync short HIGH as first raw bit
             kia_v1_add_raw_bit(instance, true);
         }
@@ -267,8 +216,6 @@ void kia_protocol_decoder_v1_feed(void *context, bool level, uint32_t duration)
     case KiaV1DecoderStepCollectRawBits:
         if (duration > 2400)
         {
-            FURI_LOG_I(TAG, "End! raw_bits=%u", instance->raw_bit_count);
-
             if (kia_v1_manchester_decode(instance))
             {
                 instance->generic.data = instance->decoder.decode_data;
@@ -283,47 +230,47 @@ void kia_protocol_decoder_v1_feed(void *context, bool level, uint32_t duration)
                 instance->generic.btn = (uint8_t)((instance->generic.data >> 16) & 0xFF);
                 instance->generic.cnt = (uint8_t)((instance->generic.data >> 8) & 0xFF);
 
-                FURI_LOG_I(
-                    TAG,
-                    "DECODE! Key=%014llX Sn=%08lX Btn=%02X Cnt=%02X",
-                    instance->generic.data,
-                    instance->generic.serial,
-                    instance->generic.btn,
-                    (uint8_t)instance->generic.cnt);
+                PROTOPIRATE_TRACE_EVENT(
+                    ProtoPirateTraceProtocolKiaV1,
+                    ProtoPirateTraceEventDecoded,
+                    KiaV1DecoderStepCollectRawBits,
+                    instance->generic.data_count_bit,
+                    duration);
 
                 if (instance->base.callback)
                     instance->base.callback(&instance->base, instance->base.context);
             }
+            else
+            {
+                PROTOPIRATE_TRACE_EVENT(
+                    ProtoPirateTraceProtocolKiaV1,
+                    ProtoPirateTraceEventEarlyEnd,
+                    KiaV1DecoderStepCollectRawBits,
+                    MIN(instance->raw_bit_count, 255),
+                    duration);
+            }
 
             instance->decoder.parser_step = KiaV1DecoderStepReset;
             break;
         }
 
-        int num_bits = 0;
-        if (DURATION_DIFF(duration, kia_protocol_v1_const.te_short) <
-            kia_protocol_v1_const.te_delta)
-        {
-            num_bits = 1;
-        }
-        else if (
-            DURATION_DIFF(duration, kia_protocol_v1_const.te_long) <
-            kia_protocol_v1_const.te_delta)
-        {
-            num_bits = 2;
-        }
-        else
+        ProtoPirateManchesterEvent event =
+            protopirate_manchester_event(&kia_v1_manchester, level, duration);
+        if (event == ProtoPirateManchesterEventNone)
         {
-            FURI_LOG_D(
-                TAG,
-                "Invalid pulse: %s %lu, raw_bits=%u",
-                level ? "H" : "L",
-                duration,
-                instance->raw_bit_count);
+            PROTOPIRATE_TRACE_EVENT(
+                ProtoPirateTraceProtocolKiaV1,
+                ProtoPirateTraceEventMismatch,
+                KiaV1DecoderStepCollectRawBits,
+                MIN(instance->raw_bit_count, 255),
+                duration);
             instance->decoder.parser_step = KiaV1DecoderStepReset;
             break;
         }
 
-        for (int i = 0; i < num_bits; i++)
+        // A long pulse is two half-bits of the same level
+        kia_v1_add_raw_bit(instance, level);
+        if (event >= ProtoPirateManchesterEventLongLow)
         {
             kia_v1_add_raw_bit(instance, level);
         }
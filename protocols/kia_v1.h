@@ -1,6 +1,7 @@
 #pragma once
 
 #include "kia_generic.h"
+#include "../helpers/protopirate_entry.h"
 
 #define KIA_PROTOCOL_V1_NAME "Kia V1"
 
@@ -10,6 +11,7 @@ typedef struct SubGhzProtocolEncoderKiaV1 SubGhzProtocolEncoderKiaV1;
 extern const SubGhzProtocolDecoder kia_protocol_v1_decoder;
 extern const SubGhzProtocolEncoder kia_protocol_v1_encoder;
 extern const SubGhzProtocol kia_protocol_v1;
+extern const ProtoPirateEntry kia_protocol_v1_entry;
 
 void* kia_protocol_decoder_v1_alloc(SubGhzEnvironment* environment);
 void kia_protocol_decoder_v1_free(void* context);
@@ -1,4 +1,6 @@
 #include "kia_v2.h"
+#include "../helpers/protopirate_trace.h"
+#include "../helpers/protopirate_manchester.h"
 
 #define TAG "KiaV2"
 
@@ -9,6 +11,16 @@ static const SubGhzBlockConst kia_protocol_v2_const = {
     .min_count_bit_for_found = 51,
 };
 
+// Half-bits are collected during the frame and decoded at its end, 10 is a 1.
+// The frame can start up to 7 half-bits in.
+#define KIA_V2_FRAME_BITS 53
+
+static const ProtoPirateManchester kia_v2_manchester = {
+    .block_const = &kia_protocol_v2_const,
+    .offset = 0,
+    .offset_count = 8,
+};
+
 struct SubGhzProtocolDecoderKiaV2
 {
     SubGhzProtocolDecoderBase base;
@@ -16,7 +28,7 @@ struct SubGhzProtocolDecoderKiaV2
     SubGhzBlockGeneric generic;
     uint16_t header_count;
 
-    uint8_t raw_bits[20];
+    uint64_t raw_bits[3]; // half-bits, see protopirate_manchester_push_half
     uint16_t raw_bit_count;
 };
 
@@ -62,29 +74,16 @@ const SubGhzProtocol kia_protocol_v2 = {
     .encoder = &kia_protocol_v2_encoder,
 };
 
-static void kia_v2_add_raw_bit(SubGhzProtocolDecoderKiaV2 *instance, bool bit)
-{
-    if (instance->raw_bit_count < 160)
-    {
-        uint16_t byte_idx = instance->raw_bit_count / 8;
-        uint8_t bit_idx = 7 - (instance->raw_bit_count % 8);
-        if (bit)
-        {
-            instance->raw_bits[byte_idx] |= (1 << bit_idx);
-        }
-        else
-        {
-            instance->raw_bits[byte_idx] &= ~(1 << bit_idx);
-        }
-        instance->raw_bit_count++;
-    }
-}
+const ProtoPirateEntry kia_protocol_v2_entry = {
+    .block_const = &kia_protocol_v2_const,
+    .decoder_size = sizeof(SubGhzProtocolDecoderKiaV2),
+    .te = ProtoPirateEntryTeLong,
+    .level = ProtoPirateEntryLevelHigh,
+};
 
-static inline bool kia_v2_get_raw_bit(SubGhzProtocolDecoderKiaV2 *instance, uint16_t idx)
+static void kia_v2_add_raw_bit(SubGhzProtocolDecoderKiaV2 *instance, bool bit)
 {
-    uint16_t byte_idx = idx / 8;
-    uint8_t bit_idx = 7 - (idx % 8);
-    return (instance->raw_bits[byte_idx] >> bit_idx) & 1;
+    protopirate_manchester_push_half(instance->raw_bits, &instance->raw_bit_count, 160, bit);
 }
 
 static bool kia_v2_manchester_decode(SubGhzProtocolDecoderKiaV2 *instance)
@@ -94,48 +93,14 @@ static bool kia_v2_manchester_decode(SubGhzProtocolDecoderKiaV2 *instance)
         return false;
     }
 
-    uint16_t best_bits = 0;
-    uint64_t best_data = 0;
-
-    for (uint16_t offset = 0; offset < 8; offset++)
-    {
-        uint64_t data = 0;
-        uint16_t decoded_bits = 0;
+    instance->decoder.decode_count_bit = protopirate_manchester_decode_halves(
+        &kia_v2_manchester,
+        instance->raw_bits,
+        instance->raw_bit_count,
+        KIA_V2_FRAME_BITS,
+        &instance->decoder.decode_data);
 
-        for (uint16_t i = offset; i + 1 < instance->raw_bit_count && decoded_bits < 53; i += 2)
-        {
-            bool bit1 = kia_v2_get_raw_bit(instance, i);
-            bool bit2 = kia_v2_get_raw_bit(instance, i + 1);
-
-            uint8_t two_bits = (bit1 << 1) | bit2;
-
-            if (two_bits == 0x02)
-            {
-                data = (data << 1) | 1;
-                decoded_bits++;
-            }
-            else if (two_bits == 0x01)
-            {
-                data = (data << 1);
-                decoded_bits++;
-            }
-            else
-            {
-                break;
-            }
-        }
-
-        if (decoded_bits > best_bits)
-        {
-            best_bits = decoded_bits;
-            best_data = data;
-        }
-    }
-
-    instance->decoder.decode_data = best_data;
-    instance->decoder.decode_count_bit = best_bits;
-
-    return best_bits >= kia_protocol_v2_const.min_count_bit_for_found;
+    return instance->decoder.decode_count_bit >= kia_protocol_v2_const.min_count_bit_for_found;
 }
 
 void *kia_protocol_decoder_v2_alloc(SubGhzEnvironment *environment)
@@ -161,7 +126,6 @@ void kia_protocol_decoder_v2_reset(void *context)
     instance->decoder.parser_step = KiaV2DecoderStepReset;
     instance->header_count = 0;
     instance->raw_bit_count = 0;
-    memset(instance->raw_bits, 0, sizeof(instance->raw_bits));
 }
 
 void kia_protocol_decoder_v2_feed(void *context, bool level, uint32_t duration)
@@ -216,9 +180,14 @@ void kia_protocol_decoder_v2_feed(void *context, bool level, uint32_t duration)
                     DURATION_DIFF(instance->decoder.te_last, kia_protocol_v2_const.te_short) <
                         kia_protocol_v2_const.te_delta)
                 {
+                    PROTOPIRATE_TRACE_EVENT(
+                        ProtoPirateTraceProtocolKiaV2,
+                        ProtoPirateTraceEventSync,
+                        KiaV2DecoderStepCheckPreamble,
+                        instance->header_count,
+                        duration);
                     instance->decoder.parser_step = KiaV2DecoderStepCollectRawBits;
                     instance->raw_bit_count = 0;
-                    memset(instance->raw_bits, 0, sizeof(instance->raw_bits));
                 }
             }
             else
@@ -242,33 +211,47 @@ void kia_protocol_decoder_v2_feed(void *context, bool level, uint32_t duration)
                 uint16_t raw_count = (uint16_t)((instance->generic.data >> 4) & 0xFFF);
                 instance->generic.cnt = ((raw_count >> 4) | (raw_count << 8)) & 0xFFF;
 
+                PROTOPIRATE_TRACE_EVENT(
+                    ProtoPirateTraceProtocolKiaV2,
+                    ProtoPirateTraceEventDecoded,
+                    KiaV2DecoderStepCollectRawBits,
+                    instance->generic.data_count_bit,
+                    duration);
+
                 if (instance->base.callback)
                     instance->base.callback(&instance->base, instance->base.context);
             }
+            else
+            {
+                PROTOPIRATE_TRACE_EVENT(
+                    ProtoPirateTraceProtocolKiaV2,
+                    ProtoPirateTraceEventEarlyEnd,
+                    KiaV2DecoderStepCollectRawBits,
+                    MIN(instance->raw_bit_count, 255),
+                    duration);
+            }
 
             instance->decoder.parser_step = KiaV2DecoderStepReset;
             break;
         }
 
-        int num_bits = 0;
-        if (DURATION_DIFF(duration, kia_protocol_v2_const.te_short) <
-            kia_protocol_v2_const.te_delta)
-        {
-            num_bits = 1;
-        }
-        else if (
-            DURATION_DIFF(duration, kia_protocol_v2_const.te_long) <
-            kia_protocol_v2_const.te_delta)
-        {
-            num_bits = 2;
-        }
-        else
+        ProtoPirateManchesterEvent event =
+            protopirate_manchester_event(&kia_v2_manchester, level, duration);
+        if (event == ProtoPirateManchesterEventNone)
         {
+            PROTOPIRATE_TRACE_EVENT(
+                ProtoPirateTraceProtocolKiaV2,
+                ProtoPirateTraceEventMismatch,
+                KiaV2DecoderStepCollectRawBits,
+                MIN(instance->raw_bit_count, 255),
+                duration);
             instance->decoder.parser_step = KiaV2DecoderStepReset;
             break;
         }
 
-        for (int i = 0; i < num_bits; i++)
+        // A long pulse is two half-bits of the same level
+        kia_v2_add_raw_bit(instance, level);
+        if (event >= ProtoPirateManchesterEventLongLow)
         {
             kia_v2_add_raw_bit(instance, level);
         }
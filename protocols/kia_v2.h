@@ -1,6 +1,7 @@
 #pragma once
 
 #include "kia_generic.h"
+#include "../helpers/protopirate_entry.h"
 
 #define KIA_PROTOCOL_V2_NAME "Kia V2"
 
@@ -10,6 +11,7 @@ typedef struct SubGhzProtocolEncoderKiaV2 SubGhzProtocolEncoderKiaV2;
 extern const SubGhzProtocolDecoder kia_protocol_v2_decoder;
 extern const SubGhzProtocolEncoder kia_protocol_v2_encoder;
 extern const SubGhzProtocol kia_protocol_v2;
+extern const ProtoPirateEntry kia_protocol_v2_entry;
 
 void* kia_protocol_decoder_v2_alloc(SubGhzEnvironment* environment);
 void kia_protocol_decoder_v2_free(void* context);
@@ -1,4 +1,5 @@
 #include "kia_v3_v4.h"
+#include "../helpers/protopirate_trace.h"
 
 #define TAG "KiaV3V4"
 
@@ -19,7 +20,7 @@ typedef struct SubGhzProtocolDecoderKiaV3V4
     SubGhzBlockGeneric generic;
     uint16_t header_count;
 
-    uint8_t raw_bits[32];
+    uint64_t raw_data; // first 64 bits, the frame, MSB first
     uint16_t raw_bit_count;
     bool is_v3_sync; // true = V3 (long LOW sync), false = V4 (long HIGH sync)
 
@@ -60,27 +61,24 @@ static uint32_t keeloq_common_decrypt(uint32_t data, uint64_t key)
     return block;
 }
 
-static uint8_t reverse8(uint8_t byte)
+static uint32_t reverse32(uint32_t word)
 {
-    byte = (byte & 0xF0) >> 4 | (byte & 0x0F) << 4;
-    byte = (byte & 0xCC) >> 2 | (byte & 0x33) << 2;
-    byte = (byte & 0xAA) >> 1 | (byte & 0x55) << 1;
-    return byte;
+    word = (word & 0xFFFF0000) >> 16 | (word & 0x0000FFFF) << 16;
+    word = (word & 0xFF00FF00) >> 8 | (word & 0x00FF00FF) << 8;
+    word = (word & 0xF0F0F0F0) >> 4 | (word & 0x0F0F0F0F) << 4;
+    word = (word & 0xCCCCCCCC) >> 2 | (word & 0x33333333) << 2;
+    word = (word & 0xAAAAAAAA) >> 1 | (word & 0x55555555) << 1;
+    return word;
 }
 
 static void kia_v3_v4_add_raw_bit(SubGhzProtocolDecoderKiaV3V4 *instance, bool bit)
 {
     if (instance->raw_bit_count < 256)
     {
-        uint16_t byte_idx = instance->raw_bit_count / 8;
-        uint8_t bit_idx = 7 - (instance->raw_bit_count % 8);
-        if (bit)
+        // Bits past the frame are only counted
+        if (instance->raw_bit_count < 64)
         {
-            instance->raw_bits[byte_idx] |= (1 << bit_idx);
-        }
-        else
-        {
-            instance->raw_bits[byte_idx] &= ~(1 << bit_idx);
+            instance->raw_data = (instance->raw_data << 1) | bit;
         }
         instance->raw_bit_count++;
     }
@@ -93,26 +91,19 @@ static bool kia_v3_v4_process_buffer(SubGhzProtocolDecoderKiaV3V4 *instance)
         return false;
     }
 
-    uint8_t *b = instance->raw_bits;
+    uint64_t key_data = instance->raw_data;
 
     // For V3-style (long LOW sync), data is inverted
     if (instance->is_v3_sync)
     {
-        uint16_t num_bytes = (instance->raw_bit_count + 7) / 8;
-        for (uint16_t i = 0; i < num_bytes; i++)
-        {
-            b[i] = ~b[i];
-        }
+        key_data = ~key_data;
     }
 
-    // Extract fields
-    uint32_t encrypted = ((uint32_t)reverse8(b[3]) << 24) | ((uint32_t)reverse8(b[2]) << 16) |
-                         ((uint32_t)reverse8(b[1]) << 8) | (uint32_t)reverse8(b[0]);
-
-    uint32_t serial = ((uint32_t)reverse8(b[7] & 0xF0) << 24) | ((uint32_t)reverse8(b[6]) << 16) |
-                      ((uint32_t)reverse8(b[5]) << 8) | (uint32_t)reverse8(b[4]);
-
-    uint8_t btn = (reverse8(b[7]) & 0xF0) >> 4;
+    // Extract fields, both halves are sent LSB first
+    uint32_t encrypted = reverse32(key_data >> 32);
+    uint32_t fixed = reverse32(key_data & 0xFFFFFFFF);
+    uint32_t serial = fixed & 0x0FFFFFFF;
+    uint8_t btn = fixed >> 28;
     uint8_t our_serial_lsb = serial & 0xFF;
 
     // Decrypt
@@ -134,9 +125,6 @@ static bool kia_v3_v4_process_buffer(SubGhzProtocolDecoderKiaV3V4 *instance)
     instance->generic.cnt = decrypted & 0xFFFF;
     instance->version = instance->is_v3_sync ? 1 : 0;
 
-    uint64_t key_data = ((uint64_t)b[0] << 56) | ((uint64_t)b[1] << 48) | ((uint64_t)b[2] << 40) |
-                        ((uint64_t)b[3] << 32) | ((uint64_t)b[4] << 24) | ((uint64_t)b[5] << 16) |
-                        ((uint64_t)b[6] << 8) | (uint64_t)b[7];
     instance->generic.data = key_data;
     instance->generic.data_count_bit = 64;
 
@@ -171,6 +159,13 @@ const SubGhzProtocol kia_protocol_v3_v4 = {
     .encoder = &kia_protocol_v3_v4_encoder,
 };
 
+const ProtoPirateEntry kia_protocol_v3_v4_entry = {
+    .block_const = &kia_protocol_v3_v4_const,
+    .decoder_size = sizeof(SubGhzProtocolDecoderKiaV3V4),
+    .te = ProtoPirateEntryTeShort,
+    .level = ProtoPirateEntryLevelHigh,
+};
+
 void *kia_protocol_decoder_v3_v4_alloc(SubGhzEnvironment *environment)
 {
     UNUSED(environment);
@@ -194,7 +189,33 @@ void kia_protocol_decoder_v3_v4_reset(void *context)
     instance->decoder.parser_step = KiaV3V4DecoderStepReset;
     instance->header_count = 0;
     instance->raw_bit_count = 0;
-    memset(instance->raw_bits, 0, sizeof(instance->raw_bits));
+    instance->raw_data = 0;
+}
+
+// Sync or gap after the data, decode whatever was collected
+static void kia_v3_v4_end_packet(SubGhzProtocolDecoderKiaV3V4 *instance, uint32_t duration)
+{
+    if (kia_v3_v4_process_buffer(instance))
+    {
+        PROTOPIRATE_TRACE_EVENT(
+            ProtoPirateTraceProtocolKiaV3V4,
+            ProtoPirateTraceEventDecoded,
+            KiaV3V4DecoderStepCollectRawBits,
+            instance->generic.data_count_bit,
+            duration);
+        if (instance->base.callback)
+            instance->base.callback(&instance->base, instance->base.context);
+    }
+    else if (instance->raw_bit_count < 64)
+    {
+        PROTOPIRATE_TRACE_EVENT(
+            ProtoPirateTraceProtocolKiaV3V4,
+            ProtoPirateTraceEventEarlyEnd,
+            KiaV3V4DecoderStepCollectRawBits,
+            MIN(instance->raw_bit_count, 255),
+            duration);
+    }
+    instance->decoder.parser_step = KiaV3V4DecoderStepReset;
 }
 
 void kia_protocol_decoder_v3_v4_feed(void *context, bool level, uint32_t duration)
@@ -227,10 +248,16 @@ void kia_protocol_decoder_v3_v4_feed(void *context, bool level, uint32_t duratio
                 // V4 style: Sync is LONG HIGH
                 if (instance->header_count >= 8)
                 {
+                    PROTOPIRATE_TRACE_EVENT(
+                        ProtoPirateTraceProtocolKiaV3V4,
+                        ProtoPirateTraceEventSync,
+                        KiaV3V4DecoderStepCheckPreamble,
+                        instance->header_count,
+                        duration);
                     instance->decoder.parser_step = KiaV3V4DecoderStepCollectRawBits;
                     instance->raw_bit_count = 0;
                     instance->is_v3_sync = false;
-                    memset(instance->raw_bits, 0, sizeof(instance->raw_bits));
+                    instance->raw_data = 0;
                 }
                 else
                 {
@@ -249,10 +276,16 @@ void kia_protocol_decoder_v3_v4_feed(void *context, bool level, uint32_t duratio
                 // V3 style: Sync is LONG LOW
                 if (instance->header_count >= 8)
                 {
+                    PROTOPIRATE_TRACE_EVENT(
+                        ProtoPirateTraceProtocolKiaV3V4,
+                        ProtoPirateTraceEventSync,
+                        KiaV3V4DecoderStepCheckPreamble,
+                        instance->header_count,
+                        duration);
                     instance->decoder.parser_step = KiaV3V4DecoderStepCollectRawBits;
                     instance->raw_bit_count = 0;
                     instance->is_v3_sync = true;
-                    memset(instance->raw_bits, 0, sizeof(instance->raw_bits));
+                    instance->raw_data = 0;
                 }
                 else
                 {
@@ -280,12 +313,7 @@ void kia_protocol_decoder_v3_v4_feed(void *context, bool level, uint32_t duratio
             if (duration > 1000 && duration < 1500)
             {
                 // Next sync pulse (V4 style) - end this packet
-                if (kia_v3_v4_process_buffer(instance))
-                {
-                    if (instance->base.callback)
-                        instance->base.callback(&instance->base, instance->base.context);
-                }
-                instance->decoder.parser_step = KiaV3V4DecoderStepReset;
+                kia_v3_v4_end_packet(instance, duration);
             }
             else if (
                 DURATION_DIFF(duration, kia_protocol_v3_v4_const.te_short) <
@@ -301,6 +329,12 @@ void kia_protocol_decoder_v3_v4_feed(void *context, bool level, uint32_t duratio
             }
             else
             {
+                PROTOPIRATE_TRACE_EVENT(
+                    ProtoPirateTraceProtocolKiaV3V4,
+                    ProtoPirateTraceEventMismatch,
+                    KiaV3V4DecoderStepCollectRawBits,
+                    MIN(instance->raw_bit_count, 255),
+                    duration);
                 instance->decoder.parser_step = KiaV3V4DecoderStepReset;
             }
         }
@@ -309,22 +343,12 @@ void kia_protocol_decoder_v3_v4_feed(void *context, bool level, uint32_t duratio
             if (duration > 1000 && duration < 1500)
             {
                 // Next sync pulse (V3 style) - end this packet
-                if (kia_v3_v4_process_buffer(instance))
-                {
-                    if (instance->base.callback)
-                        instance->base.callback(&instance->base, instance->base.context);
-                }
-                instance->decoder.parser_step = KiaV3V4DecoderStepReset;
+                kia_v3_v4_end_packet(instance, duration);
             }
             else if (duration > 1500)
             {
                 // Long gap - end of transmission
-                if (kia_v3_v4_process_buffer(instance))
-                {
-                    if (instance->base.callback)
-                        instance->base.callback(&instance->base, instance->base.context);
-                }
-                instance->decoder.parser_step = KiaV3V4DecoderStepReset;
+                kia_v3_v4_end_packet(instance, duration);
             }
         }
         break;
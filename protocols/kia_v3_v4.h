@@ -1,10 +1,12 @@
 #pragma once
 
 #include "kia_generic.h"
+#include "../helpers/protopirate_entry.h"
 
 #define KIA_PROTOCOL_V3_V4_NAME "Kia V3/V4"
 
 extern const SubGhzProtocol kia_protocol_v3_v4;
+extern const ProtoPirateEntry kia_protocol_v3_v4_entry;
 
 void* kia_protocol_decoder_v3_v4_alloc(SubGhzEnvironment* environment);
 void kia_protocol_decoder_v3_v4_free(void* context);
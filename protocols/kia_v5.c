@@ -1,4 +1,6 @@
 #include "kia_v5.h"
+#include "../helpers/protopirate_trace.h"
+#include "../helpers/protopirate_manchester.h"
 
 #define TAG "KiaV5"
 
@@ -9,6 +11,15 @@ static const SubGhzBlockConst kia_protocol_v5_const = {
     .min_count_bit_for_found = 64,
 };
 
+// Half-bits are collected during the frame and decoded at its end, 01 is a 1.
+// The frame starts 2 half-bits in.
+static const ProtoPirateManchester kia_v5_manchester = {
+    .block_const = &kia_protocol_v5_const,
+    .ieee = true,
+    .offset = 2,
+    .offset_count = 1,
+};
+
 struct SubGhzProtocolDecoderKiaV5
 {
     SubGhzProtocolDecoderBase base;
@@ -16,7 +27,7 @@ struct SubGhzProtocolDecoderKiaV5
     SubGhzBlockGeneric generic;
     uint16_t header_count;
 
-    uint8_t raw_bits[32];
+    uint64_t raw_bits[4]; // half-bits, see protopirate_manchester_push_half
     uint16_t raw_bit_count;
 };
 
@@ -61,29 +72,16 @@ const SubGhzProtocol kia_protocol_v5 = {
     .encoder = &kia_protocol_v5_encoder,
 };
 
-static void kia_v5_add_raw_bit(SubGhzProtocolDecoderKiaV5 *instance, bool bit)
-{
-    if (instance->raw_bit_count < 256)
-    {
-        uint16_t byte_idx = instance->raw_bit_count / 8;
-        uint8_t bit_idx = 7 - (instance->raw_bit_count % 8);
-        if (bit)
-        {
-            instance->raw_bits[byte_idx] |= (1 << bit_idx);
-        }
-        else
-        {
-            instance->raw_bits[byte_idx] &= ~(1 << bit_idx);
-        }
-        instance->raw_bit_count++;
-    }
-}
+const ProtoPirateEntry kia_protocol_v5_entry = {
+    .block_const = &kia_protocol_v5_const,
+    .decoder_size = sizeof(SubGhzProtocolDecoderKiaV5),
+    .te = ProtoPirateEntryTeShort,
+    .level = ProtoPirateEntryLevelHigh,
+};
 
-static inline bool kia_v5_get_raw_bit(SubGhzProtocolDecoderKiaV5 *instance, uint16_t idx)
+static void kia_v5_add_raw_bit(SubGhzProtocolDecoderKiaV5 *instance, bool bit)
 {
-    uint16_t byte_idx = idx / 8;
-    uint8_t bit_idx = 7 - (idx % 8);
-    return (instance->raw_bits[byte_idx] >> bit_idx) & 1;
+    protopirate_manchester_push_half(instance->raw_bits, &instance->raw_bit_count, 256, bit);
 }
 
 static bool kia_v5_manchester_decode(SubGhzProtocolDecoderKiaV5 *instance)
@@ -93,36 +91,12 @@ static bool kia_v5_manchester_decode(SubGhzProtocolDecoderKiaV5 *instance)
         return false;
     }
 
-    instance->decoder.decode_data = 0;
-    instance->decoder.decode_count_bit = 0;
-
-    // Start at offset 2 for proper Manchester alignment
-    const uint16_t start_bit = 2;
-
-    for (uint16_t i = start_bit;
-         i + 1 < instance->raw_bit_count && instance->decoder.decode_count_bit < 64;
-         i += 2)
-    {
-        bool bit1 = kia_v5_get_raw_bit(instance, i);
-        bool bit2 = kia_v5_get_raw_bit(instance, i + 1);
-
-        uint8_t two_bits = (bit1 << 1) | bit2;
-
-        if (two_bits == 0x01)
-        { // 01 = decoded 1
-            instance->decoder.decode_data = (instance->decoder.decode_data << 1) | 1;
-            instance->decoder.decode_count_bit++;
-        }
-        else if (two_bits == 0x02)
-        { // 10 = decoded 0
-            instance->decoder.decode_data = (instance->decoder.decode_data << 1);
-            instance->decoder.decode_count_bit++;
-        }
-        else
-        {
-            break;
-        }
-    }
+    instance->decoder.decode_count_bit = protopirate_manchester_decode_halves(
+        &kia_v5_manchester,
+        instance->raw_bits,
+        instance->raw_bit_count,
+        kia_protocol_v5_const.min_count_bit_for_found,
+        &instance->decoder.decode_data);
 
     return instance->decoder.decode_count_bit >= kia_protocol_v5_const.min_count_bit_for_found;
 }
@@ -150,7 +124,6 @@ void kia_protocol_decoder_v5_reset(void *context)
     instance->decoder.parser_step = KiaV5DecoderStepReset;
     instance->header_count = 0;
     instance->raw_bit_count = 0;
-    memset(instance->raw_bits, 0, sizeof(instance->raw_bits));
 }
 
 void kia_protocol_decoder_v5_feed(void *context, bool level, uint32_t duration)
@@ -202,9 +175,14 @@ void kia_protocol_decoder_v5_feed(void *context, bool level, uint32_t duration)
             {
                 if (instance->header_count > 40)
                 {
+                    PROTOPIRATE_TRACE_EVENT(
+                        ProtoPirateTraceProtocolKiaV5,
+                        ProtoPirateTraceEventSync,
+                        KiaV5DecoderStepCheckPreamble,
+                        instance->header_count,
+                        duration);
                     instance->decoder.parser_step = KiaV5DecoderStepCollectRawBits;
                     instance->raw_bit_count = 0;
-                    memset(instance->raw_bits, 0, sizeof(instance->raw_bits));
                 }
                 else
                 {
@@ -251,41 +229,47 @@ void kia_protocol_decoder_v5_feed(void *context, bool level, uint32_t duration)
                 instance->generic.btn = (uint8_t)((yek >> 61) & 0x07); // Shift btn too
                 instance->generic.cnt = (uint16_t)(yek & 0xFFFF);
 
-                FURI_LOG_I(
-                    TAG,
-                    "Key=%08lX%08lX Sn=%07lX Btn=%X",
-                    (uint32_t)(instance->generic.data >> 32),
-                    (uint32_t)(instance->generic.data & 0xFFFFFFFF),
-                    instance->generic.serial,
-                    instance->generic.btn);
+                PROTOPIRATE_TRACE_EVENT(
+                    ProtoPirateTraceProtocolKiaV5,
+                    ProtoPirateTraceEventDecoded,
+                    KiaV5DecoderStepCollectRawBits,
+                    instance->generic.data_count_bit,
+                    duration);
 
                 if (instance->base.callback)
                     instance->base.callback(&instance->base, instance->base.context);
             }
+            else
+            {
+                PROTOPIRATE_TRACE_EVENT(
+                    ProtoPirateTraceProtocolKiaV5,
+                    ProtoPirateTraceEventEarlyEnd,
+                    KiaV5DecoderStepCollectRawBits,
+                    MIN(instance->raw_bit_count, 255),
+                    duration);
+            }
 
             instance->decoder.parser_step = KiaV5DecoderStepReset;
             break;
         }
 
-        int num_bits = 0;
-        if (DURATION_DIFF(duration, kia_protocol_v5_const.te_short) <
-            kia_protocol_v5_const.te_delta)
-        {
-            num_bits = 1;
-        }
-        else if (
-            DURATION_DIFF(duration, kia_protocol_v5_const.te_long) <
-            kia_protocol_v5_const.te_delta)
-        {
-            num_bits = 2;
-        }
-        else
+        ProtoPirateManchesterEvent event =
+            protopirate_manchester_event(&kia_v5_manchester, level, duration);
+        if (event == ProtoPirateManchesterEventNone)
         {
+            PROTOPIRATE_TRACE_EVENT(
+                ProtoPirateTraceProtocolKiaV5,
+                ProtoPirateTraceEventMismatch,
+                KiaV5DecoderStepCollectRawBits,
+                MIN(instance->raw_bit_count, 255),
+                duration);
             instance->decoder.parser_step = KiaV5DecoderStepReset;
             break;
         }
 
-        for (int i = 0; i < num_bits; i++)
+        // A long pulse is two half-bits of the same level
+        kia_v5_add_raw_bit(instance, level);
+        if (event >= ProtoPirateManchesterEventLongLow)
         {
             kia_v5_add_raw_bit(instance, level);
         }
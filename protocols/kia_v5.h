@@ -1,6 +1,7 @@
 #pragma once
 
 #include "kia_generic.h"
+#include "../helpers/protopirate_entry.h"
 
 #define KIA_PROTOCOL_V5_NAME "Kia V5"
 
@@ -10,6 +11,7 @@ typedef struct SubGhzProtocolEncoderKiaV5 SubGhzProtocolEncoderKiaV5;
 extern const SubGhzProtocolDecoder kia_protocol_v5_decoder;
 extern const SubGhzProtocolEncoder kia_protocol_v5_encoder;
 extern const SubGhzProtocol kia_protocol_v5;
+extern const ProtoPirateEntry kia_protocol_v5_entry;
 
 void* kia_protocol_decoder_v5_alloc(SubGhzEnvironment* environment);
 void kia_protocol_decoder_v5_free(void* context);
@@ -1,4 +1,6 @@
 #include "mazda.h"
+#include "../helpers/protopirate_trace.h"
+#include "../helpers/protopirate_manchester.h"
 
 #define TAG "MazdaProtocol"
 
@@ -9,6 +11,12 @@ static const SubGhzBlockConst subghz_protocol_mazda_const = {
     .min_count_bit_for_found = 64,
 };
 
+static const ProtoPirateManchester mazda_manchester = {
+    .block_const = &subghz_protocol_mazda_const,
+    .coding = ProtoPirateManchesterCodingMid,
+    .start = ManchesterStateMid1,
+};
+
 typedef struct SubGhzProtocolDecoderMazda
 {
     SubGhzProtocolDecoderBase base;
@@ -77,6 +85,20 @@ const SubGhzProtocol mazda_protocol = {
     .encoder = &subghz_protocol_mazda_encoder,
 };
 
+static uint64_t mazda_key_extra(const void *context)
+{
+    const SubGhzProtocolDecoderMazda *instance = context;
+    return instance->key2;
+}
+
+const ProtoPirateEntry mazda_protocol_entry = {
+    .block_const = &subghz_protocol_mazda_const,
+    .decoder_size = sizeof(SubGhzProtocolDecoderMazda),
+    .te = ProtoPirateEntryTeShort,
+    .level = ProtoPirateEntryLevelHigh,
+    .key_extra = mazda_key_extra,
+};
+
 static void mazda_add_bit(SubGhzProtocolDecoderMazda *instance, bool bit)
 {
     uint32_t low = (uint32_t)instance->data_low;
@@ -233,7 +255,7 @@ void subghz_protocol_decoder_mazda_feed(void *context, bool level, uint32_t dura
             instance->decoder.te_last = duration;
             instance->header_count = 0;
             instance->bit_count = 0;
-            manchester_advance(instance->manchester_state, ManchesterEventReset, &instance->manchester_state, NULL);
+            instance->manchester_state = mazda_manchester.start;
         }
         break;
 
@@ -279,6 +301,12 @@ void subghz_protocol_decoder_mazda_feed(void *context, bool level, uint32_t dura
             instance->data_high = 0;
             instance->bit_count = 1;
             instance->decoder.parser_step = MazdaDecoderStepData;
+            PROTOPIRATE_TRACE_EVENT(
+                ProtoPirateTraceProtocolMazda,
+                ProtoPirateTraceEventSync,
+                MazdaDecoderStepGap,
+                instance->header_count,
+                duration);
         }
         else if (!level && duration > gap_threshold + 250)
         {
@@ -288,24 +316,23 @@ void subghz_protocol_decoder_mazda_feed(void *context, bool level, uint32_t dura
 
     case MazdaDecoderStepData:
     {
-        ManchesterEvent event;
+        ProtoPirateManchesterEvent event =
+            protopirate_manchester_event(&mazda_manchester, level, duration);
 
-        if (DURATION_DIFF(duration, te_short) < te_delta)
-        {
-            event = level ? ManchesterEventShortLow : ManchesterEventShortHigh;
-        }
-        else if (DURATION_DIFF(duration, te_long) < te_delta)
-        {
-            event = level ? ManchesterEventLongLow : ManchesterEventLongHigh;
-        }
-        else
+        if (event == ProtoPirateManchesterEventNone)
         {
+            PROTOPIRATE_TRACE_EVENT(
+                ProtoPirateTraceProtocolMazda,
+                ProtoPirateTraceEventMismatch,
+                MazdaDecoderStepData,
+                instance->bit_count,
+                duration);
             instance->decoder.parser_step = MazdaDecoderStepReset;
             break;
         }
 
         bool data_bit;
-        if (manchester_advance(instance->manchester_state, event, &instance->manchester_state, &data_bit))
+        if (protopirate_manchester_advance(&mazda_manchester, &instance->manchester_state, event, &data_bit))
         {
             mazda_add_bit(instance, data_bit);
 
@@ -317,6 +344,13 @@ void subghz_protocol_decoder_mazda_feed(void *context, bool level, uint32_t dura
                 instance->generic.btn = instance->button;
                 instance->generic.cnt = instance->count;
 
+                PROTOPIRATE_TRACE_EVENT(
+                    ProtoPirateTraceProtocolMazda,
+                    ProtoPirateTraceEventDecoded,
+                    MazdaDecoderStepData,
+                    instance->bit_count,
+                    duration);
+
                 if (instance->base.callback)
                 {
                     instance->base.callback(&instance->base, instance->base.context);
@@ -10,10 +10,12 @@
 #include <lib/subghz/blocks/math.h>
 #include <flipper_format/flipper_format.h>
 #include <lib/toolbox/manchester_decoder.h>
+#include "../helpers/protopirate_entry.h"
 
 #define MAZDA_PROTOCOL_NAME "Mazda"
 
 extern const SubGhzProtocol mazda_protocol;
+extern const ProtoPirateEntry mazda_protocol_entry;
 
 void* subghz_protocol_decoder_mazda_alloc(SubGhzEnvironment* environment);
 void subghz_protocol_decoder_mazda_free(void* context);
@@ -1,4 +1,5 @@
 #include "mitsubishi.h"
+#include "../helpers/protopirate_pwm.h"
 
 #define TAG "SubGhzProtocolMitsubishi"
 
@@ -14,6 +15,7 @@ typedef struct SubGhzProtocolDecoderMitsubishi {
     SubGhzBlockDecoder decoder;
     SubGhzBlockGeneric generic;
     uint16_t header_count;
+    uint8_t high_class;
 } SubGhzProtocolDecoderMitsubishi;
 
 typedef struct SubGhzProtocolEncoderMitsubishi {
@@ -22,17 +24,11 @@ typedef struct SubGhzProtocolEncoderMitsubishi {
     SubGhzBlockGeneric generic;
 } SubGhzProtocolEncoderMitsubishi;
 
-typedef enum {
-    MitsubishiDecoderStepReset = 0,
-    MitsubishiDecoderStepCheckPreamble,
-    MitsubishiDecoderStepSaveDuration,
-    MitsubishiDecoderStepCheckDuration,
-} MitsubishiDecoderStep;
-
 static void subghz_protocol_decoder_mitsubishi_reset_internal(SubGhzProtocolDecoderMitsubishi* instance) {
     memset(&instance->decoder, 0, sizeof(instance->decoder));
     memset(&instance->generic, 0, sizeof(instance->generic));
-    instance->decoder.parser_step = MitsubishiDecoderStepReset;
+    instance->generic.protocol_name = instance->base.protocol->name;
+    instance->decoder.parser_step = ProtoPiratePwmStepReset;
     instance->header_count = 0;
 }
 
@@ -67,6 +63,14 @@ const SubGhzProtocol mitsubishi_protocol = {
     .encoder = &subghz_protocol_mitsubishi_encoder,
 };
 
+const ProtoPirateEntry mitsubishi_protocol_entry = {
+    .block_const = &subghz_protocol_mitsubishi_const,
+    .decoder_size = sizeof(SubGhzProtocolDecoderMitsubishi),
+    .te = ProtoPirateEntryTeShort,
+    .level = ProtoPirateEntryLevelHigh,
+    .feed_pulse = subghz_protocol_decoder_mitsubishi_feed_pulse,
+};
+
 // ----------------- Allocation / Reset / Free -------------------
 
 void* subghz_protocol_decoder_mitsubishi_alloc(SubGhzEnvironment* environment) {
@@ -92,7 +96,9 @@ void subghz_protocol_decoder_mitsubishi_reset(void* context) {
 // ----------------- Helper Functions -------------------
 
 // Parse Mitsubishi/KIA-Hyundai data structure
-static void subghz_protocol_mitsubishi_parse_data(SubGhzProtocolDecoderMitsubishi* instance) {
+static bool subghz_protocol_mitsubishi_parse_data(void* context) {
+    SubGhzProtocolDecoderMitsubishi* instance = context;
+
     // Structure similar to KIA/Hyundai protocol
     // Serial number in upper bits
     // Button code in middle bits
@@ -101,109 +107,39 @@ static void subghz_protocol_mitsubishi_parse_data(SubGhzProtocolDecoderMitsubish
     instance->generic.serial = (uint32_t)((instance->generic.data >> 32) & 0xFFFFFFFF);
     instance->generic.btn = (instance->generic.data >> 24) & 0xFF;
     instance->generic.cnt = (instance->generic.data >> 8) & 0xFFFF;
+    return true;
 }
 
 // ----------------- Decoder Feed -------------------
 
-void subghz_protocol_decoder_mitsubishi_feed(void* context, bool level, uint32_t duration) {
-    furi_assert(context);
-    SubGhzProtocolDecoderMitsubishi* instance = context;
-
-    switch(instance->decoder.parser_step) {
-    case MitsubishiDecoderStepReset:
-        if(level && (DURATION_DIFF(duration, subghz_protocol_mitsubishi_const.te_short) <
-                     subghz_protocol_mitsubishi_const.te_delta)) {
-            instance->decoder.parser_step = MitsubishiDecoderStepCheckPreamble;
-            instance->decoder.te_last = duration;
-            instance->header_count = 0;
-            instance->decoder.decode_data = 0;
-            instance->decoder.decode_count_bit = 0;
-        }
-        break;
-
-    case MitsubishiDecoderStepCheckPreamble:
-        if(level) {
-            if((DURATION_DIFF(duration, subghz_protocol_mitsubishi_const.te_short) <
-                subghz_protocol_mitsubishi_const.te_delta) ||
-               (DURATION_DIFF(duration, subghz_protocol_mitsubishi_const.te_long) <
-                subghz_protocol_mitsubishi_const.te_delta)) {
-                instance->decoder.te_last = duration;
-            } else {
-                instance->decoder.parser_step = MitsubishiDecoderStepReset;
-            }
-        } else {
-            if((DURATION_DIFF(duration, subghz_protocol_mitsubishi_const.te_short) <
-                subghz_protocol_mitsubishi_const.te_delta) &&
-               (DURATION_DIFF(instance->decoder.te_last, subghz_protocol_mitsubishi_const.te_short) <
-                subghz_protocol_mitsubishi_const.te_delta)) {
-                instance->header_count++;
-            } else if(
-                (DURATION_DIFF(duration, subghz_protocol_mitsubishi_const.te_long) <
-                 subghz_protocol_mitsubishi_const.te_delta) &&
-                (DURATION_DIFF(instance->decoder.te_last, subghz_protocol_mitsubishi_const.te_long) <
-                 subghz_protocol_mitsubishi_const.te_delta)) {
-                if(instance->header_count > 10) {
-                    instance->decoder.parser_step = MitsubishiDecoderStepSaveDuration;
-                    instance->decoder.decode_data = 0ULL;
-                    instance->decoder.decode_count_bit = 0;
-                } else {
-                    instance->decoder.parser_step = MitsubishiDecoderStepReset;
-                }
-            } else {
-                instance->decoder.parser_step = MitsubishiDecoderStepReset;
-            }
-        }
-        break;
-
-    case MitsubishiDecoderStepSaveDuration:
-        if(level) {
-            if(duration >= (subghz_protocol_mitsubishi_const.te_long * 3)) {
-                if(instance->decoder.decode_count_bit >=
-                   subghz_protocol_mitsubishi_const.min_count_bit_for_found) {
-                    instance->generic.data = instance->decoder.decode_data;
-                    instance->generic.data_count_bit = instance->decoder.decode_count_bit;
-
-                    // Parse Mitsubishi data
-                    subghz_protocol_mitsubishi_parse_data(instance);
+// Short pairs, a long pair as sync, then short-short 0 and long-long 1
+static const ProtoPiratePwm mitsubishi_pwm = {
+    .block_const = &subghz_protocol_mitsubishi_const,
+    .trace = ProtoPirateTraceProtocolMitsubishi,
+    .preamble_long = true,
+    .sync = PROTOPIRATE_PWM_LONG(subghz_protocol_mitsubishi_const),
+    .sync_after_long = true,
+    .sync_header_count = 11,
+    .zero =
+        {
+            .high = ProtoPiratePulseClassShort,
+            .low = ProtoPiratePulseClassShort,
+        },
+    .one =
+        {
+            .high = ProtoPiratePulseClassLong,
+            .low = ProtoPiratePulseClassLong,
+        },
+    .end = subghz_protocol_mitsubishi_const.te_long * 3,
+    .frame = subghz_protocol_mitsubishi_parse_data,
+};
 
-                    if(instance->base.callback) {
-                        instance->base.callback(&instance->base, instance->base.context);
-                    }
-                }
-                subghz_protocol_decoder_mitsubishi_reset_internal(instance);
-            } else {
-                instance->decoder.te_last = duration;
-                instance->decoder.parser_step = MitsubishiDecoderStepCheckDuration;
-            }
-        } else {
-            instance->decoder.parser_step = MitsubishiDecoderStepReset;
-        }
-        break;
+void subghz_protocol_decoder_mitsubishi_feed(void* context, bool level, uint32_t duration) {
+    protopirate_pwm_feed(&mitsubishi_pwm, context, level, duration);
+}
 
-    case MitsubishiDecoderStepCheckDuration:
-        if(!level) {
-            // Manchester-like decoding (KIA/Hyundai style)
-            if((DURATION_DIFF(instance->decoder.te_last, subghz_protocol_mitsubishi_const.te_short) <
-                subghz_protocol_mitsubishi_const.te_delta) &&
-               (DURATION_DIFF(duration, subghz_protocol_mitsubishi_const.te_short) <
-                subghz_protocol_mitsubishi_const.te_delta)) {
-                subghz_protocol_blocks_add_bit(&instance->decoder, 0);
-                instance->decoder.parser_step = MitsubishiDecoderStepSaveDuration;
-            } else if(
-                (DURATION_DIFF(instance->decoder.te_last, subghz_protocol_mitsubishi_const.te_long) <
-                 subghz_protocol_mitsubishi_const.te_delta) &&
-                (DURATION_DIFF(duration, subghz_protocol_mitsubishi_const.te_long) <
-                 subghz_protocol_mitsubishi_const.te_delta)) {
-                subghz_protocol_blocks_add_bit(&instance->decoder, 1);
-                instance->decoder.parser_step = MitsubishiDecoderStepSaveDuration;
-            } else {
-                instance->decoder.parser_step = MitsubishiDecoderStepReset;
-            }
-        } else {
-            instance->decoder.parser_step = MitsubishiDecoderStepReset;
-        }
-        break;
-    }
+void subghz_protocol_decoder_mitsubishi_feed_pulse(void* context, ProtoPiratePulse pulse) {
+    protopirate_pwm_feed_pulse(&mitsubishi_pwm, context, pulse);
 }
 
 // ----------------- API -------------------
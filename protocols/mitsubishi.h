@@ -9,15 +9,18 @@
 #include <lib/subghz/blocks/generic.h>
 #include <lib/subghz/blocks/math.h>
 #include <flipper_format/flipper_format.h>
+#include "../helpers/protopirate_entry.h"
 
 #define MITSUBISHI_PROTOCOL_NAME "Mitsubishi"
 
 extern const SubGhzProtocol mitsubishi_protocol;
+extern const ProtoPirateEntry mitsubishi_protocol_entry;
 
 void* subghz_protocol_decoder_mitsubishi_alloc(SubGhzEnvironment* environment);
 void subghz_protocol_decoder_mitsubishi_free(void* context);
 void subghz_protocol_decoder_mitsubishi_reset(void* context);
 void subghz_protocol_decoder_mitsubishi_feed(void* context, bool level, uint32_t duration);
+void subghz_protocol_decoder_mitsubishi_feed_pulse(void* context, ProtoPiratePulse pulse);
 uint8_t subghz_protocol_decoder_mitsubishi_get_hash_data(void* context);
 SubGhzProtocolStatus subghz_protocol_decoder_mitsubishi_serialize(
     void* context,
@@ -1,4 +1,5 @@
 #include "peugeot.h"
+#include "../helpers/protopirate_pwm.h"
 
 #define TAG "SubGhzProtocolPeugeot"
 
@@ -14,6 +15,7 @@ typedef struct SubGhzProtocolDecoderPeugeot {
     SubGhzBlockDecoder decoder;
     SubGhzBlockGeneric generic;
     uint16_t header_count;
+    uint8_t high_class;
     uint8_t packet_count;
 } SubGhzProtocolDecoderPeugeot;
 
@@ -23,17 +25,11 @@ typedef struct SubGhzProtocolEncoderPeugeot {
     SubGhzBlockGeneric generic;
 } SubGhzProtocolEncoderPeugeot;
 
-typedef enum {
-    PeugeotDecoderStepReset = 0,
-    PeugeotDecoderStepCheckPreamble,
-    PeugeotDecoderStepSaveDuration,
-    PeugeotDecoderStepCheckDuration,
-} PeugeotDecoderStep;
-
 static void subghz_protocol_decoder_peugeot_reset_internal(SubGhzProtocolDecoderPeugeot* instance) {
     memset(&instance->decoder, 0, sizeof(instance->decoder));
     memset(&instance->generic, 0, sizeof(instance->generic));
-    instance->decoder.parser_step = PeugeotDecoderStepReset;
+    instance->generic.protocol_name = instance->base.protocol->name;
+    instance->decoder.parser_step = ProtoPiratePwmStepReset;
     instance->header_count = 0;
     instance->packet_count = 0;
 }
@@ -69,6 +65,14 @@ const SubGhzProtocol peugeot_protocol = {
     .encoder = &subghz_protocol_peugeot_encoder,
 };
 
+const ProtoPirateEntry peugeot_protocol_entry = {
+    .block_const = &subghz_protocol_peugeot_const,
+    .decoder_size = sizeof(SubGhzProtocolDecoderPeugeot),
+    .te = ProtoPirateEntryTeShort,
+    .level = ProtoPirateEntryLevelHigh,
+    .feed_pulse = subghz_protocol_decoder_peugeot_feed_pulse,
+};
+
 // ----------------- Allocation / Reset / Free -------------------
 
 void* subghz_protocol_decoder_peugeot_alloc(SubGhzEnvironment* environment) {
@@ -102,7 +106,8 @@ static uint8_t reverse8(uint8_t byte) {
 }
 
 // Parse Keeloq data structure
-static bool subghz_protocol_peugeot_parse_data(SubGhzProtocolDecoderPeugeot* instance) {
+static bool subghz_protocol_peugeot_parse_data(void* context) {
+    SubGhzProtocolDecoderPeugeot* instance = context;
     uint8_t* b = (uint8_t*)&instance->generic.data;
     
     // Check preamble (first 12 bits should be 0xFFF)
@@ -131,112 +136,38 @@ static bool subghz_protocol_peugeot_parse_data(SubGhzProtocolDecoderPeugeot* ins
     instance->generic.btn = button_bits;
     instance->generic.cnt = (encrypted >> 16) & 0xFFFF; // Counter from encrypted part
     
+    instance->packet_count++;
     return true;
 }
 
 // ----------------- Decoder Feed -------------------
 
+// Warm-up of short pairs, a ~4400 us low, then short-long 0 and long-short 1
+static const ProtoPiratePwm peugeot_pwm = {
+    .block_const = &subghz_protocol_peugeot_const,
+    .trace = ProtoPirateTraceProtocolPeugeot,
+    .sync = PROTOPIRATE_PWM_WINDOW(4400, 500),
+    .sync_header_count = 10,
+    .zero =
+        {
+            .high = ProtoPiratePulseClassShort,
+            .low = ProtoPiratePulseClassLong,
+        },
+    .one =
+        {
+            .high = ProtoPiratePulseClassLong,
+            .low = ProtoPiratePulseClassShort,
+        },
+    .end = subghz_protocol_peugeot_const.te_long * 3,
+    .frame = subghz_protocol_peugeot_parse_data,
+};
+
 void subghz_protocol_decoder_peugeot_feed(void* context, bool level, uint32_t duration) {
-    furi_assert(context);
-    SubGhzProtocolDecoderPeugeot* instance = context;
+    protopirate_pwm_feed(&peugeot_pwm, context, level, duration);
+}
 
-    switch(instance->decoder.parser_step) {
-    case PeugeotDecoderStepReset:
-        if(level && (DURATION_DIFF(duration, subghz_protocol_peugeot_const.te_short) <
-                     subghz_protocol_peugeot_const.te_delta)) {
-            instance->decoder.parser_step = PeugeotDecoderStepCheckPreamble;
-            instance->decoder.te_last = duration;
-            instance->header_count = 0;
-            instance->decoder.decode_data = 0;
-            instance->decoder.decode_count_bit = 0;
-        }
-        break;
-
-    case PeugeotDecoderStepCheckPreamble:
-        if(level) {
-            // High level - save duration
-            if((DURATION_DIFF(duration, subghz_protocol_peugeot_const.te_short) <
-                subghz_protocol_peugeot_const.te_delta)) {
-                instance->decoder.te_last = duration;
-            } else {
-                instance->decoder.parser_step = PeugeotDecoderStepReset;
-            }
-        } else {
-            // Low level - check for warm-up pulses
-            if((DURATION_DIFF(duration, subghz_protocol_peugeot_const.te_short) <
-                subghz_protocol_peugeot_const.te_delta) &&
-               (DURATION_DIFF(instance->decoder.te_last, subghz_protocol_peugeot_const.te_short) <
-                subghz_protocol_peugeot_const.te_delta)) {
-                // Short pulse pair - part of warm-up
-                instance->header_count++;
-            } else if((DURATION_DIFF(duration, 4400) < 500) && instance->header_count >= 10) {
-                // Long gap after warm-up pulses (~4400µs)
-                instance->decoder.parser_step = PeugeotDecoderStepSaveDuration;
-                instance->decoder.decode_data = 0ULL;
-                instance->decoder.decode_count_bit = 0;
-            } else {
-                instance->decoder.parser_step = PeugeotDecoderStepReset;
-            }
-        }
-        break;
-
-    case PeugeotDecoderStepSaveDuration:
-        if(level) {
-            // High level - save duration
-            if(duration >= (subghz_protocol_peugeot_const.te_long * 3)) {
-                // Very long pulse - end of packet
-                if(instance->decoder.decode_count_bit >= 
-                   subghz_protocol_peugeot_const.min_count_bit_for_found) {
-                    
-                    instance->generic.data = instance->decoder.decode_data;
-                    instance->generic.data_count_bit = instance->decoder.decode_count_bit;
-
-                    // Parse the Keeloq structure
-                    if(subghz_protocol_peugeot_parse_data(instance)) {
-                        instance->packet_count++;
-                        
-                        // Call callback after receiving at least one packet
-                        if(instance->base.callback) {
-                            instance->base.callback(&instance->base, instance->base.context);
-                        }
-                    }
-                }
-                subghz_protocol_decoder_peugeot_reset_internal(instance);
-            } else {
-                instance->decoder.te_last = duration;
-                instance->decoder.parser_step = PeugeotDecoderStepCheckDuration;
-            }
-        } else {
-            instance->decoder.parser_step = PeugeotDecoderStepReset;
-        }
-        break;
-
-    case PeugeotDecoderStepCheckDuration:
-        if(!level) {
-            // PWM decoding: short-long = 0, long-short = 1
-            if((DURATION_DIFF(instance->decoder.te_last, subghz_protocol_peugeot_const.te_short) <
-                subghz_protocol_peugeot_const.te_delta) &&
-               (DURATION_DIFF(duration, subghz_protocol_peugeot_const.te_long) <
-                subghz_protocol_peugeot_const.te_delta)) {
-                // Short high, long low = 0
-                subghz_protocol_blocks_add_bit(&instance->decoder, 0);
-                instance->decoder.parser_step = PeugeotDecoderStepSaveDuration;
-            } else if(
-                (DURATION_DIFF(instance->decoder.te_last, subghz_protocol_peugeot_const.te_long) <
-                 subghz_protocol_peugeot_const.te_delta) &&
-                (DURATION_DIFF(duration, subghz_protocol_peugeot_const.te_short) <
-                 subghz_protocol_peugeot_const.te_delta)) {
-                // Long high, short low = 1
-                subghz_protocol_blocks_add_bit(&instance->decoder, 1);
-                instance->decoder.parser_step = PeugeotDecoderStepSaveDuration;
-            } else {
-                instance->decoder.parser_step = PeugeotDecoderStepReset;
-            }
-        } else {
-            instance->decoder.parser_step = PeugeotDecoderStepReset;
-        }
-        break;
-    }
+void subghz_protocol_decoder_peugeot_feed_pulse(void* context, ProtoPiratePulse pulse) {
+    protopirate_pwm_feed_pulse(&peugeot_pwm, context, pulse);
 }
 
 // ----------------- API -------------------
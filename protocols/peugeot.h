@@ -9,15 +9,18 @@
 #include <lib/subghz/blocks/generic.h>
 #include <lib/subghz/blocks/math.h>
 #include <flipper_format/flipper_format.h>
+#include "../helpers/protopirate_entry.h"
 
 #define PEUGEOT_PROTOCOL_NAME "Peugeot"
 
 extern const SubGhzProtocol peugeot_protocol;
+extern const ProtoPirateEntry peugeot_protocol_entry;
 
 void* subghz_protocol_decoder_peugeot_alloc(SubGhzEnvironment* environment);
 void subghz_protocol_decoder_peugeot_free(void* context);
 void subghz_protocol_decoder_peugeot_reset(void* context);
 void subghz_protocol_decoder_peugeot_feed(void* context, bool level, uint32_t duration);
+void subghz_protocol_decoder_peugeot_feed_pulse(void* context, ProtoPiratePulse pulse);
 uint8_t subghz_protocol_decoder_peugeot_get_hash_data(void* context);
 SubGhzProtocolStatus subghz_protocol_decoder_peugeot_serialize(
     void* context,
@@ -36,3 +36,38 @@ const SubGhzProtocolRegistry protopirate_protocol_registry = {
     .items = protopirate_protocol_registry_items,
     .size = COUNT_OF(protopirate_protocol_registry_items),
 };
+
+// How each decoder above starts a frame, same order as the registry
+const ProtoPirateEntry* protopirate_protocol_entries[] = {
+    // KIA/Hyundai family
+    &kia_protocol_v0_entry,
+    &kia_protocol_v1_entry,
+    &kia_protocol_v2_entry,
+    &kia_protocol_v3_v4_entry,
+    &kia_protocol_v5_entry,
+    &hyundai_protocol_entry,
+
+    // Asian manufacturers
+    &ford_protocol_v0_entry,
+    &subaru_protocol_entry,
+    &suzuki_protocol_entry,
+    &mazda_protocol_entry,
+    &honda_protocol_entry,
+    &mitsubishi_protocol_entry,
+
+    // European VAG Group
+    &vw_protocol_entry,
+
+    // European PSA Group
+    &peugeot_protocol_entry,
+    &citroen_protocol_entry,
+
+    // European BMW/Fiat
+    &bmw_protocol_entry,
+    &fiat_protocol_v0_entry,
+
+    // American
+
+};
+
+const size_t protopirate_protocol_entries_count = COUNT_OF(protopirate_protocol_entries);
@@ -35,3 +35,7 @@
 
 
 extern const SubGhzProtocolRegistry protopirate_protocol_registry;
+
+// Entry windows, indexed like protopirate_protocol_registry.items
+extern const ProtoPirateEntry* protopirate_protocol_entries[];
+extern const size_t protopirate_protocol_entries_count;
@@ -1,4 +1,5 @@
 #include "subaru.h"
+#include "../helpers/protopirate_trace.h"
 
 #define TAG "SubaruProtocol"
 
@@ -17,7 +18,7 @@ typedef struct SubGhzProtocolDecoderSubaru
 
     uint16_t header_count;
     uint16_t bit_count;
-    uint8_t data[8];
+    uint64_t data; // bits shifted in MSB first
 
     uint64_t key;
     uint32_t serial;
@@ -69,6 +70,13 @@ const SubGhzProtocol subaru_protocol = {
     .encoder = &subghz_protocol_subaru_encoder,
 };
 
+const ProtoPirateEntry subaru_protocol_entry = {
+    .block_const = &subghz_protocol_subaru_const,
+    .decoder_size = sizeof(SubGhzProtocolDecoderSubaru),
+    .te = ProtoPirateEntryTeLong,
+    .level = ProtoPirateEntryLevelHigh,
+};
+
 static void subaru_decode_count(const uint8_t *KB, uint16_t *count)
 {
     uint8_t lo = 0;
@@ -142,16 +150,7 @@ static void subaru_add_bit(SubGhzProtocolDecoderSubaru *instance, bool bit)
 {
     if (instance->bit_count < 64)
     {
-        uint8_t byte_idx = instance->bit_count / 8;
-        uint8_t bit_idx = 7 - (instance->bit_count % 8);
-        if (bit)
-        {
-            instance->data[byte_idx] |= (1 << bit_idx);
-        }
-        else
-        {
-            instance->data[byte_idx] &= ~(1 << bit_idx);
-        }
+        instance->data = (instance->data << 1) | bit;
         instance->bit_count++;
     }
 }
@@ -163,15 +162,16 @@ static bool subaru_process_data(SubGhzProtocolDecoderSubaru *instance)
         return false;
     }
 
-    uint8_t *b = instance->data;
+    instance->key = instance->data;
+    instance->serial = (instance->key >> 32) & 0xFFFFFF;
+    instance->button = (instance->key >> 56) & 0x0F;
 
-    instance->key = ((uint64_t)b[0] << 56) | ((uint64_t)b[1] << 48) |
-                    ((uint64_t)b[2] << 40) | ((uint64_t)b[3] << 32) |
-                    ((uint64_t)b[4] << 24) | ((uint64_t)b[5] << 16) |
-                    ((uint64_t)b[6] << 8) | ((uint64_t)b[7]);
-
-    instance->serial = ((uint32_t)b[1] << 16) | ((uint32_t)b[2] << 8) | b[3];
-    instance->button = b[0] & 0x0F;
+    // The counter is scrambled across the key bytes
+    uint8_t b[8];
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        b[i] = instance->key >> (56 - i * 8);
+    }
     subaru_decode_count(b, &instance->count);
 
     return true;
@@ -201,7 +201,42 @@ void subghz_protocol_decoder_subaru_reset(void *context)
     instance->decoder.te_last = 0;
     instance->header_count = 0;
     instance->bit_count = 0;
-    memset(instance->data, 0, sizeof(instance->data));
+    instance->data = 0;
+}
+
+// Gap after the data, decode whatever was collected
+static void subaru_end_packet(SubGhzProtocolDecoderSubaru *instance, uint32_t duration)
+{
+    if (instance->bit_count < 64)
+    {
+        PROTOPIRATE_TRACE_EVENT(
+            ProtoPirateTraceProtocolSubaru,
+            ProtoPirateTraceEventEarlyEnd,
+            SubaruDecoderStepSaveDuration,
+            instance->bit_count,
+            duration);
+    }
+    else if (subaru_process_data(instance))
+    {
+        instance->generic.data = instance->key;
+        instance->generic.data_count_bit = 64;
+        instance->generic.serial = instance->serial;
+        instance->generic.btn = instance->button;
+        instance->generic.cnt = instance->count;
+
+        PROTOPIRATE_TRACE_EVENT(
+            ProtoPirateTraceProtocolSubaru,
+            ProtoPirateTraceEventDecoded,
+            SubaruDecoderStepSaveDuration,
+            instance->bit_count,
+            duration);
+
+        if (instance->base.callback)
+        {
+            instance->base.callback(&instance->base, instance->base.context);
+        }
+    }
+    instance->decoder.parser_step = SubaruDecoderStepReset;
 }
 
 void subghz_protocol_decoder_subaru_feed(void *context, bool level, uint32_t duration)
@@ -273,7 +308,13 @@ void subghz_protocol_decoder_subaru_feed(void *context, bool level, uint32_t dur
         {
             instance->decoder.parser_step = SubaruDecoderStepSaveDuration;
             instance->bit_count = 0;
-            memset(instance->data, 0, sizeof(instance->data));
+            PROTOPIRATE_TRACE_EVENT(
+                ProtoPirateTraceProtocolSubaru,
+                ProtoPirateTraceEventSync,
+                SubaruDecoderStepFoundSync,
+                instance->header_count,
+                duration);
+            instance->data = 0;
         }
         else
         {
@@ -304,26 +345,16 @@ void subghz_protocol_decoder_subaru_feed(void *context, bool level, uint32_t dur
             else if (duration > 3000)
             {
                 // End of transmission
-                if (instance->bit_count >= 64)
-                {
-                    if (subaru_process_data(instance))
-                    {
-                        instance->generic.data = instance->key;
-                        instance->generic.data_count_bit = 64;
-                        instance->generic.serial = instance->serial;
-                        instance->generic.btn = instance->button;
-                        instance->generic.cnt = instance->count;
-
-                        if (instance->base.callback)
-                        {
-                            instance->base.callback(&instance->base, instance->base.context);
-                        }
-                    }
-                }
-                instance->decoder.parser_step = SubaruDecoderStepReset;
+                subaru_end_packet(instance, duration);
             }
             else
             {
+                PROTOPIRATE_TRACE_EVENT(
+                    ProtoPirateTraceProtocolSubaru,
+                    ProtoPirateTraceEventMismatch,
+                    SubaruDecoderStepSaveDuration,
+                    instance->bit_count,
+                    duration);
                 instance->decoder.parser_step = SubaruDecoderStepReset;
             }
         }
@@ -345,26 +376,16 @@ void subghz_protocol_decoder_subaru_feed(void *context, bool level, uint32_t dur
             else if (duration > 3000)
             {
                 // Gap - end of packet
-                if (instance->bit_count >= 64)
-                {
-                    if (subaru_process_data(instance))
-                    {
-                        instance->generic.data = instance->key;
-                        instance->generic.data_count_bit = 64;
-                        instance->generic.serial = instance->serial;
-                        instance->generic.btn = instance->button;
-                        instance->generic.cnt = instance->count;
-
-                        if (instance->base.callback)
-                        {
-                            instance->base.callback(&instance->base, instance->base.context);
-                        }
-                    }
-                }
-                instance->decoder.parser_step = SubaruDecoderStepReset;
+                subaru_end_packet(instance, duration);
             }
             else
             {
+                PROTOPIRATE_TRACE_EVENT(
+                    ProtoPirateTraceProtocolSubaru,
+                    ProtoPirateTraceEventMismatch,
+                    SubaruDecoderStepCheckDuration,
+                    instance->bit_count,
+                    duration);
                 instance->decoder.parser_step = SubaruDecoderStepReset;
             }
         }
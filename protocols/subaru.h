@@ -9,10 +9,12 @@
 #include <lib/subghz/blocks/generic.h>
 #include <lib/subghz/blocks/math.h>
 #include <flipper_format/flipper_format.h>
+#include "../helpers/protopirate_entry.h"
 
 #define SUBARU_PROTOCOL_NAME "Subaru"
 
 extern const SubGhzProtocol subaru_protocol;
+extern const ProtoPirateEntry subaru_protocol_entry;
 
 void* subghz_protocol_decoder_subaru_alloc(SubGhzEnvironment* environment);
 void subghz_protocol_decoder_subaru_free(void* context);
@@ -1,4 +1,5 @@
 #include "suzuki.h"
+#include "../helpers/protopirate_trace.h"
 
 #define TAG "SuzukiProtocol"
 
@@ -66,6 +67,14 @@ const SubGhzProtocol suzuki_protocol = {
     .encoder = &subghz_protocol_suzuki_encoder,
 };
 
+const ProtoPirateEntry suzuki_protocol_entry = {
+    .block_const = &subghz_protocol_suzuki_const,
+    .decoder_size = sizeof(SubGhzProtocolDecoderSuzuki),
+    .te = ProtoPirateEntryTeShort,
+    .level = ProtoPirateEntryLevelHigh,
+    .inclusive = true,
+};
+
 static void suzuki_add_bit(SubGhzProtocolDecoderSuzuki *instance, uint32_t bit)
 {
     uint32_t carry = instance->data_low >> 31;
@@ -140,6 +149,12 @@ void subghz_protocol_decoder_suzuki_feed(void *context, bool level, uint32_t dur
             {
                 instance->decoder.parser_step = SuzukiDecoderStepSaveDuration;
                 suzuki_add_bit(instance, 1);
+                PROTOPIRATE_TRACE_EVENT(
+                    ProtoPirateTraceProtocolSuzuki,
+                    ProtoPirateTraceEventSync,
+                    SuzukiDecoderStepFoundStartPulse,
+                    MIN(instance->header_count, 255),
+                    duration);
             }
             // Ignore short HIGHs after preamble until we see a long one
         }
@@ -173,6 +188,12 @@ void subghz_protocol_decoder_suzuki_feed(void *context, bool level, uint32_t dur
             }
             else
             {
+                PROTOPIRATE_TRACE_EVENT(
+                    ProtoPirateTraceProtocolSuzuki,
+                    ProtoPirateTraceEventMismatch,
+                    SuzukiDecoderStepSaveDuration,
+                    instance->data_count_bit,
+                    duration);
                 instance->decoder.parser_step = SuzukiDecoderStepReset;
             }
             // Stay in this state for next bit
@@ -199,12 +220,30 @@ void subghz_protocol_decoder_suzuki_feed(void *context, bool level, uint32_t dur
                         instance->generic.btn = serial_button & 0xF;
                         instance->generic.cnt = (data >> 44) & 0xFFFF;
 
+                        PROTOPIRATE_TRACE_EVENT(
+                            ProtoPirateTraceProtocolSuzuki,
+                            ProtoPirateTraceEventDecoded,
+                            SuzukiDecoderStepSaveDuration,
+                            instance->data_count_bit,
+                            duration);
+
                         if (instance->base.callback)
                         {
                             instance->base.callback(&instance->base, instance->base.context);
                         }
                     }
                 }
+                else
+                {
+                    PROTOPIRATE_TRACE_EVENT(
+                        ProtoPirateTraceProtocolSuzuki,
+                        PROTOPIRATE_TRACE_END_EVENT(
+                            instance->data_count_bit,
+                            subghz_protocol_suzuki_const.min_count_bit_for_found),
+                        SuzukiDecoderStepSaveDuration,
+                        instance->data_count_bit,
+                        duration);
+                }
                 instance->decoder.parser_step = SuzukiDecoderStepReset;
             }
             // Short LOW pulses are ignored - stay in this state
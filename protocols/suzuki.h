@@ -9,10 +9,12 @@
 #include <lib/subghz/blocks/generic.h>
 #include <lib/subghz/blocks/math.h>
 #include <flipper_format/flipper_format.h>
+#include "../helpers/protopirate_entry.h"
 
 #define SUZUKI_PROTOCOL_NAME "Suzuki"
 
 extern const SubGhzProtocol suzuki_protocol;
+extern const ProtoPirateEntry suzuki_protocol_entry;
 
 void* subghz_protocol_decoder_suzuki_alloc(SubGhzEnvironment* environment);
 void subghz_protocol_decoder_suzuki_free(void* context);
@@ -1,4 +1,6 @@
 #include "vw.h"
+#include "../helpers/protopirate_trace.h"
+#include "../helpers/protopirate_manchester.h"
 
 #define TAG "VWProtocol"
 
@@ -63,82 +65,27 @@ const SubGhzProtocol vw_protocol = {
     .encoder = &subghz_protocol_vw_encoder,
 };
 
-// Fixed manchester_advance for VW protocol
-static bool vw_manchester_advance(
-    ManchesterState state,
-    ManchesterEvent event,
-    ManchesterState *next_state,
-    bool *data)
+static uint64_t vw_key_extra(const void *context)
 {
+    const SubGhzProtocolDecoderVw *instance = context;
+    return instance->data_2;
+}
 
-    bool result = false;
-    ManchesterState new_state = ManchesterStateMid1;
-
-    if (event == ManchesterEventReset)
-    {
-        new_state = ManchesterStateMid1;
-    }
-    else if (state == ManchesterStateMid0 || state == ManchesterStateMid1)
-    {
-        if (event == ManchesterEventShortHigh)
-        {
-            new_state = ManchesterStateStart1;
-        }
-        else if (event == ManchesterEventShortLow)
-        {
-            new_state = ManchesterStateStart0;
-        }
-        else
-        {
-            new_state = ManchesterStateMid1;
-        }
-    }
-    else if (state == ManchesterStateStart1)
-    {
-        if (event == ManchesterEventShortLow)
-        {
-            new_state = ManchesterStateMid1;
-            result = true;
-            if (data)
-                *data = true;
-        }
-        else if (event == ManchesterEventLongLow)
-        {
-            new_state = ManchesterStateStart0;
-            result = true;
-            if (data)
-                *data = true;
-        }
-        else
-        {
-            new_state = ManchesterStateMid1;
-        }
-    }
-    else if (state == ManchesterStateStart0)
-    {
-        if (event == ManchesterEventShortHigh)
-        {
-            new_state = ManchesterStateMid0;
-            result = true;
-            if (data)
-                *data = false;
-        }
-        else if (event == ManchesterEventLongHigh)
-        {
-            new_state = ManchesterStateStart1;
-            result = true;
-            if (data)
-                *data = false;
-        }
-        else
-        {
-            new_state = ManchesterStateMid1;
-        }
-    }
+const ProtoPirateEntry vw_protocol_entry = {
+    .block_const = &subghz_protocol_vw_const,
+    .decoder_size = sizeof(SubGhzProtocolDecoderVw),
+    .te = ProtoPirateEntryTeShort,
+    .level = ProtoPirateEntryLevelAny,
+    .key_extra = vw_key_extra,
+};
 
-    *next_state = new_state;
-    return result;
-}
+// Bits end with their second half, the sync leaves the decoder in the first
+// half of a 1
+static const ProtoPirateManchester vw_manchester = {
+    .block_const = &subghz_protocol_vw_const,
+    .coding = ProtoPirateManchesterCodingEnd,
+    .start = ManchesterStateStart1,
+};
 
 static uint8_t vw_get_bit_index(uint8_t bit)
 {
@@ -206,6 +153,12 @@ static void vw_add_bit(SubGhzProtocolDecoderVw *instance, bool level)
 
     if (instance->generic.data_count_bit >= subghz_protocol_vw_const.min_count_bit_for_found)
     {
+        PROTOPIRATE_TRACE_EVENT(
+            ProtoPirateTraceProtocolVw,
+            ProtoPirateTraceEventDecoded,
+            VwDecoderStepFoundData,
+            instance->generic.data_count_bit,
+            0);
         if (instance->base.callback)
         {
             instance->base.callback(&instance->base, instance->base.context);
@@ -251,7 +204,7 @@ void subghz_protocol_decoder_vw_feed(void *context, bool level, uint32_t duratio
     uint32_t te_med = (te_long + te_short) / 2;
     uint32_t te_end = te_long * 5;
 
-    ManchesterEvent event = ManchesterEventReset;
+    ProtoPirateManchesterEvent event;
 
     switch (instance->decoder.parser_step)
     {
@@ -308,20 +261,17 @@ void subghz_protocol_decoder_vw_feed(void *context, bool level, uint32_t duratio
         if (level && DURATION_DIFF(duration, te_short) < te_delta)
         {
             // Start data collection
-            vw_manchester_advance(
-                instance->manchester_state,
-                ManchesterEventReset,
-                &instance->manchester_state,
-                NULL);
-            vw_manchester_advance(
-                instance->manchester_state,
-                ManchesterEventShortHigh,
-                &instance->manchester_state,
-                NULL);
+            instance->manchester_state = vw_manchester.start;
             instance->generic.data_count_bit = 0;
             instance->generic.data = 0;
             instance->data_2 = 0;
             instance->decoder.parser_step = VwDecoderStepFoundData;
+            PROTOPIRATE_TRACE_EVENT(
+                ProtoPirateTraceProtocolVw,
+                ProtoPirateTraceEventSync,
+                VwDecoderStepFoundStart3,
+                0,
+                duration);
             break;
         }
 
@@ -329,35 +279,34 @@ void subghz_protocol_decoder_vw_feed(void *context, bool level, uint32_t duratio
         break;
 
     case VwDecoderStepFoundData:
-        if (DURATION_DIFF(duration, te_short) < te_delta)
-        {
-            event = level ? ManchesterEventShortHigh : ManchesterEventShortLow;
-        }
-
-        if (DURATION_DIFF(duration, te_long) < te_delta)
-        {
-            event = level ? ManchesterEventLongHigh : ManchesterEventLongLow;
-        }
+        event = protopirate_manchester_event(&vw_manchester, level, duration);
 
         // Last bit can be arbitrarily long
         if (instance->generic.data_count_bit == subghz_protocol_vw_const.min_count_bit_for_found - 1 &&
             !level && duration > te_end)
         {
-            event = ManchesterEventShortLow;
+            event = ProtoPirateManchesterEventShortLow;
         }
 
-        if (event == ManchesterEventReset)
+        if (event == ProtoPirateManchesterEventNone)
         {
+            // A complete frame already went to the callback, this is just its end
+            if (instance->generic.data_count_bit < subghz_protocol_vw_const.min_count_bit_for_found)
+            {
+                PROTOPIRATE_TRACE_EVENT(
+                    ProtoPirateTraceProtocolVw,
+                    ProtoPirateTraceEventMismatch,
+                    VwDecoderStepFoundData,
+                    instance->generic.data_count_bit,
+                    duration);
+            }
             subghz_protocol_decoder_vw_reset(instance);
         }
         else
         {
             bool new_level;
-            if (vw_manchester_advance(
-                    instance->manchester_state,
-                    event,
-                    &instance->manchester_state,
-                    &new_level))
+            if (protopirate_manchester_advance(
+                    &vw_manchester, &instance->manchester_state, event, &new_level))
             {
                 vw_add_bit(instance, new_level);
             }
@@ -10,10 +10,12 @@
 #include <lib/subghz/blocks/math.h>
 #include <lib/toolbox/manchester_decoder.h>
 #include <flipper_format/flipper_format.h>
+#include "../helpers/protopirate_entry.h"
 
 #define VW_PROTOCOL_NAME "VW"
 
 extern const SubGhzProtocol vw_protocol;
+extern const ProtoPirateEntry vw_protocol_entry;
 
 void* subghz_protocol_decoder_vw_alloc(SubGhzEnvironment* environment);
 void subghz_protocol_decoder_vw_free(void* context);
@@ -77,6 +77,10 @@ ProtoPirateApp *protopirate_app_alloc()
     app->view_about = view_alloc();
     view_dispatcher_add_view(app->view_dispatcher, ProtoPirateViewAbout, app->view_about);
 
+    // Decoder Stats View
+    app->view_stats = view_alloc();
+    view_dispatcher_add_view(app->view_dispatcher, ProtoPirateViewStats, app->view_stats);
+
     // Receiver
     app->protopirate_receiver = protopirate_view_receiver_alloc();
     view_dispatcher_add_view(
@@ -105,6 +109,9 @@ ProtoPirateApp *protopirate_app_alloc()
     
     // Apply auto-save setting
     app->auto_save = settings.auto_save;
+    app->auto_save_log = settings.auto_save_log;
+    app->glitch_filter_us = settings.glitch_filter_us;
+    app->session_log = NULL;
 
     // Init Worker & Protocol & History
     app->lock = ProtoPirateLockOff;
@@ -154,7 +161,6 @@ ProtoPirateApp *protopirate_app_alloc()
     app->txrx->hopper_timeout = 0;
     app->txrx->idx_menu_chosen = 0;
 
-    app->txrx->history = protopirate_history_alloc();
     app->txrx->worker = subghz_worker_alloc();
 
     // Create environment with our custom protocols
@@ -164,9 +170,19 @@ ProtoPirateApp *protopirate_app_alloc()
     subghz_environment_set_protocol_registry(
         app->txrx->environment, (void *)&protopirate_protocol_registry);
 
+    app->txrx->history = protopirate_history_alloc(app->txrx->environment, app->setting);
+
     // Create receiver
     app->txrx->receiver = subghz_receiver_alloc_init(app->txrx->environment);
 
+    // The live RX path feeds our own decoder set so feed() can be timed per protocol,
+    // the receiver above is still used for decoder lookup by name
+    app->txrx->decoders = protopirate_decoder_set_alloc(app->txrx->environment);
+    protopirate_decoder_set_set_glitch_filter(app->txrx->decoders, app->glitch_filter_us);
+
+    // Decoded frames are formatted and saved off the worker thread
+    app->txrx->captures = protopirate_capture_queue_alloc(app->txrx->environment);
+
     // Initialize SubGhz devices
     subghz_devices_init();
 
@@ -204,10 +220,10 @@ ProtoPirateApp *protopirate_app_alloc()
 
     // Set up worker callbacks
     subghz_worker_set_overrun_callback(
-        app->txrx->worker, (SubGhzWorkerOverrunCallback)subghz_receiver_reset);
+        app->txrx->worker, (SubGhzWorkerOverrunCallback)protopirate_decoder_set_reset);
     subghz_worker_set_pair_callback(
-        app->txrx->worker, (SubGhzWorkerPairCallback)subghz_receiver_decode);
-    subghz_worker_set_context(app->txrx->worker, app->txrx->receiver);
+        app->txrx->worker, (SubGhzWorkerPairCallback)protopirate_decoder_set_feed);
+    subghz_worker_set_context(app->txrx->worker, app->txrx->decoders);
 
     furi_hal_power_suppress_charge_enter();
 
@@ -229,7 +245,9 @@ void protopirate_app_free(ProtoPirateApp *app)
     ProtoPirateSettings settings;
     settings.frequency = app->txrx->preset->frequency;
     settings.auto_save = app->auto_save;
+    settings.auto_save_log = app->auto_save_log;
     settings.hopping_enabled = (app->txrx->hopper_state != ProtoPirateHopperStateOFF);
+    settings.glitch_filter_us = app->glitch_filter_us;
     
     // Find current preset index
     settings.preset_index = 0;
@@ -275,6 +293,10 @@ void protopirate_app_free(ProtoPirateApp *app)
     view_dispatcher_remove_view(app->view_dispatcher, ProtoPirateViewAbout);
     view_free(app->view_about);
 
+    // Decoder Stats View
+    view_dispatcher_remove_view(app->view_dispatcher, ProtoPirateViewStats);
+    view_free(app->view_stats);
+
     // Widget
     view_dispatcher_remove_view(app->view_dispatcher, ProtoPirateViewWidget);
     widget_free(app->widget);
@@ -291,9 +313,14 @@ void protopirate_app_free(ProtoPirateApp *app)
     subghz_setting_free(app->setting);
 
     // Worker & Protocol & History
+    protopirate_capture_queue_free(app->txrx->captures);
+    if(app->session_log) {
+        protopirate_session_log_close(app->session_log);
+    }
+    protopirate_history_free(app->txrx->history);
+    protopirate_decoder_set_free(app->txrx->decoders);
     subghz_receiver_free(app->txrx->receiver);
     subghz_environment_free(app->txrx->environment);
-    protopirate_history_free(app->txrx->history);
     subghz_worker_free(app->txrx->worker);
     furi_string_free(app->txrx->preset->name);
     free(app->txrx->preset);
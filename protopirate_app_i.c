@@ -181,7 +181,7 @@ void protopirate_hopper_update(ProtoPirateApp *app)
     }
     if (app->txrx->txrx_state == ProtoPirateTxRxStateIDLE)
     {
-        subghz_receiver_reset(app->txrx->receiver);
+        protopirate_decoder_set_reset(app->txrx->decoders);
         app->txrx->preset->frequency =
             subghz_setting_get_hopper_frequency(app->setting, app->txrx->hopper_idx_frequency);
         protopirate_rx(app, app->txrx->preset->frequency);
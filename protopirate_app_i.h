@@ -8,6 +8,9 @@
 #include "views/protopirate_receiver_info.h"
 #include "protopirate_history.h"
 #include "helpers/radio_device_loader.h"
+#include "helpers/protopirate_decoder_set.h"
+#include "helpers/protopirate_capture_queue.h"
+#include "helpers/protopirate_session_log.h"
 
 #include <gui/gui.h>
 #include <gui/view_dispatcher.h>
@@ -30,6 +33,8 @@ typedef struct
     SubGhzWorker *worker;
     SubGhzEnvironment *environment;
     SubGhzReceiver *receiver;
+    ProtoPirateDecoderSet *decoders;
+    ProtoPirateCaptureQueue *captures;
     SubGhzRadioPreset *preset;
     ProtoPirateHistory *history;
     const SubGhzDevice *radio_device;
@@ -38,7 +43,7 @@ typedef struct
     ProtoPirateRxKeyState rx_key_state;
     uint8_t hopper_idx_frequency;
     uint8_t hopper_timeout;
-    uint16_t idx_menu_chosen;
+    uint32_t idx_menu_chosen; // history sequence number
 } ProtoPirateTxRx;
 
 struct ProtoPirateApp
@@ -51,6 +56,7 @@ struct ProtoPirateApp
     Submenu *submenu;
     Widget *widget;
     View *view_about;
+    View *view_stats;
     ProtoPirateReceiver *protopirate_receiver;
     ProtoPirateReceiverInfo *protopirate_receiver_info;
     ProtoPirateTxRx *txrx;
@@ -58,6 +64,9 @@ struct ProtoPirateApp
     ProtoPirateLock lock;
     FuriString *loaded_file_path;
     bool auto_save;
+    bool auto_save_log;
+    uint32_t glitch_filter_us; // live worker and RAW decode, 0 for off
+    ProtoPirateSessionLog *session_log; // open from receiver enter until Back
     ProtoPirateSettings settings;
 };
 
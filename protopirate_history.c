@@ -1,70 +1,141 @@
 // protopirate_history.c
 #include "protopirate_history.h"
+#include "protocols/protocol_items.h"
 #include <lib/subghz/receiver.h>
+#include <lib/subghz/blocks/decoder.h>
+#include <lib/subghz/blocks/generic.h>
 #include <flipper_format/flipper_format_i.h>
+#include <toolbox/stream/stream.h>
 
 #define TAG "ProtoPirateHistory"
 
+#define HISTORY_ALIGN(x) (((x) + 7) & ~(size_t)7)
+
+// A key heard again within this long of its last frame counts as a repeat
+#define HISTORY_DEDUP_WINDOW_MS 500
+#define HISTORY_DEDUP_SIZE      8
+
+// Each slot is this header followed by the decoder state, everything of the
+// decoder struct behind its SubGhzProtocolDecoderBase: bit count, key, serial,
+// button, counter and whatever else the protocol's get_string/serialize use
 typedef struct {
-    FuriString* item_str;
-    FlipperFormat* flipper_format;
-    uint8_t type;
-    SubGhzRadioPreset* preset;
-} ProtoPirateHistoryItem;
+    uint32_t frequency;
+    uint32_t tick;
+    uint8_t protocol; // registry index
+    uint8_t preset; // SubGhzSetting preset index
+    int8_t rssi; // dBm when the frame was processed
+    uint16_t repeats; // frames merged into this one by the dedup table
+} ProtoPirateHistoryRecord;
+
+// Every registry decoder starts like this, the key fields of generic are what
+// a repeated frame has in common with the first one
+typedef struct {
+    SubGhzProtocolDecoderBase base;
+    SubGhzBlockDecoder decoder;
+    SubGhzBlockGeneric generic;
+} ProtoPirateHistoryDecoderHead;
 
-ARRAY_DEF(ProtoPirateHistoryItemArray, ProtoPirateHistoryItem, M_POD_OPLIST)
+// A key seen recently and the history item it went to
+typedef struct {
+    uint64_t data;
+    uint64_t extra; // key_extra of the protocol's entry, 0 without one
+    uint32_t serial;
+    uint32_t cnt;
+    uint16_t data_count_bit;
+    uint8_t btn;
+    uint8_t protocol;
+    uint32_t tick; // last frame, 0 for an unused entry
+    uint32_t seq;
+} ProtoPirateHistoryDedup;
 
 struct ProtoPirateHistory {
-    ProtoPirateHistoryItemArray_t data;
+    uint8_t* arena; // KIA_HISTORY_MAX slots, item seq in slot seq % KIA_HISTORY_MAX
+    size_t slot_size;
+    size_t state_offset;
+    uint32_t first_seq; // oldest item kept
+    uint32_t next_seq; // given to the next item added
     uint16_t last_index;
-    uint32_t last_update_timestamp;
-    uint8_t code_last_hash_data;
+    ProtoPirateHistoryDedup dedup[HISTORY_DEDUP_SIZE];
+
+    SubGhzEnvironment* environment;
+    SubGhzSetting* setting;
+    // Render decoders by registry index, allocated the first time one is needed
+    SubGhzProtocolDecoderBase** decoders;
+    FuriString* preset_name;
+    FuriMutex* mutex;
 };
 
-ProtoPirateHistory* protopirate_history_alloc(void) {
+ProtoPirateHistory* protopirate_history_alloc(SubGhzEnvironment* environment, SubGhzSetting* setting) {
     ProtoPirateHistory* instance = malloc(sizeof(ProtoPirateHistory));
-    ProtoPirateHistoryItemArray_init(instance->data);
+    size_t size = protopirate_protocol_registry.size;
+    furi_check(size == protopirate_protocol_entries_count);
+
+    size_t max_state_size = 0;
+    for(size_t i = 0; i < size; i++) {
+        size_t state_size =
+            protopirate_protocol_entries[i]->decoder_size - sizeof(SubGhzProtocolDecoderBase);
+        max_state_size = MAX(max_state_size, state_size);
+    }
+
+    instance->state_offset = HISTORY_ALIGN(sizeof(ProtoPirateHistoryRecord));
+    instance->slot_size = HISTORY_ALIGN(instance->state_offset + max_state_size);
+    instance->arena = malloc(instance->slot_size * KIA_HISTORY_MAX);
+    instance->first_seq = 0;
+    instance->next_seq = 0;
     instance->last_index = 0;
+    memset(instance->dedup, 0, sizeof(instance->dedup));
+
+    instance->environment = environment;
+    instance->setting = setting;
+    instance->decoders = malloc(sizeof(SubGhzProtocolDecoderBase*) * size);
+    for(size_t i = 0; i < size; i++) {
+        instance->decoders[i] = NULL;
+    }
+    instance->preset_name = furi_string_alloc();
+    instance->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+
+    FURI_LOG_I(
+        TAG, "%u slots of %zu bytes", KIA_HISTORY_MAX, instance->slot_size);
     return instance;
 }
 
 void protopirate_history_free(ProtoPirateHistory* instance) {
     furi_assert(instance);
-    for(size_t i = 0; i < ProtoPirateHistoryItemArray_size(instance->data); i++) {
-        ProtoPirateHistoryItem* item = ProtoPirateHistoryItemArray_get(instance->data, i);
-        furi_string_free(item->item_str);
-        flipper_format_free(item->flipper_format);
-        if(item->preset) {
-            if(item->preset->name) {
-                furi_string_free(item->preset->name);
-            }
-            free(item->preset);
+    for(size_t i = 0; i < protopirate_protocol_registry.size; i++) {
+        if(instance->decoders[i]) {
+            protopirate_protocol_registry.items[i]->decoder->free(instance->decoders[i]);
         }
     }
-    ProtoPirateHistoryItemArray_clear(instance->data);
+    free(instance->decoders);
+    furi_string_free(instance->preset_name);
+    furi_mutex_free(instance->mutex);
+    free(instance->arena);
     free(instance);
 }
 
 void protopirate_history_reset(ProtoPirateHistory* instance) {
     furi_assert(instance);
-    for(size_t i = 0; i < ProtoPirateHistoryItemArray_size(instance->data); i++) {
-        ProtoPirateHistoryItem* item = ProtoPirateHistoryItemArray_get(instance->data, i);
-        furi_string_free(item->item_str);
-        flipper_format_free(item->flipper_format);
-        if(item->preset) {
-            if(item->preset->name) {
-                furi_string_free(item->preset->name);
-            }
-            free(item->preset);
-        }
-    }
-    ProtoPirateHistoryItemArray_reset(instance->data);
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
+    // Sequence numbers carry on, one handed out before never comes back
+    instance->first_seq = instance->next_seq;
     instance->last_index = 0;
+    memset(instance->dedup, 0, sizeof(instance->dedup));
+    furi_mutex_release(instance->mutex);
 }
 
 uint16_t protopirate_history_get_item(ProtoPirateHistory* instance) {
     furi_assert(instance);
-    return ProtoPirateHistoryItemArray_size(instance->data);
+    return instance->next_seq - instance->first_seq;
+}
+
+uint32_t protopirate_history_get_first_seq(ProtoPirateHistory* instance) {
+    furi_assert(instance);
+    return instance->first_seq;
+}
+
+uint32_t protopirate_history_get_next_seq(ProtoPirateHistory* instance) {
+    furi_assert(instance);
+    return instance->next_seq;
 }
 
 uint16_t protopirate_history_get_last_index(ProtoPirateHistory* instance) {
@@ -72,162 +143,272 @@ uint16_t protopirate_history_get_last_index(ProtoPirateHistory* instance) {
     return instance->last_index;
 }
 
-// Helper function to free a single history item's resources
-static void protopirate_history_item_free(ProtoPirateHistoryItem* item) {
-    if(item->item_str) {
-        furi_string_free(item->item_str);
-        item->item_str = NULL;
+static bool protopirate_history_has(ProtoPirateHistory* instance, uint32_t seq) {
+    // Unsigned, an evicted seq wraps around to a large offset
+    return seq - instance->first_seq < instance->next_seq - instance->first_seq;
+}
+
+static uint8_t* protopirate_history_slot(ProtoPirateHistory* instance, uint32_t seq) {
+    return instance->arena + (seq % KIA_HISTORY_MAX) * instance->slot_size;
+}
+
+static uint8_t protopirate_history_preset_index(ProtoPirateHistory* instance, const char* name) {
+    size_t count = subghz_setting_get_preset_count(instance->setting);
+    for(size_t i = 0; i < count; i++) {
+        if(strcmp(subghz_setting_get_preset_name(instance->setting, i), name) == 0) {
+            return i;
+        }
     }
-    if(item->flipper_format) {
-        flipper_format_free(item->flipper_format);
-        item->flipper_format = NULL;
+    FURI_LOG_W(TAG, "Preset %s not in settings, storing the first one", name);
+    return 0;
+}
+
+// Copies the stored state of item seq into the render decoder of its protocol.
+// Call with the mutex held, the decoder is shared by all items of a protocol.
+static SubGhzProtocolDecoderBase*
+    protopirate_history_restore(ProtoPirateHistory* instance, uint32_t seq) {
+    const uint8_t* slot = protopirate_history_slot(instance, seq);
+    const ProtoPirateHistoryRecord* record = (const ProtoPirateHistoryRecord*)slot;
+
+    SubGhzProtocolDecoderBase* decoder = instance->decoders[record->protocol];
+    if(!decoder) {
+        const SubGhzProtocol* protocol = protopirate_protocol_registry.items[record->protocol];
+        decoder = protocol->decoder->alloc(instance->environment);
+        instance->decoders[record->protocol] = decoder;
     }
-    if(item->preset) {
-        if(item->preset->name) {
-            furi_string_free(item->preset->name);
+
+    memcpy(
+        (uint8_t*)decoder + sizeof(SubGhzProtocolDecoderBase),
+        slot + instance->state_offset,
+        protopirate_protocol_entries[record->protocol]->decoder_size -
+            sizeof(SubGhzProtocolDecoderBase));
+    return decoder;
+}
+
+// Key words of decoder beyond its generic fields
+static uint64_t protopirate_history_key_extra(const void* decoder, uint8_t protocol) {
+    const ProtoPirateEntry* entry = protopirate_protocol_entries[protocol];
+    return entry->key_extra ? entry->key_extra(decoder) : 0;
+}
+
+// Entry for the key of decoder, either the live one it was last heard in or
+// the one to reuse for it. Call with the mutex held.
+static ProtoPirateHistoryDedup* protopirate_history_dedup_find(
+    ProtoPirateHistory* instance,
+    const ProtoPirateHistoryDecoderHead* decoder,
+    uint8_t protocol,
+    uint64_t extra,
+    uint32_t tick,
+    bool* found) {
+    const SubGhzBlockGeneric* generic = &decoder->generic;
+    ProtoPirateHistoryDedup* oldest = &instance->dedup[0];
+    *found = false;
+
+    for(size_t i = 0; i < HISTORY_DEDUP_SIZE; i++) {
+        ProtoPirateHistoryDedup* entry = &instance->dedup[i];
+        if(entry->tick && tick - entry->tick < HISTORY_DEDUP_WINDOW_MS &&
+           entry->protocol == protocol && entry->data == generic->data &&
+           entry->extra == extra &&
+           entry->data_count_bit == generic->data_count_bit &&
+           entry->serial == generic->serial && entry->btn == generic->btn &&
+           entry->cnt == generic->cnt) {
+            *found = true;
+            return entry;
+        }
+        if(!entry->tick || tick - entry->tick > tick - oldest->tick) {
+            oldest = entry;
         }
-        free(item->preset);
-        item->preset = NULL;
     }
+    return oldest;
 }
 
-bool protopirate_history_add_to_history(
+ProtoPirateHistoryStateAddKey protopirate_history_add_to_history(
     ProtoPirateHistory* instance,
     void* context,
-    SubGhzRadioPreset* preset) {
+    SubGhzRadioPreset* preset,
+    int8_t rssi,
+    uint32_t* seq) {
     furi_assert(instance);
     furi_assert(context);
+    furi_assert(seq);
 
     SubGhzProtocolDecoderBase* decoder_base = context;
 
-    // Check for duplicate (same hash within 500ms)
-    if((instance->code_last_hash_data ==
-        subghz_protocol_decoder_base_get_hash_data(decoder_base)) &&
-       ((furi_get_tick() - instance->last_update_timestamp) < 500)) {
-        instance->last_update_timestamp = furi_get_tick();
-        return false;
+    size_t protocol = 0;
+    while(protocol < protopirate_protocol_registry.size &&
+          protopirate_protocol_registry.items[protocol] != decoder_base->protocol) {
+        protocol++;
+    }
+    if(protocol == protopirate_protocol_registry.size) {
+        FURI_LOG_E(TAG, "%s is not a registry protocol", decoder_base->protocol->name);
+        return ProtoPirateHistoryStateAddKeyUnknown;
     }
 
-    // If history is full, remove the oldest entry
-    if(ProtoPirateHistoryItemArray_size(instance->data) >= KIA_HISTORY_MAX) {
-        ProtoPirateHistoryItem* oldest = ProtoPirateHistoryItemArray_get(instance->data, 0);
-        if(oldest) {
-            protopirate_history_item_free(oldest);
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
+
+    // Same key as a frame a moment ago: count it on that item, unless the item
+    // was evicted meanwhile
+    uint32_t tick = furi_get_tick() | 1;
+    bool found;
+    uint64_t extra = protopirate_history_key_extra(decoder_base, protocol);
+    ProtoPirateHistoryDedup* dedup = protopirate_history_dedup_find(
+        instance,
+        (const ProtoPirateHistoryDecoderHead*)decoder_base,
+        protocol,
+        extra,
+        tick,
+        &found);
+    dedup->tick = tick;
+    if(found && protopirate_history_has(instance, dedup->seq)) {
+        ProtoPirateHistoryRecord* record =
+            (ProtoPirateHistoryRecord*)protopirate_history_slot(instance, dedup->seq);
+        if(record->repeats < UINT16_MAX) {
+            record->repeats++;
         }
-        ProtoPirateHistoryItemArray_pop_at(NULL, instance->data, 0);
-        FURI_LOG_D(TAG, "History full, removed oldest entry");
+        *seq = dedup->seq;
+        furi_mutex_release(instance->mutex);
+        return ProtoPirateHistoryStateAddKeyRepeat;
     }
 
-    instance->code_last_hash_data = subghz_protocol_decoder_base_get_hash_data(decoder_base);
-    instance->last_update_timestamp = furi_get_tick();
-
-    // Create a new history item
-    ProtoPirateHistoryItem* item = ProtoPirateHistoryItemArray_push_raw(instance->data);
-    item->item_str = furi_string_alloc();
-    item->flipper_format = flipper_format_string_alloc();
-    item->type = 0;
-
-    // Copy preset
-    item->preset = malloc(sizeof(SubGhzRadioPreset));
-    item->preset->frequency = preset->frequency;
-    item->preset->name = furi_string_alloc();
-    furi_string_set(item->preset->name, preset->name);
-    item->preset->data = preset->data;
-    item->preset->data_size = preset->data_size;
-
-    // Get string representation
-    FuriString* text = furi_string_alloc();
-    subghz_protocol_decoder_base_get_string(decoder_base, text);
-    furi_string_set(item->item_str, text);
-
-    // Serialize to flipper format
-    subghz_protocol_decoder_base_serialize(decoder_base, item->flipper_format, preset);
-    
-    // Debug: Log what we're adding to history
-    flipper_format_rewind(item->flipper_format);
-    uint32_t debug_bit_count;
-    FuriString* debug_protocol = furi_string_alloc();
-    if (flipper_format_read_string(item->flipper_format, "Protocol", debug_protocol)) {
-        FURI_LOG_I(TAG, "History add - Protocol: %s", furi_string_get_cstr(debug_protocol));
-    }
-    flipper_format_rewind(item->flipper_format);
-    if (flipper_format_read_uint32(item->flipper_format, "Bit", &debug_bit_count, 1)) {
-        FURI_LOG_I(TAG, "History add - Bit count: %lu", debug_bit_count);
+    const SubGhzBlockGeneric* generic =
+        &((const ProtoPirateHistoryDecoderHead*)decoder_base)->generic;
+    dedup->data = generic->data;
+    dedup->extra = extra;
+    dedup->serial = generic->serial;
+    dedup->cnt = generic->cnt;
+    dedup->data_count_bit = generic->data_count_bit;
+    dedup->btn = generic->btn;
+    dedup->protocol = protocol;
+    dedup->seq = instance->next_seq;
+
+    // If history is full, the oldest entry's slot is the one written next
+    if(instance->next_seq - instance->first_seq >= KIA_HISTORY_MAX) {
+        instance->first_seq++;
+        FURI_LOG_D(TAG, "History full, removed oldest entry");
     }
-    furi_string_free(debug_protocol);
-
-    furi_string_free(text);
 
+    uint8_t* slot = protopirate_history_slot(instance, instance->next_seq);
+    ProtoPirateHistoryRecord* record = (ProtoPirateHistoryRecord*)slot;
+    record->frequency = preset->frequency;
+    record->tick = tick;
+    record->protocol = protocol;
+    record->preset =
+        protopirate_history_preset_index(instance, furi_string_get_cstr(preset->name));
+    record->rssi = rssi;
+    record->repeats = 1;
+    memcpy(
+        slot + instance->state_offset,
+        (const uint8_t*)decoder_base + sizeof(SubGhzProtocolDecoderBase),
+        protopirate_protocol_entries[protocol]->decoder_size - sizeof(SubGhzProtocolDecoderBase));
+
+    *seq = instance->next_seq++;
     instance->last_index++;
 
-    FURI_LOG_I(TAG, "Added item %u to history (size: %zu)",
+    furi_mutex_release(instance->mutex);
+
+    FURI_LOG_I(TAG, "Added item %u to history (size: %lu)",
                instance->last_index,
-               ProtoPirateHistoryItemArray_size(instance->data));
+               instance->next_seq - instance->first_seq);
 
-    return true;
+    return ProtoPirateHistoryStateAddKeyNewData;
+}
+
+uint16_t protopirate_history_get_repeats(ProtoPirateHistory* instance, uint32_t seq) {
+    furi_assert(instance);
+    uint16_t repeats = 0;
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
+    if(protopirate_history_has(instance, seq)) {
+        repeats = ((const ProtoPirateHistoryRecord*)protopirate_history_slot(instance, seq))
+                      ->repeats;
+    }
+    furi_mutex_release(instance->mutex);
+    return repeats;
 }
 
 void protopirate_history_get_text_item_menu(
     ProtoPirateHistory* instance,
     FuriString* output,
-    uint16_t idx) {
+    uint32_t seq) {
     furi_assert(instance);
     furi_assert(output);
 
-    if(idx >= ProtoPirateHistoryItemArray_size(instance->data)) {
-        furi_string_set(output, "---");
-        return;
-    }
-
-    ProtoPirateHistoryItem* item = ProtoPirateHistoryItemArray_get(instance->data, idx);
+    protopirate_history_get_text_item(instance, output, seq);
 
-    // Get just the first line for the menu
-    const char* str = furi_string_get_cstr(item->item_str);
-    const char* newline = strchr(str, '\r');
-    if(newline) {
-        size_t len = newline - str;
-        furi_string_set_strn(output, str, len);
-    } else {
-        newline = strchr(str, '\n');
-        if(newline) {
-            size_t len = newline - str;
-            furi_string_set_strn(output, str, len);
-        } else {
-            furi_string_set(output, item->item_str);
-        }
+    // Just the first line for the menu
+    size_t newline = furi_string_search_char(output, '\r');
+    if(newline == FURI_STRING_FAILURE) {
+        newline = furi_string_search_char(output, '\n');
+    }
+    if(newline != FURI_STRING_FAILURE) {
+        furi_string_left(output, newline);
     }
 }
 
 void protopirate_history_get_text_item(
     ProtoPirateHistory* instance,
     FuriString* output,
-    uint16_t idx) {
+    uint32_t seq) {
     furi_assert(instance);
     furi_assert(output);
 
-    if(idx >= ProtoPirateHistoryItemArray_size(instance->data)) {
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
+    if(!protopirate_history_has(instance, seq)) {
         furi_string_set(output, "---");
-        return;
+    } else {
+        furi_string_reset(output);
+        subghz_protocol_decoder_base_get_string(
+            protopirate_history_restore(instance, seq), output);
+
+        const ProtoPirateHistoryRecord* record =
+            (const ProtoPirateHistoryRecord*)protopirate_history_slot(instance, seq);
+        if(record->repeats > 1) {
+            size_t size = furi_string_size(output);
+            if(size && furi_string_get_char(output, size - 1) != '\n') {
+                furi_string_cat_str(output, "\r\n");
+            }
+            furi_string_cat_printf(output, "x%u repeats\r\n", record->repeats);
+        }
     }
-
-    ProtoPirateHistoryItem* item = ProtoPirateHistoryItemArray_get(instance->data, idx);
-    furi_string_set(output, item->item_str);
+    furi_mutex_release(instance->mutex);
 }
 
 SubGhzProtocolDecoderBase*
-    protopirate_history_get_decoder_base(ProtoPirateHistory* instance, uint16_t idx) {
+    protopirate_history_get_decoder_base(ProtoPirateHistory* instance, uint32_t seq) {
     UNUSED(instance);
-    UNUSED(idx);
+    UNUSED(seq);
     return NULL;
 }
 
-FlipperFormat* protopirate_history_get_raw_data(ProtoPirateHistory* instance, uint16_t idx) {
+bool protopirate_history_get_raw_data(
+    ProtoPirateHistory* instance,
+    uint32_t seq,
+    FlipperFormat* output) {
     furi_assert(instance);
+    furi_assert(output);
 
-    if(idx >= ProtoPirateHistoryItemArray_size(instance->data)) {
-        return NULL;
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
+    bool result = protopirate_history_has(instance, seq);
+
+    if(result) {
+        const ProtoPirateHistoryRecord* record =
+            (const ProtoPirateHistoryRecord*)protopirate_history_slot(instance, seq);
+
+        furi_string_set_str(
+            instance->preset_name,
+            subghz_setting_get_preset_name(instance->setting, record->preset));
+        SubGhzRadioPreset preset = {
+            .name = instance->preset_name,
+            .frequency = record->frequency,
+            .data = subghz_setting_get_preset_data(instance->setting, record->preset),
+            .data_size = subghz_setting_get_preset_data_size(instance->setting, record->preset),
+        };
+
+        stream_clean(flipper_format_get_raw_stream(output));
+        result = subghz_protocol_decoder_base_serialize(
+                     protopirate_history_restore(instance, seq), output, &preset) ==
+                 SubGhzProtocolStatusOk;
     }
 
-    ProtoPirateHistoryItem* item = ProtoPirateHistoryItemArray_get(instance->data, idx);
-    return item->flipper_format;
-}
\ No newline at end of file
+    furi_mutex_release(instance->mutex);
+    return result;
+}
@@ -3,28 +3,58 @@
 
 #include <lib/subghz/receiver.h>
 #include <lib/subghz/protocols/base.h>
+#include <lib/subghz/subghz_setting.h>
 
-#define KIA_HISTORY_MAX 50
+// Fixed-size records in one arena allocated up front, about the RAM 50 heap
+// items used to take. Used as a ring, once full every new item replaces the
+// oldest one.
+#define KIA_HISTORY_MAX 256
 
 typedef struct ProtoPirateHistory ProtoPirateHistory;
 
-ProtoPirateHistory* protopirate_history_alloc(void);
+typedef enum {
+    ProtoPirateHistoryStateAddKeyUnknown, // not a registry protocol, dropped
+    ProtoPirateHistoryStateAddKeyNewData,
+    ProtoPirateHistoryStateAddKeyRepeat, // counted on the item of an earlier frame
+} ProtoPirateHistoryStateAddKey;
+
+// Text and FlipperFormat output are rebuilt from the stored decoder state when
+// asked for, through decoders allocated from environment. setting maps the
+// preset to an index and back.
+ProtoPirateHistory* protopirate_history_alloc(SubGhzEnvironment* environment, SubGhzSetting* setting);
 void protopirate_history_free(ProtoPirateHistory* instance);
 void protopirate_history_reset(ProtoPirateHistory* instance);
 uint16_t protopirate_history_get_item(ProtoPirateHistory* instance);
+// Items are addressed by sequence number, counted up from 0 as they are added
+// and never reused. The ones kept are first_seq up to next_seq - 1, an evicted
+// seq reads as "---" and has no raw data.
+uint32_t protopirate_history_get_first_seq(ProtoPirateHistory* instance);
+uint32_t protopirate_history_get_next_seq(ProtoPirateHistory* instance);
 uint16_t protopirate_history_get_last_index(ProtoPirateHistory* instance);
-bool protopirate_history_add_to_history(
+// Frames with the same protocol and key fields as one added less than 500 ms
+// before are not stored again, only counted as a repeat of it. seq is set to
+// the item the frame went to either way.
+ProtoPirateHistoryStateAddKey protopirate_history_add_to_history(
     ProtoPirateHistory* instance,
     void* context,
-    SubGhzRadioPreset* preset);
+    SubGhzRadioPreset* preset,
+    int8_t rssi,
+    uint32_t* seq);
+// Frames the item stands for, 1 without repeats and 0 once evicted
+uint16_t protopirate_history_get_repeats(ProtoPirateHistory* instance, uint32_t seq);
 void protopirate_history_get_text_item_menu(
     ProtoPirateHistory* instance,
     FuriString* output,
-    uint16_t idx);
+    uint32_t seq);
+// Ends with an "xN repeats" line for an item with repeats
 void protopirate_history_get_text_item(
     ProtoPirateHistory* instance,
     FuriString* output,
-    uint16_t idx);
+    uint32_t seq);
 SubGhzProtocolDecoderBase*
-    protopirate_history_get_decoder_base(ProtoPirateHistory* instance, uint16_t idx);
-FlipperFormat* protopirate_history_get_raw_data(ProtoPirateHistory* instance, uint16_t idx);
+    protopirate_history_get_decoder_base(ProtoPirateHistory* instance, uint32_t seq);
+// Serializes item seq into output (a string FlipperFormat), false if there is none
+bool protopirate_history_get_raw_data(
+    ProtoPirateHistory* instance,
+    uint32_t seq,
+    FlipperFormat* output);
@@ -1,10 +1,14 @@
 // scenes/protopirate_scene_receiver.c
 #include "../protopirate_app_i.h"
 #include "../helpers/protopirate_storage.h"
+#include "../helpers/protopirate_stats.h"
 #include <notification/notification_messages.h>
 
-#define TAG                     "ProtoPirateSceneRx"
-#define KIA_DISPLAY_HISTORY_MAX 50
+#define TAG "ProtoPirateSceneRx"
+
+// Scene state, set while the stats scene is on top and RX keeps running
+#define RECEIVER_STATE_IDLE  0
+#define RECEIVER_STATE_STATS 1
 
 // Forward declaration
 void protopirate_scene_receiver_view_callback(ProtoPirateCustomEvent event, void* context);
@@ -20,19 +24,20 @@ static void protopirate_scene_receiver_update_statusbar(void* context) {
     // Check if using external radio
     bool is_external = radio_device_loader_is_external(app->txrx->radio_device);
 
-    // Show auto-save indicator in the history count area
+    // Show auto-save indicator in the history count area, L for the session log
     if(app->auto_save) {
         furi_string_printf(
             history_stat_str,
-            "A%u/%u",
+            "%c%u/%u",
+            app->auto_save_log ? 'L' : 'A',
             protopirate_history_get_item(app->txrx->history),
-            KIA_DISPLAY_HISTORY_MAX);
+            KIA_HISTORY_MAX);
     } else {
         furi_string_printf(
             history_stat_str,
             "%u/%u",
             protopirate_history_get_item(app->txrx->history),
-            KIA_DISPLAY_HISTORY_MAX);
+            KIA_HISTORY_MAX);
     }
 
     // Pass actual external radio status
@@ -48,22 +53,36 @@ static void protopirate_scene_receiver_update_statusbar(void* context) {
     furi_string_free(history_stat_str);
 }
 
-static void protopirate_scene_receiver_callback(
-    SubGhzReceiver* receiver,
+// Capture queue thread: formatting, history and auto-save for one decoded frame
+static void protopirate_scene_receiver_process(
     SubGhzProtocolDecoderBase* decoder_base,
+    uint32_t frequency,
     void* context) {
-    UNUSED(receiver);
     furi_assert(context);
     ProtoPirateApp* app = context;
 
     FURI_LOG_I(TAG, "=== SIGNAL DECODED ===");
 
-    FuriString* str_buff = furi_string_alloc();
-    subghz_protocol_decoder_base_get_string(decoder_base, str_buff);
-    FURI_LOG_I(TAG, "%s", furi_string_get_cstr(str_buff));
+    // The hopper may have moved on since, keep the frequency it was heard on
+    SubGhzRadioPreset preset = *app->txrx->preset;
+    preset.frequency = frequency;
+
+    // Level now rather than during the frame, close enough to rank captures
+    int8_t rssi = (int8_t)subghz_devices_get_rssi(app->txrx->radio_device);
+
+    // Add to history, a repeat of a listed key only bumps its count
+    uint32_t seq = 0;
+    ProtoPirateHistoryStateAddKey state = protopirate_history_add_to_history(
+        app->txrx->history, decoder_base, &preset, rssi, &seq);
+
+    if(state == ProtoPirateHistoryStateAddKeyRepeat) {
+        protopirate_view_receiver_update_item(app->protopirate_receiver, seq);
+    } else if(state == ProtoPirateHistoryStateAddKeyNewData) {
+        FuriString* str_buff = furi_string_alloc();
+        subghz_protocol_decoder_base_get_string(decoder_base, str_buff);
+        FURI_LOG_I(TAG, "%s", furi_string_get_cstr(str_buff));
+        furi_string_free(str_buff);
 
-    // Add to history
-    if(protopirate_history_add_to_history(app->txrx->history, decoder_base, app->txrx->preset)) {
         notification_message(app->notifications, &sequence_semi_success);
 
         FURI_LOG_I(
@@ -71,21 +90,28 @@ static void protopirate_scene_receiver_callback(
             "Added to history, total items: %u",
             protopirate_history_get_item(app->txrx->history));
 
-        FuriString* item_name = furi_string_alloc();
-        protopirate_history_get_text_item_menu(
-            app->txrx->history, item_name, protopirate_history_get_item(app->txrx->history) - 1);
-
-        protopirate_view_receiver_add_item_to_menu(
-            app->protopirate_receiver, furi_string_get_cstr(item_name), 0);
+        protopirate_view_receiver_set_items(
+            app->protopirate_receiver,
+            protopirate_history_get_first_seq(app->txrx->history),
+            protopirate_history_get_next_seq(app->txrx->history));
 
-        furi_string_free(item_name);
-
-        // Auto-save if enabled
+        // Auto-save if enabled, the key file is only built for that
+        FlipperFormat* ff = NULL;
         if(app->auto_save) {
-            FlipperFormat* ff = protopirate_history_get_raw_data(
-                app->txrx->history, 
-                protopirate_history_get_item(app->txrx->history) - 1);
-            
+            ff = flipper_format_string_alloc();
+            if(!protopirate_history_get_raw_data(app->txrx->history, seq, ff)) {
+                flipper_format_free(ff);
+                ff = NULL;
+            }
+        }
+
+        if(app->auto_save && app->auto_save_log) {
+            if(ff && app->session_log && protopirate_session_log_append(app->session_log, ff)) {
+                notification_message(app->notifications, &sequence_double_vibro);
+            } else {
+                FURI_LOG_E(TAG, "Session log append failed");
+            }
+        } else if(app->auto_save) {
             if(ff) {
                 FuriString* protocol = furi_string_alloc();
                 flipper_format_rewind(ff);
@@ -110,14 +136,48 @@ static void protopirate_scene_receiver_callback(
                 furi_string_free(saved_path);
             }
         }
+        if(ff) {
+            flipper_format_free(ff);
+        }
 
         view_dispatcher_send_custom_event(
             app->view_dispatcher, ProtoPirateCustomEventSceneReceiverUpdate);
     } else {
-        FURI_LOG_W(TAG, "Failed to add to history (duplicate or full)");
+        FURI_LOG_W(TAG, "Failed to add to history");
+    }
+}
+
+// Capture thread with no frames coming in, the session log is only written
+// from here and after the thread stopped
+static void protopirate_scene_receiver_idle(void* context) {
+    ProtoPirateApp* app = context;
+    if(app->session_log) {
+        protopirate_session_log_flush_due(app->session_log);
     }
+}
+
+// Draw callback of the receiver view, for the rows on screen
+static uint16_t protopirate_scene_receiver_item_callback(
+    FuriString* output,
+    uint32_t seq,
+    void* context) {
+    furi_assert(context);
+    ProtoPirateApp* app = context;
 
-    furi_string_free(str_buff);
+    protopirate_history_get_text_item_menu(app->txrx->history, output, seq);
+    return protopirate_history_get_repeats(app->txrx->history, seq);
+}
+
+// SubGhz worker context: only copy the frame out, the SD card can stall for
+// a long time and the worker overruns meanwhile
+static void protopirate_scene_receiver_callback(
+    SubGhzProtocolDecoderBase* decoder_base,
+    void* context) {
+    furi_assert(context);
+    ProtoPirateApp* app = context;
+
+    protopirate_capture_queue_push(
+        app->txrx->captures, decoder_base, app->txrx->preset->frequency);
 
     // Pause hopper when we receive something
     if(app->txrx->hopper_state == ProtoPirateHopperStateRunning) {
@@ -140,12 +200,24 @@ void protopirate_scene_receiver_on_enter(void* context) {
     FURI_LOG_I(TAG, "Modulation: %s", furi_string_get_cstr(app->txrx->preset->name));
     FURI_LOG_I(TAG, "Auto-save: %s", app->auto_save ? "ON" : "OFF");
 
-    // Set up the receiver callback
-    subghz_receiver_set_rx_callback(app->txrx->receiver, protopirate_scene_receiver_callback, app);
+    // Set up the decoder callback, count per-protocol stats while we're live
+    protopirate_decoder_set_set_callback(
+        app->txrx->decoders, protopirate_scene_receiver_callback, app);
+    if(app->auto_save && app->auto_save_log && !app->session_log) {
+        app->session_log = protopirate_session_log_open();
+    }
+    protopirate_capture_queue_start(
+        app->txrx->captures,
+        protopirate_scene_receiver_process,
+        protopirate_scene_receiver_idle,
+        app);
+    protopirate_stats_set_enabled(true);
 
     // Set up view callback
     protopirate_view_receiver_set_callback(
         app->protopirate_receiver, protopirate_scene_receiver_view_callback, app);
+    protopirate_view_receiver_set_item_callback(
+        app->protopirate_receiver, protopirate_scene_receiver_item_callback, app);
 
     // Update status bar
     protopirate_scene_receiver_update_statusbar(app);
@@ -155,6 +227,17 @@ void protopirate_scene_receiver_on_enter(void* context) {
         app->txrx->hopper_state = ProtoPirateHopperStateRunning;
     }
 
+    // Back from the stats scene, RX never stopped
+    if(scene_manager_get_scene_state(app->scene_manager, ProtoPirateSceneReceiver) ==
+       RECEIVER_STATE_STATS) {
+        scene_manager_set_scene_state(
+            app->scene_manager, ProtoPirateSceneReceiver, RECEIVER_STATE_IDLE);
+        if(app->txrx->txrx_state == ProtoPirateTxRxStateRx) {
+            view_dispatcher_switch_to_view(app->view_dispatcher, ProtoPirateViewReceiver);
+            return;
+        }
+    }
+
     // Get preset data
     const char* preset_name = furi_string_get_cstr(app->txrx->preset->name);
     uint8_t* preset_data = subghz_setting_get_preset_data_by_name(app->setting, preset_name);
@@ -193,9 +276,10 @@ bool protopirate_scene_receiver_on_event(void* context, SceneManagerEvent event)
             break;
 
         case ProtoPirateCustomEventViewReceiverOK: {
-            uint16_t idx = protopirate_view_receiver_get_idx_menu(app->protopirate_receiver);
-            FURI_LOG_I(TAG, "Selected item %d", idx);
-            if(idx < protopirate_history_get_item(app->txrx->history)) {
+            uint32_t idx = protopirate_view_receiver_get_idx_menu(app->protopirate_receiver);
+            FURI_LOG_I(TAG, "Selected item %lu", idx);
+            if(idx >= protopirate_history_get_first_seq(app->txrx->history) &&
+               idx < protopirate_history_get_next_seq(app->txrx->history)) {
                 app->txrx->idx_menu_chosen = idx;
                 scene_manager_next_scene(app->scene_manager, ProtoPirateSceneReceiverInfo);
             }
@@ -208,10 +292,23 @@ bool protopirate_scene_receiver_on_event(void* context, SceneManagerEvent event)
             consumed = true;
             break;
 
+        case ProtoPirateCustomEventViewReceiverStats:
+            scene_manager_set_scene_state(
+                app->scene_manager, ProtoPirateSceneReceiver, RECEIVER_STATE_STATS);
+            scene_manager_next_scene(app->scene_manager, ProtoPirateSceneStats);
+            consumed = true;
+            break;
+
         case ProtoPirateCustomEventViewReceiverBack:
             if(app->txrx->txrx_state == ProtoPirateTxRxStateRx) {
                 protopirate_rx_end(app);
             }
+            protopirate_capture_queue_stop(app->txrx->captures);
+            if(app->session_log) {
+                protopirate_session_log_close(app->session_log);
+                app->session_log = NULL;
+            }
+            protopirate_stats_set_enabled(false);
             protopirate_sleep(app);
             protopirate_history_reset(app->txrx->history);
             scene_manager_search_and_switch_to_previous_scene(
@@ -257,9 +354,26 @@ void protopirate_scene_receiver_on_exit(void* context) {
 
     FURI_LOG_I(TAG, "=== EXITING RECEIVER SCENE ===");
 
+    // The stats scene watches the live counters, keep receiving under it
+    if(scene_manager_get_scene_state(app->scene_manager, ProtoPirateSceneReceiver) ==
+       RECEIVER_STATE_STATS) {
+        return;
+    }
+
     if(app->txrx->txrx_state == ProtoPirateTxRxStateRx) {
         protopirate_rx_end(app);
     }
+
+    // RX is stopped, finish what's still queued. The session log stays open
+    // until Back, info/config scenes in between are the same session.
+    protopirate_capture_queue_stop(app->txrx->captures);
+    if(app->session_log) {
+        protopirate_session_log_flush(app->session_log);
+    }
+
+#ifdef PROTOPIRATE_TRACE
+    protopirate_storage_save_trace();
+#endif
 }
 
 void protopirate_scene_receiver_view_callback(ProtoPirateCustomEvent event, void* context) {
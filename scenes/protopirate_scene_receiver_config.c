@@ -6,6 +6,7 @@ enum ProtoPirateSettingIndex {
     ProtoPirateSettingIndexHopping,
     ProtoPirateSettingIndexModulation,
     ProtoPirateSettingIndexAutoSave,
+    ProtoPirateSettingIndexGlitchFilter,
     ProtoPirateSettingIndexLock,
 };
 
@@ -19,10 +20,29 @@ const uint32_t hopping_value[HOPPING_COUNT] = {
     ProtoPirateHopperStateRunning,
 };
 
-#define AUTO_SAVE_COUNT 2
+// ON writes one .sub per capture, Log appends to the session log
+#define AUTO_SAVE_COUNT 3
 const char* const auto_save_text[AUTO_SAVE_COUNT] = {
     "OFF",
     "ON",
+    "Log",
+};
+
+// Pulses shorter than this are merged into their neighbours before decoding
+#define GLITCH_FILTER_COUNT 5
+const char* const glitch_filter_text[GLITCH_FILTER_COUNT] = {
+    "OFF",
+    "40us",
+    "60us",
+    "80us",
+    "100us",
+};
+const uint32_t glitch_filter_value[GLITCH_FILTER_COUNT] = {
+    0,
+    40,
+    60,
+    80,
+    100,
 };
 
 uint8_t protopirate_scene_receiver_config_next_frequency(const uint32_t value, void* context) {
@@ -146,10 +166,20 @@ static void protopirate_scene_receiver_config_set_auto_save(VariableItem* item)
     ProtoPirateApp* app = variable_item_get_context(item);
     uint8_t index = variable_item_get_current_value_index(item);
     
-    app->auto_save = (index == 1);
+    app->auto_save = (index != 0);
+    app->auto_save_log = (index == 2);
     variable_item_set_current_value_text(item, auto_save_text[index]);
 }
 
+static void protopirate_scene_receiver_config_set_glitch_filter(VariableItem* item) {
+    ProtoPirateApp* app = variable_item_get_context(item);
+    uint8_t index = variable_item_get_current_value_index(item);
+
+    app->glitch_filter_us = glitch_filter_value[index];
+    protopirate_decoder_set_set_glitch_filter(app->txrx->decoders, app->glitch_filter_us);
+    variable_item_set_current_value_text(item, glitch_filter_text[index]);
+}
+
 static void
     protopirate_scene_receiver_config_var_list_enter_callback(void* context, uint32_t index) {
     furi_assert(context);
@@ -215,8 +245,24 @@ void protopirate_scene_receiver_config_on_enter(void* context) {
         AUTO_SAVE_COUNT,
         protopirate_scene_receiver_config_set_auto_save,
         app);
-    variable_item_set_current_value_index(item, app->auto_save ? 1 : 0);
-    variable_item_set_current_value_text(item, auto_save_text[app->auto_save ? 1 : 0]);
+    value_index = app->auto_save ? (app->auto_save_log ? 2 : 1) : 0;
+    variable_item_set_current_value_index(item, value_index);
+    variable_item_set_current_value_text(item, auto_save_text[value_index]);
+
+    item = variable_item_list_add(
+        app->variable_item_list,
+        "Glitch Filter:",
+        GLITCH_FILTER_COUNT,
+        protopirate_scene_receiver_config_set_glitch_filter,
+        app);
+    // A value from an edited settings file shows as the nearest one above it
+    value_index = 0;
+    while(value_index < GLITCH_FILTER_COUNT - 1 &&
+          glitch_filter_value[value_index] < app->glitch_filter_us) {
+        value_index++;
+    }
+    variable_item_set_current_value_index(item, value_index);
+    variable_item_set_current_value_text(item, glitch_filter_text[value_index]);
 
     variable_item_list_add(app->variable_item_list, "Lock Keyboard", 1, NULL, NULL);
     variable_item_list_set_enter_callback(
@@ -59,11 +59,10 @@ bool protopirate_scene_receiver_info_on_event(void *context, SceneManagerEvent e
     {
         if (event.event == ProtoPirateCustomEventReceiverInfoSave)
         {
-            // Get the flipper format from history
-            FlipperFormat *ff = protopirate_history_get_raw_data(
-                app->txrx->history, app->txrx->idx_menu_chosen);
+            // Build the key file from history
+            FlipperFormat *ff = flipper_format_string_alloc();
 
-            if (ff)
+            if (protopirate_history_get_raw_data(app->txrx->history, app->txrx->idx_menu_chosen, ff))
             {
                 // Extract protocol name
                 FuriString *protocol = furi_string_alloc();
@@ -89,6 +88,7 @@ bool protopirate_scene_receiver_info_on_event(void *context, SceneManagerEvent e
                 furi_string_free(protocol);
                 furi_string_free(saved_path);
             }
+            flipper_format_free(ff);
             consumed = true;
         }
     }
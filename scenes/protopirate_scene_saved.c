@@ -4,9 +4,15 @@
 
 #define TAG "ProtoPirateSceneSaved"
 
+// Captures listed at a time, the index can hold thousands and every submenu
+// item keeps its own label on the heap
+#define SAVED_PAGE_SIZE 50
+
 typedef enum
 {
-    SubmenuIndexBack = 0xFF,
+    SubmenuIndexBack = 0x7FFFFFFF, // above any file index
+    SubmenuIndexNewer = 0x7FFFFFFE,
+    SubmenuIndexOlder = 0x7FFFFFFD,
 } SavedMenuIndex;
 
 static void protopirate_scene_saved_submenu_callback(void *context, uint32_t index)
@@ -15,50 +21,86 @@ static void protopirate_scene_saved_submenu_callback(void *context, uint32_t ind
     view_dispatcher_send_custom_event(app->view_dispatcher, index);
 }
 
-void protopirate_scene_saved_on_enter(void *context)
+// The page holding the file index in the scene state, that one selected
+static void protopirate_scene_saved_show_page(ProtoPirateApp *app)
 {
-    ProtoPirateApp *app = context;
-
     submenu_reset(app->submenu);
-    submenu_set_header(app->submenu, "Saved Captures");
-
-    FURI_LOG_I(TAG, "Entering saved captures scene");
 
     uint32_t file_count = protopirate_storage_get_file_count();
     FURI_LOG_I(TAG, "File count: %lu", file_count);
 
     if (file_count == 0)
     {
+        submenu_set_header(app->submenu, "Saved Captures");
         submenu_add_item(
             app->submenu,
             "No saved captures",
             SubmenuIndexBack,
             protopirate_scene_saved_submenu_callback,
             app);
+        return;
+    }
+
+    // Back from a delete the selected one may be past the end
+    uint32_t selected = MIN(
+        scene_manager_get_scene_state(app->scene_manager, ProtoPirateSceneSaved), file_count - 1);
+    uint32_t first = selected - selected % SAVED_PAGE_SIZE;
+
+    // Newest first, straight from the index without opening any file
+    ProtoPirateStorageEntry *entries = malloc(sizeof(ProtoPirateStorageEntry) * SAVED_PAGE_SIZE);
+    uint32_t count = protopirate_storage_get_entries(first, entries, SAVED_PAGE_SIZE);
+    FuriString *label = furi_string_alloc();
+
+    if (file_count > SAVED_PAGE_SIZE)
+    {
+        furi_string_printf(label, "Saved %lu-%lu of %lu", first + 1, first + count, file_count);
+        submenu_set_header(app->submenu, furi_string_get_cstr(label));
     }
     else
     {
-        FuriString *name = furi_string_alloc();
-        FuriString *path = furi_string_alloc();
+        submenu_set_header(app->submenu, "Saved Captures");
+    }
 
-        for (uint32_t i = 0; i < file_count && i < 50; i++)
+    if (first > 0)
+    {
+        submenu_add_item(
+            app->submenu, "< Newer", SubmenuIndexNewer, protopirate_scene_saved_submenu_callback, app);
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        furi_string_set_str(label, entries[i].name);
+        if (entries[i].flags & ProtoPirateStorageEntrySerial)
         {
-            if (protopirate_storage_get_file_by_index(i, path, name))
-            {
-                FURI_LOG_D(TAG, "Adding menu item: %s", furi_string_get_cstr(name));
-                submenu_add_item(
-                    app->submenu,
-                    furi_string_get_cstr(name),
-                    i,
-                    protopirate_scene_saved_submenu_callback,
-                    app);
-            }
+            furi_string_cat_printf(label, " %08lX", entries[i].serial);
         }
 
-        furi_string_free(name);
-        furi_string_free(path);
+        submenu_add_item(
+            app->submenu,
+            furi_string_get_cstr(label),
+            first + i,
+            protopirate_scene_saved_submenu_callback,
+            app);
+    }
+
+    if (first + count < file_count)
+    {
+        submenu_add_item(
+            app->submenu, "Older >", SubmenuIndexOlder, protopirate_scene_saved_submenu_callback, app);
     }
 
+    submenu_set_selected_item(app->submenu, selected);
+    furi_string_free(label);
+    free(entries);
+}
+
+void protopirate_scene_saved_on_enter(void *context)
+{
+    ProtoPirateApp *app = context;
+
+    FURI_LOG_I(TAG, "Entering saved captures scene");
+    protopirate_scene_saved_show_page(app);
+
     view_dispatcher_switch_to_view(app->view_dispatcher, ProtoPirateViewSubmenu);
 }
 
@@ -74,9 +116,19 @@ bool protopirate_scene_saved_on_event(void *context, SceneManagerEvent event)
             // Just go back
             consumed = true;
         }
+        else if (event.event == SubmenuIndexNewer || event.event == SubmenuIndexOlder)
+        {
+            uint32_t selected = scene_manager_get_scene_state(app->scene_manager, ProtoPirateSceneSaved);
+            uint32_t first = selected - selected % SAVED_PAGE_SIZE;
+            first = event.event == SubmenuIndexNewer ? first - SAVED_PAGE_SIZE : first + SAVED_PAGE_SIZE;
+            scene_manager_set_scene_state(app->scene_manager, ProtoPirateSceneSaved, first);
+            protopirate_scene_saved_show_page(app);
+            consumed = true;
+        }
         else
         {
             // Load and display the selected file
+            scene_manager_set_scene_state(app->scene_manager, ProtoPirateSceneSaved, event.event);
             FuriString *path = furi_string_alloc();
             FuriString *name = furi_string_alloc();
 
@@ -1,6 +1,7 @@
 // scenes/protopirate_scene_saved_info.c
 #include "../protopirate_app_i.h"
 #include "../helpers/protopirate_storage.h"
+#include "../helpers/protopirate_key_file.h"
 
 static void protopirate_scene_saved_info_widget_callback(
     GuiButtonType result,
@@ -31,62 +32,49 @@ void protopirate_scene_saved_info_on_enter(void *context)
 
     if (app->loaded_file_path)
     {
-        FlipperFormat *ff = protopirate_storage_load_file(
-            furi_string_get_cstr(app->loaded_file_path));
+        Storage *storage = furi_record_open(RECORD_STORAGE);
+        ProtoPirateKeyFile *key_file = protopirate_key_file_alloc();
 
-        if (ff)
+        if (protopirate_key_file_load(key_file, storage, furi_string_get_cstr(app->loaded_file_path)))
         {
             FuriString *info_str = furi_string_alloc();
-            FuriString *temp_str = furi_string_alloc();
-            uint32_t temp_data;
 
-            // Protocol
-            if (flipper_format_read_string(ff, "Protocol", temp_str))
+            if (key_file->fields & ProtoPirateKeyFileFieldProtocol)
             {
-                furi_string_cat_printf(info_str, "Protocol: %s\n", furi_string_get_cstr(temp_str));
+                furi_string_cat_printf(info_str, "Protocol: %s\n", furi_string_get_cstr(key_file->protocol));
             }
 
-            // Frequency
-            flipper_format_rewind(ff);
-            if (flipper_format_read_uint32(ff, "Frequency", &temp_data, 1))
+            if (key_file->fields & ProtoPirateKeyFileFieldFrequency)
             {
                 furi_string_cat_printf(
                     info_str, "Freq: %lu.%02lu MHz\n",
-                    temp_data / 1000000, (temp_data % 1000000) / 10000);
+                    key_file->frequency / 1000000, (key_file->frequency % 1000000) / 10000);
             }
 
-            // Serial
-            flipper_format_rewind(ff);
-            if (flipper_format_read_uint32(ff, "Serial", &temp_data, 1))
+            if (key_file->fields & ProtoPirateKeyFileFieldSerial)
             {
-                furi_string_cat_printf(info_str, "Serial: %08lX\n", temp_data);
+                furi_string_cat_printf(info_str, "Serial: %08lX\n", key_file->serial);
             }
 
-            // Button
-            flipper_format_rewind(ff);
-            if (flipper_format_read_uint32(ff, "Btn", &temp_data, 1))
+            if (key_file->fields & ProtoPirateKeyFileFieldButton)
             {
-                furi_string_cat_printf(info_str, "Button: %02X\n", (uint8_t)temp_data);
+                furi_string_cat_printf(info_str, "Button: %02X\n", (uint8_t)key_file->button);
             }
 
-            // Counter
-            flipper_format_rewind(ff);
-            if (flipper_format_read_uint32(ff, "Cnt", &temp_data, 1))
+            if (key_file->fields & ProtoPirateKeyFileFieldCounter)
             {
-                furi_string_cat_printf(info_str, "Counter: %04lX\n", temp_data);
+                furi_string_cat_printf(info_str, "Counter: %04lX\n", key_file->counter);
             }
 
             // Protocol-specific fields
-            flipper_format_rewind(ff);
-            if (flipper_format_read_uint32(ff, "CRC", &temp_data, 1))
+            if (key_file->fields & ProtoPirateKeyFileFieldCrc)
             {
-                furi_string_cat_printf(info_str, "CRC: %02X\n", (uint8_t)temp_data);
+                furi_string_cat_printf(info_str, "CRC: %02X\n", (uint8_t)key_file->crc);
             }
 
-            flipper_format_rewind(ff);
-            if (flipper_format_read_uint32(ff, "Type", &temp_data, 1))
+            if (key_file->fields & ProtoPirateKeyFileFieldType)
             {
-                furi_string_cat_printf(info_str, "Type: %02X\n", (uint8_t)temp_data);
+                furi_string_cat_printf(info_str, "Type: %02X\n", (uint8_t)key_file->type);
             }
 
             // Add text to the widget
@@ -109,10 +97,11 @@ void protopirate_scene_saved_info_on_enter(void *context)
                 protopirate_scene_saved_info_widget_callback,
                 app);
 
-            furi_string_free(temp_str);
             furi_string_free(info_str);
-            flipper_format_free(ff);
         }
+
+        protopirate_key_file_free(key_file);
+        furi_record_close(RECORD_STORAGE);
     }
 
     view_dispatcher_switch_to_view(app->view_dispatcher, ProtoPirateViewWidget);
@@ -1,12 +1,15 @@
 // scenes/protopirate_scene_start.c
 #include "../protopirate_app_i.h"
 
+#define TAG "ProtoPirateSceneStart"
+
 typedef enum
 {
     SubmenuIndexProtoPirateReceiver,
     SubmenuIndexProtoPirateSaved,
     SubmenuIndexProtoPirateReceiverConfig,
     SubmenuIndexProtoPirateSubDecode,
+    SubmenuIndexProtoPirateExportLogs,
     SubmenuIndexProtoPirateAbout,
 } SubmenuIndex;
 
@@ -51,6 +54,13 @@ void protopirate_scene_start_on_enter(void *context)
         protopirate_scene_start_submenu_callback,
         app);
 
+    submenu_add_item(
+        app->submenu,
+        "Export Session Logs",
+        SubmenuIndexProtoPirateExportLogs,
+        protopirate_scene_start_submenu_callback,
+        app);
+
     submenu_add_item(
         app->submenu,
         "About",
@@ -84,6 +94,7 @@ bool protopirate_scene_start_on_event(void *context, SceneManagerEvent event)
         }
         else if (event.event == SubmenuIndexProtoPirateSaved)
         {
+            scene_manager_set_scene_state(app->scene_manager, ProtoPirateSceneSaved, 0);
             scene_manager_next_scene(app->scene_manager, ProtoPirateSceneSaved);
             consumed = true;
         }
@@ -97,6 +108,15 @@ bool protopirate_scene_start_on_event(void *context, SceneManagerEvent event)
             scene_manager_next_scene(app->scene_manager, ProtoPirateSceneSubDecode);
             consumed = true;
         }
+        else if (event.event == SubmenuIndexProtoPirateExportLogs)
+        {
+            // Session logs back to one .sub per capture, for the Saved list
+            uint32_t exported = 0;
+            bool ok = protopirate_session_log_export_all(&exported);
+            FURI_LOG_I(TAG, "Exported %lu captures", exported);
+            notification_message(app->notifications, ok ? &sequence_success : &sequence_error);
+            consumed = true;
+        }
         scene_manager_set_scene_state(app->scene_manager, ProtoPirateSceneStart, event.event);
     }
 
@@ -0,0 +1,195 @@
+// scenes/protopirate_scene_stats.c
+#include "../protopirate_app_i.h"
+#include "../helpers/protopirate_stats.h"
+#include "../helpers/protopirate_trace.h"
+#include "../helpers/protopirate_storage.h"
+#include <gui/elements.h>
+
+#define TAG "ProtoPirateStats"
+
+// One page per protocol, the most expensive feed() first. The receiver keeps
+// running underneath so the counters move while this is open.
+typedef struct
+{
+    uint8_t page;
+    uint8_t order[ProtoPirateTraceProtocolCount];
+    ProtoPirateDecoderSet *decoders; // glitch count of the live decoder set
+} StatsState;
+
+static StatsState s_state = {0};
+
+static void stats_sort(void)
+{
+    ProtoPirateStatsEntry entries[ProtoPirateTraceProtocolCount];
+    for (uint8_t i = 0; i < ProtoPirateTraceProtocolCount; i++)
+    {
+        protopirate_stats_get(i, &entries[i]);
+        s_state.order[i] = i;
+    }
+
+    // 17 entries, insertion sort is plenty
+    for (uint8_t i = 1; i < ProtoPirateTraceProtocolCount; i++)
+    {
+        uint8_t current = s_state.order[i];
+        uint8_t j = i;
+        while (j > 0 && entries[s_state.order[j - 1]].ticks < entries[current].ticks)
+        {
+            s_state.order[j] = s_state.order[j - 1];
+            j--;
+        }
+        s_state.order[j] = current;
+    }
+}
+
+static void stats_draw_callback(Canvas *canvas, void *context)
+{
+    UNUSED(context);
+
+    uint64_t total_ticks = 0;
+    for (uint8_t i = 0; i < ProtoPirateTraceProtocolCount; i++)
+    {
+        total_ticks += protopirate_stats[i].ticks;
+    }
+
+    uint8_t protocol = s_state.order[s_state.page];
+    ProtoPirateStatsEntry entry;
+    protopirate_stats_get(protocol, &entry);
+
+    uint32_t share = total_ticks ? (uint32_t)(entry.ticks * 100 / total_ticks) : 0;
+    uint32_t per_pulse = entry.pulses ? (uint32_t)(entry.ticks / entry.pulses) : 0;
+
+    canvas_clear(canvas);
+    canvas_set_color(canvas, ColorBlack);
+
+    FuriString *line = furi_string_alloc();
+
+    canvas_set_font(canvas, FontPrimary);
+    furi_string_printf(
+        line, "%u. %s", s_state.page + 1, protopirate_trace_protocol_name(protocol));
+    canvas_draw_str(canvas, 0, 10, furi_string_get_cstr(line));
+    furi_string_printf(line, "%lu%%", share);
+    canvas_draw_str_aligned(canvas, 127, 10, AlignRight, AlignBottom, furi_string_get_cstr(line));
+
+    canvas_set_font(canvas, FontSecondary);
+    furi_string_printf(line, "Pulses: %lu", entry.pulses);
+    canvas_draw_str(canvas, 0, 21, furi_string_get_cstr(line));
+    // Set-wide, the same on every page
+    furi_string_printf(line, "Glitch: %lu", protopirate_decoder_set_get_glitches(s_state.decoders));
+    canvas_draw_str_aligned(canvas, 123, 21, AlignRight, AlignBottom, furi_string_get_cstr(line));
+    furi_string_printf(line, "Preambles: %lu", entry.preambles);
+    canvas_draw_str(canvas, 0, 31, furi_string_get_cstr(line));
+    furi_string_printf(
+        line,
+        "Resets T/E/B: %lu/%lu/%lu",
+        entry.resets[ProtoPirateStatsResetTiming],
+        entry.resets[ProtoPirateStatsResetEarlyEnd],
+        entry.resets[ProtoPirateStatsResetBitCount]);
+    canvas_draw_str(canvas, 0, 41, furi_string_get_cstr(line));
+    furi_string_printf(line, "Frames: %lu", entry.frames);
+    canvas_draw_str(canvas, 0, 51, furi_string_get_cstr(line));
+    furi_string_printf(line, "%lu %s/pulse", per_pulse, PROTOPIRATE_STATS_TICK_UNIT);
+    canvas_draw_str(canvas, 0, 61, furi_string_get_cstr(line));
+
+    furi_string_free(line);
+
+    canvas_draw_str_aligned(canvas, 127, 61, AlignRight, AlignBottom, "OK:Save");
+    elements_scrollbar_pos(
+        canvas, 127, 14, 36, s_state.page, ProtoPirateTraceProtocolCount);
+}
+
+static bool stats_input_callback(InputEvent *event, void *context)
+{
+    ProtoPirateApp *app = context;
+    bool consumed = false;
+
+    if (event->key == InputKeyBack)
+    {
+        return false;
+    }
+
+    if (event->type == InputTypeShort || event->type == InputTypeRepeat)
+    {
+        if (event->key == InputKeyUp)
+        {
+            s_state.page = s_state.page ? s_state.page - 1 : ProtoPirateTraceProtocolCount - 1;
+            consumed = true;
+        }
+        else if (event->key == InputKeyDown)
+        {
+            s_state.page = (s_state.page + 1) % ProtoPirateTraceProtocolCount;
+            consumed = true;
+        }
+    }
+
+    if (event->key == InputKeyOk)
+    {
+        if (event->type == InputTypeShort)
+        {
+            if (protopirate_storage_save_stats())
+            {
+                FURI_LOG_I(TAG, "Stats saved to %s", PROTOPIRATE_STATS_FILE);
+                notification_message(app->notifications, &sequence_success);
+            }
+            else
+            {
+                notification_message(app->notifications, &sequence_error);
+            }
+        }
+        else if (event->type == InputTypeLong)
+        {
+            protopirate_stats_clear();
+            s_state.page = 0;
+            stats_sort();
+            notification_message(app->notifications, &sequence_single_vibro);
+        }
+        consumed = true;
+    }
+
+    return consumed;
+}
+
+void protopirate_scene_stats_on_enter(void *context)
+{
+    furi_assert(context);
+    ProtoPirateApp *app = context;
+
+    s_state.page = 0;
+    s_state.decoders = app->txrx->decoders;
+    stats_sort();
+
+    view_set_draw_callback(app->view_stats, stats_draw_callback);
+    view_set_input_callback(app->view_stats, stats_input_callback);
+    view_set_context(app->view_stats, app);
+
+    view_dispatcher_switch_to_view(app->view_dispatcher, ProtoPirateViewStats);
+}
+
+bool protopirate_scene_stats_on_event(void *context, SceneManagerEvent event)
+{
+    ProtoPirateApp *app = context;
+    bool consumed = false;
+
+    if (event.type == SceneManagerEventTypeTick)
+    {
+        // The receiver scene is paused underneath, keep hopping for it
+        if (app->txrx->hopper_state != ProtoPirateHopperStateOFF)
+        {
+            protopirate_hopper_update(app);
+        }
+
+        // Ranking is fixed on enter so the page doesn't jump under the cursor
+        view_commit_model(app->view_stats, true);
+        consumed = true;
+    }
+
+    return consumed;
+}
+
+void protopirate_scene_stats_on_exit(void *context)
+{
+    furi_assert(context);
+    ProtoPirateApp *app = context;
+
+    view_set_draw_callback(app->view_stats, NULL);
+    view_set_input_callback(app->view_stats, NULL);
+}
@@ -2,15 +2,22 @@
 #include "../protopirate_app_i.h"
 #include "../protocols/protocol_items.h"
 #include "../helpers/protopirate_storage.h"
+#include "../helpers/protopirate_key_file.h"
+#include "../helpers/protopirate_decoder_set.h"
 #include <dialogs/dialogs.h>
+#include <toolbox/stream/stream.h>
 #include <ctype.h>
 #include <math.h>
 
 #define TAG "ProtoPirateSubDecode"
 
 #define SUBGHZ_APP_FOLDER EXT_PATH("subghz")
-#define SAMPLES_PER_TICK 256
-#define MAX_RAW_SAMPLES 8192
+#define DECODE_WORKER_STACK_SIZE (4 * 1024)
+#define RAW_READER_STACK_SIZE (2 * 1024)
+#define RAW_CHUNK_SAMPLES 512
+#define RAW_RING_SAMPLES 1024
+#define RAW_RING_WAIT_MS 50
+#define MAX_DECODE_HITS 32
 #define SUCCESS_DISPLAY_TICKS 18
 #define FAILURE_DISPLAY_TICKS 18
 
@@ -19,7 +26,6 @@ typedef enum {
     DecodeStateIdle,
     DecodeStateOpenFile,
     DecodeStateReadHeader,
-    DecodeStateLoadRawSamples,
     DecodeStateDecodingRaw,
     DecodeStateDecodingProtocol,
     DecodeStateShowSuccess,
@@ -27,9 +33,24 @@ typedef enum {
     DecodeStateDone,
 } DecodeState;
 
+// One unique frame found in a RAW capture
+typedef struct {
+    const SubGhzProtocol* protocol;
+    uint32_t sample_offset;
+    uint32_t time_ms;
+    uint16_t repeats; // frames the hit stands for, 1 without repeats, like history
+    FuriString* text;
+    FlipperFormat* data;
+} SubDecodeHit;
+
 // Context for the whole decode operation
+// state and the progress counters are written by the worker thread and only
+// read by the scene tick / draw callback
 typedef struct {
-    DecodeState state;
+    ProtoPirateApp* app;
+    volatile DecodeState state;
+    volatile bool cancel_requested;
+    FuriThread* worker;
     uint16_t animation_frame;
     uint8_t result_display_counter;
     
@@ -40,22 +61,33 @@ typedef struct {
     FuriString* error_info;
     uint32_t frequency;
     
-    // File handle
+    // File handle, only read past the header for RAW_Data
     Storage* storage;
     FlipperFormat* ff;
+    ProtoPirateKeyFile* key_file;
     
     // RAW decode state
-    int32_t* raw_samples;
+    FuriStreamBuffer* raw_ring;
+    volatile bool reader_done;
+    volatile size_t bytes_read;
+    size_t bytes_total;
     size_t total_samples;
-    size_t current_sample;
-    size_t current_protocol_idx;
-    void* current_decoder;
-    const SubGhzProtocol* current_protocol;
+    uint32_t glitches; // merged by the decoder set's glitch filter
+    ProtoPirateDecoderSet* decoders;
+    const SubGhzProtocol* volatile current_protocol;
     bool decode_success;
     
     // Callback context
-    bool callback_fired;
     FuriString* decoded_string;
+    size_t feed_offset;
+    uint64_t feed_time_us;
+
+    // Every unique frame in a RAW capture, repeats only bump the counter
+    SubDecodeHit hits[MAX_DECODE_HITS];
+    volatile size_t hit_count;
+    size_t hits_dropped;
+    size_t selected_hit;
+    bool showing_hit;
 
     // For saving - keep a copy of the flipper format data
     FlipperFormat* save_data;
@@ -70,16 +102,68 @@ static void protopirate_scene_sub_decode_widget_callback(
     InputType type,
     void* context);
 
-// Callback when decoder successfully decodes
+// Callback when any decoder in the set successfully decodes
+// Serialize right here, some decoders wipe their generic block after the callback
 static void protopirate_decode_callback(SubGhzProtocolDecoderBase* decoder_base, void* context) {
     SubDecodeContext* ctx = context;
-    ctx->callback_fired = true;
-    
-    if(ctx->current_protocol && ctx->current_protocol->decoder && ctx->current_protocol->decoder->get_string) {
-        ctx->current_protocol->decoder->get_string(decoder_base, ctx->decoded_string);
+    const SubGhzProtocol* protocol = decoder_base->protocol;
+
+    furi_string_reset(ctx->decoded_string);
+    if(protocol->decoder->get_string) {
+        protocol->decoder->get_string(decoder_base, ctx->decoded_string);
     }
-    
-    FURI_LOG_I(TAG, "Decode callback fired for %s!", ctx->current_protocol->name);
+
+    // Same protocol and same decoded text is a repeated transmission
+    for(size_t i = 0; i < ctx->hit_count; i++) {
+        if(ctx->hits[i].protocol == protocol &&
+           furi_string_equal(ctx->hits[i].text, ctx->decoded_string)) {
+            if(ctx->hits[i].repeats < UINT16_MAX) {
+                ctx->hits[i].repeats++;
+            }
+            return;
+        }
+    }
+
+    if(ctx->hit_count >= MAX_DECODE_HITS) {
+        ctx->hits_dropped++;
+        return;
+    }
+
+    SubDecodeHit* hit = &ctx->hits[ctx->hit_count];
+    hit->protocol = protocol;
+    hit->sample_offset = ctx->feed_offset;
+    hit->time_ms = (uint32_t)(ctx->feed_time_us / 1000);
+    hit->repeats = 1;
+    hit->text = furi_string_alloc_set(ctx->decoded_string);
+    hit->data = NULL;
+
+    if(protocol->decoder->serialize) {
+        // Create a temporary preset for serialization
+        SubGhzRadioPreset temp_preset;
+        temp_preset.frequency = ctx->frequency;
+        temp_preset.name = furi_string_alloc_set("AM650");
+        temp_preset.data = NULL;
+        temp_preset.data_size = 0;
+
+        hit->data = flipper_format_string_alloc();
+        SubGhzProtocolStatus status =
+            protocol->decoder->serialize(decoder_base, hit->data, &temp_preset);
+
+        if(status != SubGhzProtocolStatusOk) {
+            FURI_LOG_W(TAG, "RAW serialize failed: %d", status);
+            flipper_format_free(hit->data);
+            hit->data = NULL;
+        }
+
+        furi_string_free(temp_preset.name);
+    } else {
+        FURI_LOG_W(TAG, "Protocol %s has no serialize function", protocol->name);
+    }
+
+    ctx->current_protocol = protocol;
+    ctx->hit_count++;
+
+    FURI_LOG_I(TAG, "Hit %zu: %s at sample %lu", ctx->hit_count, protocol->name, hit->sample_offset);
 }
 
 // Case-insensitive string search
@@ -348,12 +432,8 @@ static void protopirate_decode_draw_callback(Canvas* canvas, void* context) {
     
     // Calculate progress
     int progress = 0;
-    if(ctx->state == DecodeStateLoadRawSamples && ctx->total_samples > 0) {
-        progress = 10 + (ctx->total_samples * 20) / MAX_RAW_SAMPLES;
-    } else if(ctx->state == DecodeStateDecodingRaw && ctx->total_samples > 0) {
-        int sample_pct = (ctx->current_sample * 100) / ctx->total_samples;
-        int proto_pct = (ctx->current_protocol_idx * 100) / protopirate_protocol_registry.size;
-        progress = 30 + (sample_pct * 35 + proto_pct * 35) / 100;
+    if(ctx->state == DecodeStateDecodingRaw && ctx->bytes_total > 0) {
+        progress = 10 + (int)(((uint64_t)ctx->bytes_read * 90) / ctx->bytes_total);
     } else if(ctx->state == DecodeStateOpenFile || ctx->state == DecodeStateReadHeader) {
         progress = 5 + (frame % 10);
     } else if(ctx->state == DecodeStateDecodingProtocol) {
@@ -382,9 +462,6 @@ static void protopirate_decode_draw_callback(Canvas* canvas, void* context) {
         case DecodeStateReadHeader:
             status_text = "Reading header...";
             break;
-        case DecodeStateLoadRawSamples:
-            status_text = "Loading samples...";
-            break;
         case DecodeStateDecodingRaw:
             status_text = ctx->current_protocol ? ctx->current_protocol->name : "Analyzing...";
             break;
@@ -421,12 +498,9 @@ static bool protopirate_decode_input_callback(InputEvent* event, void* context)
     UNUSED(context);
     
     if(event->type == InputTypeShort && event->key == InputKeyBack) {
-        if(g_decode_ctx && g_decode_ctx->state != DecodeStateIdle && 
-           g_decode_ctx->state != DecodeStateDone) {
-            furi_string_set(g_decode_ctx->error_info, "Cancelled");
-            g_decode_ctx->state = DecodeStateShowFailure;
-            g_decode_ctx->result_display_counter = 0;
-            furi_string_set(g_decode_ctx->result, "Cancelled by user");
+        // Worker picks this up and finishes with the "Cancelled" failure screen
+        if(g_decode_ctx && g_decode_ctx->worker) {
+            g_decode_ctx->cancel_requested = true;
         }
         return true;
     }
@@ -434,123 +508,399 @@ static bool protopirate_decode_input_callback(InputEvent* event, void* context)
     return false;
 }
 
-// Process one chunk of RAW samples
-static bool protopirate_process_raw_chunk(ProtoPirateApp* app, SubDecodeContext* ctx) {
-    if(!ctx->current_decoder) {
-        while(ctx->current_protocol_idx < protopirate_protocol_registry.size) {
-            const SubGhzProtocol* protocol = protopirate_protocol_registry.items[ctx->current_protocol_idx];
+static void close_file_handles(SubDecodeContext* ctx) {
+    if(ctx->ff) {
+        flipper_format_free(ctx->ff);
+        ctx->ff = NULL;
+    }
+    if(ctx->storage) {
+        furi_record_close(RECORD_STORAGE);
+        ctx->storage = NULL;
+    }
+}
+
+static bool protopirate_decode_open_file(SubDecodeContext* ctx) {
+    ctx->storage = furi_record_open(RECORD_STORAGE);
+    ctx->ff = flipper_format_file_alloc(ctx->storage);
+
+    if(!flipper_format_file_open_existing(ctx->ff, furi_string_get_cstr(ctx->file_path))) {
+        furi_string_set(ctx->result, "Failed to open file");
+        furi_string_set(ctx->error_info, "File open failed");
+        return false;
+    }
+    return true;
+}
+
+// One pass over everything in front of RAW_Data (the whole file for a Key file)
+static bool protopirate_decode_read_header(SubDecodeContext* ctx) {
+    ProtoPirateKeyFile* key_file = ctx->key_file;
+
+    if(!protopirate_key_file_parse(key_file, flipper_format_get_raw_stream(ctx->ff)) ||
+       furi_string_empty(key_file->filetype)) {
+        furi_string_set(ctx->result, "Invalid file format");
+        furi_string_set(ctx->error_info, "Invalid header");
+        return false;
+    }
+
+    if(furi_string_cmp_str(key_file->filetype, "Flipper SubGhz Key File") != 0 &&
+       furi_string_cmp_str(key_file->filetype, "Flipper SubGhz RAW File") != 0 &&
+       furi_string_cmp_str(key_file->filetype, "Flipper SubGhz") != 0) {
+        furi_string_set(ctx->result, "Not a SubGhz file");
+        furi_string_set(ctx->error_info, "Not SubGhz file");
+        return false;
+    }
+
+    if(!(key_file->fields & ProtoPirateKeyFileFieldProtocol)) {
+        furi_string_set(ctx->result, "Missing Protocol");
+        furi_string_set(ctx->error_info, "No protocol field");
+        return false;
+    }
+    furi_string_set(ctx->protocol_name, key_file->protocol);
+
+    ctx->frequency = 433920000;
+    if(key_file->fields & ProtoPirateKeyFileFieldFrequency) {
+        ctx->frequency = key_file->frequency;
+    }
+
+    FURI_LOG_I(TAG, "Protocol: %s, Freq: %lu",
+        furi_string_get_cstr(ctx->protocol_name), ctx->frequency);
+    return true;
+}
+
+// Reader side of the RAW pipeline: parses RAW_Data lines and pushes the
+// samples into the ring buffer, the decode worker drains it concurrently
+static int32_t protopirate_decode_raw_reader(void* context) {
+    SubDecodeContext* ctx = context;
+    Stream* stream = flipper_format_get_raw_stream(ctx->ff);
+    size_t line_capacity = RAW_CHUNK_SAMPLES;
+    int32_t* line = malloc(sizeof(int32_t) * line_capacity);
+
+    // read_header left the stream at the first RAW_Data line
+    while(!ctx->cancel_requested) {
+        uint32_t count = 0;
+        if(!flipper_format_get_value_count(ctx->ff, "RAW_Data", &count) || count == 0) {
+            break;
+        }
+
+        // FlipperFormat can only read whole lines, the line buffer is sized by
+        // the longest line rather than by the file
+        if(count > line_capacity) {
+            line_capacity = count;
+            free(line);
+            line = malloc(sizeof(int32_t) * line_capacity);
+        }
+
+        if(!flipper_format_read_int32(ctx->ff, "RAW_Data", line, count)) {
+            break;
+        }
+        ctx->bytes_read = stream_tell(stream);
+
+        // Blocking send, a sample is never split across two writes
+        for(size_t sent = 0; sent < count && !ctx->cancel_requested;) {
+            size_t chunk = count - sent;
+            if(chunk > RAW_CHUNK_SAMPLES) chunk = RAW_CHUNK_SAMPLES;
+            furi_stream_buffer_send(
+                ctx->raw_ring, &line[sent], chunk * sizeof(int32_t), FuriWaitForever);
+            sent += chunk;
+        }
+    }
+
+    free(line);
+    ctx->reader_done = true;
+    return 0;
+}
+
+// Streams the whole file through every registered decoder in a single pass,
+// memory use does not depend on the capture length
+static bool protopirate_decode_raw(ProtoPirateApp* app, SubDecodeContext* ctx) {
+    ctx->decoders = protopirate_decoder_set_alloc(app->txrx->environment);
+    protopirate_decoder_set_set_callback(ctx->decoders, protopirate_decode_callback, ctx);
+    protopirate_decoder_set_set_glitch_filter(ctx->decoders, app->glitch_filter_us);
+
+    ctx->current_protocol = NULL;
+    ctx->total_samples = 0;
+    ctx->glitches = 0;
+    ctx->feed_time_us = 0;
+    ctx->hit_count = 0;
+    ctx->hits_dropped = 0;
+
+    ctx->bytes_total = stream_size(flipper_format_get_raw_stream(ctx->ff));
+    ctx->bytes_read = 0;
+    ctx->reader_done = false;
+    ctx->raw_ring = furi_stream_buffer_alloc(RAW_RING_SAMPLES * sizeof(int32_t), sizeof(int32_t));
+
+    FuriThread* reader = furi_thread_alloc_ex(
+        "ProtoPirateRawRead", RAW_READER_STACK_SIZE, protopirate_decode_raw_reader, ctx);
+    furi_thread_start(reader);
+
+    int32_t* chunk = malloc(sizeof(int32_t) * RAW_CHUNK_SAMPLES);
+
+    while(true) {
+        size_t bytes = furi_stream_buffer_receive(
+            ctx->raw_ring, chunk, RAW_CHUNK_SAMPLES * sizeof(int32_t), RAW_RING_WAIT_MS);
+        if(bytes == 0) {
+            if(ctx->reader_done && furi_stream_buffer_is_empty(ctx->raw_ring)) break;
+            continue;
+        }
+
+        // Keep draining after cancel so the reader never blocks on a full ring
+        if(ctx->cancel_requested) continue;
+
+        size_t samples = bytes / sizeof(int32_t);
+        for(size_t i = 0; i < samples; i++) {
+            int32_t duration = chunk[i];
+            bool level = (duration >= 0);
+            if(duration < 0) duration = -duration;
+
+            // Position of this pulse, picked up by the callback for the hit list
+            ctx->feed_offset = ctx->total_samples + i;
+            protopirate_decoder_set_feed(ctx->decoders, level, (uint32_t)duration);
+            ctx->feed_time_us += (uint32_t)duration;
+        }
+        ctx->total_samples += samples;
+    }
+
+    furi_thread_join(reader);
+    furi_thread_free(reader);
+    free(chunk);
+    furi_stream_buffer_free(ctx->raw_ring);
+    ctx->raw_ring = NULL;
+
+    // The last pulse of the file is still held by the glitch filter
+    if(!ctx->cancel_requested) {
+        protopirate_decoder_set_flush(ctx->decoders);
+    }
+    ctx->glitches = protopirate_decoder_set_get_glitches(ctx->decoders);
+    protopirate_decoder_set_free(ctx->decoders);
+    ctx->decoders = NULL;
+
+    FURI_LOG_I(TAG, "Streamed %zu RAW samples, %zu unique frames (%zu dropped), %lu glitches merged",
+        ctx->total_samples, ctx->hit_count, ctx->hits_dropped, ctx->glitches);
+
+    if(ctx->hit_count > 0) {
+        ctx->decode_success = true;
+        return true;
+    }
+
+    if(ctx->total_samples < 10) {
+        furi_string_set(ctx->result, "Not enough samples");
+        furi_string_set(ctx->error_info, "Too few samples");
+        return false;
+    }
+
+    furi_string_printf(ctx->result,
+        "RAW Signal\n\n"
+        "Freq: %lu.%02lu MHz\n"
+        "Samples: %zu\n"
+        "Glitches merged: %lu\n\n"
+        "No ProtoPirate protocol\n"
+        "detected in signal.",
+        ctx->frequency / 1000000,
+        (ctx->frequency % 1000000) / 10000,
+        ctx->total_samples,
+        ctx->glitches);
+    furi_string_set(ctx->error_info, "No protocol match");
+    return false;
+}
+
+// Decode a Key file by deserializing it with the matching protocol
+static bool protopirate_decode_protocol(ProtoPirateApp* app, SubDecodeContext* ctx) {
+    const char* proto_name = furi_string_get_cstr(ctx->protocol_name);
+    bool decoded = false;
+    SubGhzProtocolStatus last_status = SubGhzProtocolStatusOk;
+    bool partial_decode = false;
+    
+    // Find matching protocol
+    const SubGhzProtocol* custom_protocol = NULL;
+    for(size_t i = 0; i < protopirate_protocol_registry.size; i++) {
+        if(protocol_names_match(proto_name, protopirate_protocol_registry.items[i]->name)) {
+            custom_protocol = protopirate_protocol_registry.items[i];
+            FURI_LOG_I(TAG, "Matched to: %s", custom_protocol->name);
+            break;
+        }
+    }
+    
+    if(custom_protocol && custom_protocol->decoder && custom_protocol->decoder->alloc) {
+        void* decoder = custom_protocol->decoder->alloc(app->txrx->environment);
+        if(decoder) {
+            flipper_format_rewind(ctx->key_file->data);
+            last_status = custom_protocol->decoder->deserialize(decoder, ctx->key_file->data);
             
-            if(protocol->decoder && protocol->decoder->alloc) {
-                ctx->current_decoder = protocol->decoder->alloc(app->txrx->environment);
-                ctx->current_protocol = protocol;
-                ctx->current_sample = 0;
-                ctx->callback_fired = false;
-                furi_string_reset(ctx->decoded_string);
+            if(last_status == SubGhzProtocolStatusOk) {
+                FuriString* dec_str = furi_string_alloc();
+                custom_protocol->decoder->get_string(decoder, dec_str);
+                
+                const char* fname = furi_string_get_cstr(ctx->file_path);
+                const char* short_name = strrchr(fname, '/');
+                if(short_name) short_name++; else short_name = fname;
                 
-                if(ctx->current_decoder) {
-                    SubGhzProtocolDecoderBase* decoder_base = ctx->current_decoder;
-                    decoder_base->callback = protopirate_decode_callback;
-                    decoder_base->context = ctx;
-                    
-                    if(protocol->decoder->reset) {
-                        protocol->decoder->reset(ctx->current_decoder);
+                furi_string_printf(ctx->result, "File: %s\n\n%s", 
+                    short_name, furi_string_get_cstr(dec_str));
+                furi_string_free(dec_str);
+                decoded = true;
+                ctx->decode_success = true;
+                ctx->can_save = true;
+
+                // Copy the file data for saving
+                ctx->save_data = flipper_format_string_alloc();
+                custom_protocol->decoder->serialize(decoder, ctx->save_data, app->txrx->preset);
+            } else if(last_status == SubGhzProtocolStatusErrorValueBitCount) {
+                // Bit count mismatch - try to still show data
+                FURI_LOG_W(TAG, "Bit count mismatch, attempting partial decode");
+                FuriString* dec_str = furi_string_alloc();
+                custom_protocol->decoder->get_string(decoder, dec_str);
+
+                if(furi_string_size(dec_str) > 0) {
+                    const char* fname = furi_string_get_cstr(ctx->file_path);
+                    const char* short_name = strrchr(fname, '/');
+                    if(short_name) short_name++; else short_name = fname;
+
+                    furi_string_printf(ctx->result,
+                        "File: %s\n"
+                        "WARNING: Bit count mismatch\n\n%s",
+                        short_name, furi_string_get_cstr(dec_str));
+                    partial_decode = true;
+                    ctx->decode_success = true;
+                    ctx->can_save = true;
+
+                    // Save what the file had, the decoder can't serialize it
+                    ProtoPirateKeyFile* key_file = ctx->key_file;
+                    ctx->save_data = flipper_format_string_alloc();
+                    flipper_format_write_header_cstr(ctx->save_data,
+                        furi_string_get_cstr(key_file->filetype), key_file->version);
+
+                    uint32_t freq = ctx->frequency;
+                    flipper_format_write_uint32(ctx->save_data, "Frequency", &freq, 1);
+                    if(key_file->fields & ProtoPirateKeyFileFieldPreset) {
+                        flipper_format_write_string(ctx->save_data, "Preset", key_file->preset);
                     }
-                    
-                    FURI_LOG_D(TAG, "Trying protocol: %s", protocol->name);
-                    break;
+
+                    flipper_format_write_string_cstr(ctx->save_data, "Protocol", proto_name);
                 }
+                furi_string_free(dec_str);
+            } else {
+                FURI_LOG_W(TAG, "Custom decoder failed: %d", last_status);
             }
-            ctx->current_protocol_idx++;
+            custom_protocol->decoder->free(decoder);
         }
-        
-        if(!ctx->current_decoder) {
-            return true;
-        }
-    }
-    
-    size_t end_sample = ctx->current_sample + SAMPLES_PER_TICK;
-    if(end_sample > ctx->total_samples) {
-        end_sample = ctx->total_samples;
     }
     
-    for(size_t i = ctx->current_sample; i < end_sample && !ctx->callback_fired; i++) {
-        int32_t duration = ctx->raw_samples[i];
-        bool level = (duration >= 0);
-        if(duration < 0) duration = -duration;
+    if(!decoded && !partial_decode) {
+        SubGhzProtocolDecoderBase* decoder = subghz_receiver_search_decoder_base_by_name(
+            app->txrx->receiver, proto_name);
         
-        ctx->current_protocol->decoder->feed(ctx->current_decoder, level, (uint32_t)duration);
-    }
-    
-    ctx->current_sample = end_sample;
-    
-    if(ctx->callback_fired && furi_string_size(ctx->decoded_string) > 0) {
-        furi_string_printf(ctx->result, "RAW Decoded!\nFreq: %lu.%02lu MHz\n\n%s",
-            ctx->frequency / 1000000,
-            (ctx->frequency % 1000000) / 10000,
-            furi_string_get_cstr(ctx->decoded_string));
-        ctx->decode_success = true;
-        ctx->can_save = true;
-
-        // Serialize the decoded data BEFORE freeing the decoder
-        ctx->save_data = flipper_format_string_alloc();
-        if(ctx->current_protocol->decoder->serialize) {
-            // Create a temporary preset for serialization
-            SubGhzRadioPreset temp_preset;
-            temp_preset.frequency = ctx->frequency;
-            temp_preset.name = furi_string_alloc_set("AM650");
-            temp_preset.data = NULL;
-            temp_preset.data_size = 0;
-
-            SubGhzProtocolStatus status = ctx->current_protocol->decoder->serialize(
-                ctx->current_decoder, ctx->save_data, &temp_preset);
-
-            if(status != SubGhzProtocolStatusOk) {
-                FURI_LOG_W(TAG, "RAW serialize failed: %d", status);
-                flipper_format_free(ctx->save_data);
-                ctx->save_data = NULL;
-                ctx->can_save = false;
+        if(decoder) {
+            flipper_format_rewind(ctx->key_file->data);
+            last_status = subghz_protocol_decoder_base_deserialize(decoder, ctx->key_file->data);
+            
+            if(last_status == SubGhzProtocolStatusOk) {
+                FuriString* dec_str = furi_string_alloc();
+                subghz_protocol_decoder_base_get_string(decoder, dec_str);
+                
+                const char* fname = furi_string_get_cstr(ctx->file_path);
+                const char* short_name = strrchr(fname, '/');
+                if(short_name) short_name++; else short_name = fname;
+                
+                furi_string_printf(ctx->result, "File: %s\n\n%s", 
+                    short_name, furi_string_get_cstr(dec_str));
+                furi_string_free(dec_str);
+                decoded = true;
+                ctx->decode_success = true;
+            } else if(last_status == SubGhzProtocolStatusErrorValueBitCount) {
+                // Bit count mismatch - try to still show data
+                FURI_LOG_W(TAG, "Bit count mismatch (base), attempting partial decode");
+                FuriString* dec_str = furi_string_alloc();
+                subghz_protocol_decoder_base_get_string(decoder, dec_str);
+
+                if(furi_string_size(dec_str) > 0) {
+                    const char* fname = furi_string_get_cstr(ctx->file_path);
+                    const char* short_name = strrchr(fname, '/');
+                    if(short_name) short_name++; else short_name = fname;
+
+                    furi_string_printf(ctx->result,
+                        "File: %s\n"
+                        "WARNING: Bit count mismatch\n\n%s",
+                        short_name, furi_string_get_cstr(dec_str));
+                    partial_decode = true;
+                    ctx->decode_success = true;
+                }
+                furi_string_free(dec_str);
             } else {
-                FURI_LOG_I(TAG, "RAW serialize success for %s", ctx->current_protocol->name);
+                FURI_LOG_W(TAG, "App receiver failed: %d", last_status);
             }
-
-            furi_string_free(temp_preset.name);
-        } else {
-            FURI_LOG_W(TAG, "Protocol %s has no serialize function", ctx->current_protocol->name);
-            flipper_format_free(ctx->save_data);
-            ctx->save_data = NULL;
-            ctx->can_save = false;
         }
-        
-        ctx->current_protocol->decoder->free(ctx->current_decoder);
-        ctx->current_decoder = NULL;
-        return true;
     }
     
-    if(ctx->current_sample >= ctx->total_samples) {
-        if(ctx->current_decoder) {
-            ctx->current_protocol->decoder->free(ctx->current_decoder);
-            ctx->current_decoder = NULL;
-        }
-        ctx->current_protocol_idx++;
-        ctx->current_sample = 0;
+    if(!decoded && !partial_decode) {
+        const char* fname = furi_string_get_cstr(ctx->file_path);
+        const char* short_name = strrchr(fname, '/');
+        if(short_name) short_name++; else short_name = fname;
+        
+        // Set error info based on status
+        furi_string_set(ctx->error_info, get_protocol_status_string(last_status));
         
-        if(ctx->current_protocol_idx >= protopirate_protocol_registry.size) {
-            return true;
+        furi_string_printf(ctx->result, "File: %s\nProtocol: %s\n\nError: %s\n\n", 
+            short_name, proto_name, get_protocol_status_string(last_status));
+        
+        // Show what the file has
+        ProtoPirateKeyFile* key_file = ctx->key_file;
+        if(key_file->fields & ProtoPirateKeyFileFieldBit) {
+            furi_string_cat_printf(ctx->result, "Bits: %lu\n", key_file->bit);
+        }
+
+        if(key_file->fields & ProtoPirateKeyFileFieldKey) {
+            furi_string_cat_str(ctx->result, "Key:");
+            for(size_t i = 0; i < key_file->key_size; i++) {
+                furi_string_cat_printf(ctx->result, " %02X", key_file->key[i]);
+            }
+            furi_string_push_back(ctx->result, '\n');
         }
+        
+        furi_string_cat_printf(ctx->result, "Freq: %lu.%02lu MHz\n",
+            ctx->frequency / 1000000, (ctx->frequency % 1000000) / 10000);
     }
-    
-    return false;
+
+    return ctx->decode_success;
 }
 
-static void close_file_handles(SubDecodeContext* ctx) {
-    if(ctx->ff) {
-        flipper_format_free(ctx->ff);
-        ctx->ff = NULL;
-    }
-    if(ctx->storage) {
-        furi_record_close(RECORD_STORAGE);
-        ctx->storage = NULL;
+// Runs the whole decode off the GUI thread, the scene tick only animates
+static int32_t protopirate_decode_worker(void* context) {
+    SubDecodeContext* ctx = context;
+    ProtoPirateApp* app = ctx->app;
+    bool success = false;
+
+    do {
+        ctx->state = DecodeStateOpenFile;
+        if(!protopirate_decode_open_file(ctx)) break;
+
+        ctx->state = DecodeStateReadHeader;
+        if(!protopirate_decode_read_header(ctx)) break;
+
+        if(furi_string_cmp_str(ctx->protocol_name, "RAW") == 0) {
+            ctx->state = DecodeStateDecodingRaw;
+            success = protopirate_decode_raw(app, ctx);
+        } else {
+            // Everything is in key_file now
+            close_file_handles(ctx);
+            ctx->state = DecodeStateDecodingProtocol;
+            success = protopirate_decode_protocol(app, ctx);
+        }
+    } while(false);
+
+    close_file_handles(ctx);
+
+    if(ctx->cancel_requested) {
+        success = false;
+        ctx->decode_success = false;
+        ctx->can_save = false;
+        furi_string_set(ctx->error_info, "Cancelled");
+        furi_string_set(ctx->result, "Cancelled by user");
     }
+
+    notification_message(app->notifications, success ? &sequence_success : &sequence_error);
+    ctx->result_display_counter = 0;
+    ctx->state = success ? DecodeStateShowSuccess : DecodeStateShowFailure;
+    return 0;
 }
 
 // Widget callback for save button
@@ -567,16 +917,95 @@ static void protopirate_scene_sub_decode_widget_callback(
     }
 }
 
+static void protopirate_decode_hit_submenu_callback(void* context, uint32_t index) {
+    ProtoPirateApp* app = context;
+    if(g_decode_ctx) {
+        g_decode_ctx->selected_hit = index;
+    }
+    view_dispatcher_send_custom_event(app->view_dispatcher, ProtoPirateCustomEventSubDecodeSelect);
+}
+
+static void protopirate_decode_show_result(ProtoPirateApp* app, SubDecodeContext* ctx) {
+    widget_reset(app->widget);
+    if(ctx->decode_success) {
+        widget_add_text_scroll_element(app->widget, 0, 0, 128, 54, furi_string_get_cstr(ctx->result));
+
+        // Add save button if we can save
+        if(ctx->can_save) {
+            widget_add_button_element(
+                app->widget,
+                GuiButtonTypeRight,
+                "Save",
+                protopirate_scene_sub_decode_widget_callback,
+                app);
+        }
+    } else {
+        widget_add_text_scroll_element(app->widget, 0, 0, 128, 64, furi_string_get_cstr(ctx->result));
+    }
+    view_dispatcher_switch_to_view(app->view_dispatcher, ProtoPirateViewWidget);
+}
+
+static void protopirate_decode_show_hit(ProtoPirateApp* app, SubDecodeContext* ctx, size_t index) {
+    SubDecodeHit* hit = &ctx->hits[index];
+    ctx->selected_hit = index;
+    ctx->showing_hit = true;
+
+    furi_string_printf(ctx->result, "RAW Decoded! (%zu/%zu)\nFreq: %lu.%02lu MHz\n",
+        index + 1,
+        ctx->hit_count,
+        ctx->frequency / 1000000,
+        (ctx->frequency % 1000000) / 10000);
+    furi_string_cat_printf(ctx->result, "At: %lu.%03lus (sample %lu)\n",
+        hit->time_ms / 1000, hit->time_ms % 1000, hit->sample_offset);
+    if(hit->repeats > 1) {
+        furi_string_cat_printf(ctx->result, "x%u repeats\n", hit->repeats);
+    }
+    furi_string_cat_printf(ctx->result, "\n%s", furi_string_get_cstr(hit->text));
+
+    ctx->can_save = (hit->data != NULL);
+    protopirate_decode_show_result(app, ctx);
+}
+
+static void protopirate_decode_show_hit_list(ProtoPirateApp* app, SubDecodeContext* ctx) {
+    ctx->showing_hit = false;
+    submenu_reset(app->submenu);
+
+    FuriString* label = furi_string_alloc();
+    furi_string_printf(label, "%zu%s frames found", ctx->hit_count, ctx->hits_dropped ? "+" : "");
+    submenu_set_header(app->submenu, furi_string_get_cstr(label));
+
+    for(size_t i = 0; i < ctx->hit_count; i++) {
+        SubDecodeHit* hit = &ctx->hits[i];
+        furi_string_printf(label, "%lu.%lus %s", hit->time_ms / 1000, (hit->time_ms % 1000) / 100,
+            hit->protocol->name);
+        if(hit->repeats > 1) {
+            furi_string_cat_printf(label, " x%u", hit->repeats);
+        }
+        submenu_add_item(
+            app->submenu,
+            furi_string_get_cstr(label),
+            i,
+            protopirate_decode_hit_submenu_callback,
+            app);
+    }
+    furi_string_free(label);
+
+    submenu_set_selected_item(app->submenu, ctx->selected_hit);
+    view_dispatcher_switch_to_view(app->view_dispatcher, ProtoPirateViewSubmenu);
+}
+
 void protopirate_scene_sub_decode_on_enter(void* context) {
     ProtoPirateApp* app = context;
     
     g_decode_ctx = malloc(sizeof(SubDecodeContext));
     memset(g_decode_ctx, 0, sizeof(SubDecodeContext));
+    g_decode_ctx->app = app;
     g_decode_ctx->file_path = furi_string_alloc();
     g_decode_ctx->protocol_name = furi_string_alloc();
     g_decode_ctx->result = furi_string_alloc();
     g_decode_ctx->error_info = furi_string_alloc();
     g_decode_ctx->decoded_string = furi_string_alloc();
+    g_decode_ctx->key_file = protopirate_key_file_alloc();
     g_decode_ctx->state = DecodeStateIdle;
     g_decode_ctx->can_save = false;
     g_decode_ctx->save_data = NULL;
@@ -598,6 +1027,11 @@ void protopirate_scene_sub_decode_on_enter(void* context) {
         view_set_context(app->view_about, app);
         
         view_dispatcher_switch_to_view(app->view_dispatcher, ProtoPirateViewAbout);
+
+        g_decode_ctx->worker = furi_thread_alloc_ex(
+            "ProtoPirateDecode", DECODE_WORKER_STACK_SIZE, protopirate_decode_worker, g_decode_ctx);
+        furi_thread_set_priority(g_decode_ctx->worker, FuriThreadPriorityLow);
+        furi_thread_start(g_decode_ctx->worker);
     } else {
         scene_manager_previous_scene(app->scene_manager);
     }
@@ -614,12 +1048,16 @@ bool protopirate_scene_sub_decode_on_event(void* context, SceneManagerEvent even
     
     if(event.type == SceneManagerEventTypeCustom) {
         if(event.event == ProtoPirateCustomEventSubDecodeSave) {
-            // Save the file
-            if(ctx->save_data) {
+            // Save the file, RAW captures save the hit that is on screen
+            FlipperFormat* save_data = ctx->save_data;
+            if(ctx->hit_count > 0) {
+                save_data = ctx->hits[ctx->selected_hit].data;
+            }
+            if(save_data) {
                 FuriString* protocol = furi_string_alloc();
-                flipper_format_rewind(ctx->save_data);
+                flipper_format_rewind(save_data);
 
-                if(!flipper_format_read_string(ctx->save_data, "Protocol", protocol)) {
+                if(!flipper_format_read_string(save_data, "Protocol", protocol)) {
                     furi_string_set_str(protocol, "Unknown");
                     FURI_LOG_W(TAG, "Could not read Protocol from save_data");
                 }
@@ -632,7 +1070,7 @@ bool protopirate_scene_sub_decode_on_event(void* context, SceneManagerEvent even
 
                 FuriString* saved_path = furi_string_alloc();
                 if(protopirate_storage_save_capture(
-                    ctx->save_data, furi_string_get_cstr(protocol), saved_path)) {
+                    save_data, furi_string_get_cstr(protocol), saved_path)) {
                     FURI_LOG_I(TAG, "Saved to: %s", furi_string_get_cstr(saved_path));
                     notification_message(app->notifications, &sequence_success);
                 } else {
@@ -647,6 +1085,18 @@ bool protopirate_scene_sub_decode_on_event(void* context, SceneManagerEvent even
                 notification_message(app->notifications, &sequence_error);
             }
             consumed = true;
+        } else if(event.event == ProtoPirateCustomEventSubDecodeSelect) {
+            protopirate_decode_show_hit(app, ctx, ctx->selected_hit);
+            consumed = true;
+        }
+        return consumed;
+    }
+
+    // Back from a single frame returns to the list of frames
+    if(event.type == SceneManagerEventTypeBack) {
+        if(ctx->state == DecodeStateDone && ctx->showing_hit && ctx->hit_count > 1) {
+            protopirate_decode_show_hit_list(app, ctx);
+            consumed = true;
         }
         return consumed;
     }
@@ -656,364 +1106,16 @@ bool protopirate_scene_sub_decode_on_event(void* context, SceneManagerEvent even
         ctx->animation_frame++;
         
         switch(ctx->state) {
-        case DecodeStateOpenFile: {
-            ctx->storage = furi_record_open(RECORD_STORAGE);
-            ctx->ff = flipper_format_file_alloc(ctx->storage);
-            
-            if(!flipper_format_file_open_existing(ctx->ff, furi_string_get_cstr(ctx->file_path))) {
-                furi_string_set(ctx->result, "Failed to open file");
-                furi_string_set(ctx->error_info, "File open failed");
-                close_file_handles(ctx);
-                ctx->state = DecodeStateShowFailure;
-                ctx->result_display_counter = 0;
-                notification_message(app->notifications, &sequence_error);
-            } else {
-                ctx->state = DecodeStateReadHeader;
-            }
-            break;
-        }
-        
-        case DecodeStateReadHeader: {
-            FuriString* temp_str = furi_string_alloc();
-            uint32_t version = 0;
-            bool success = false;
-            
-            do {
-                if(!flipper_format_read_header(ctx->ff, temp_str, &version)) {
-                    furi_string_set(ctx->result, "Invalid file format");
-                    furi_string_set(ctx->error_info, "Invalid header");
-                    break;
-                }
-                
-                if(furi_string_cmp_str(temp_str, "Flipper SubGhz Key File") != 0 &&
-                   furi_string_cmp_str(temp_str, "Flipper SubGhz RAW File") != 0 &&
-                   furi_string_cmp_str(temp_str, "Flipper SubGhz") != 0) {
-                    furi_string_set(ctx->result, "Not a SubGhz file");
-                    furi_string_set(ctx->error_info, "Not SubGhz file");
-                    break;
-                }
-                
-                if(!flipper_format_read_string(ctx->ff, "Protocol", ctx->protocol_name)) {
-                    furi_string_set(ctx->result, "Missing Protocol");
-                    furi_string_set(ctx->error_info, "No protocol field");
-                    break;
-                }
-                
-                flipper_format_rewind(ctx->ff);
-                flipper_format_read_header(ctx->ff, temp_str, &version);
-                ctx->frequency = 433920000;
-                flipper_format_read_uint32(ctx->ff, "Frequency", &ctx->frequency, 1);
-                
-                FURI_LOG_I(TAG, "Protocol: %s, Freq: %lu", 
-                    furi_string_get_cstr(ctx->protocol_name), ctx->frequency);
-                
-                success = true;
-            } while(false);
-            
-            furi_string_free(temp_str);
-            
-            if(!success) {
-                close_file_handles(ctx);
-                ctx->state = DecodeStateShowFailure;
-                ctx->result_display_counter = 0;
-                notification_message(app->notifications, &sequence_error);
-            } else if(furi_string_cmp_str(ctx->protocol_name, "RAW") == 0) {
-                ctx->raw_samples = malloc(sizeof(int32_t) * MAX_RAW_SAMPLES);
-                if(!ctx->raw_samples) {
-                    furi_string_set(ctx->result, "Memory error");
-                    furi_string_set(ctx->error_info, "Out of memory");
-                    close_file_handles(ctx);
-                    ctx->state = DecodeStateShowFailure;
-                    ctx->result_display_counter = 0;
-                    notification_message(app->notifications, &sequence_error);
-                } else {
-                    ctx->total_samples = 0;
-                    flipper_format_rewind(ctx->ff);
-                    ctx->state = DecodeStateLoadRawSamples;
-                }
-            } else {
-                ctx->state = DecodeStateDecodingProtocol;
-            }
-            break;
-        }
-        
-        case DecodeStateLoadRawSamples: {
-            size_t samples_this_tick = 0;
-            
-            while(ctx->total_samples < MAX_RAW_SAMPLES && samples_this_tick < 512) {
-                uint32_t count = 0;
-                if(!flipper_format_get_value_count(ctx->ff, "RAW_Data", &count) || count == 0) {
-                    break;
-                }
-                
-                size_t to_read = count;
-                if(ctx->total_samples + to_read > MAX_RAW_SAMPLES) {
-                    to_read = MAX_RAW_SAMPLES - ctx->total_samples;
-                }
-                
-                if(!flipper_format_read_int32(ctx->ff, "RAW_Data", &ctx->raw_samples[ctx->total_samples], to_read)) {
-                    break;
-                }
-                
-                ctx->total_samples += to_read;
-                samples_this_tick += to_read;
-            }
-            
-            uint32_t count = 0;
-            bool more_data = flipper_format_get_value_count(ctx->ff, "RAW_Data", &count) && count > 0;
-            
-            if(!more_data || ctx->total_samples >= MAX_RAW_SAMPLES) {
-                close_file_handles(ctx);
-                
-                FURI_LOG_I(TAG, "Loaded %zu RAW samples", ctx->total_samples);
-                
-                if(ctx->total_samples < 10) {
-                    furi_string_set(ctx->result, "Not enough samples");
-                    furi_string_set(ctx->error_info, "Too few samples");
-                    ctx->state = DecodeStateShowFailure;
-                    ctx->result_display_counter = 0;
-                    notification_message(app->notifications, &sequence_error);
-                } else {
-                    ctx->current_protocol_idx = 0;
-                    ctx->current_sample = 0;
-                    ctx->state = DecodeStateDecodingRaw;
-                }
-            }
-            break;
-        }
-        
-        case DecodeStateDecodingRaw: {
-            bool done = protopirate_process_raw_chunk(app, ctx);
-            
-            if(done) {
-                if(ctx->decode_success) {
-                    ctx->state = DecodeStateShowSuccess;
-                    ctx->result_display_counter = 0;
-                    notification_message(app->notifications, &sequence_success);
-                } else {
-                    furi_string_printf(ctx->result,
-                        "RAW Signal\n\n"
-                        "Freq: %lu.%02lu MHz\n"
-                        "Samples: %zu\n\n"
-                        "No ProtoPirate protocol\n"
-                        "detected in signal.",
-                        ctx->frequency / 1000000,
-                        (ctx->frequency % 1000000) / 10000,
-                        ctx->total_samples);
-                    furi_string_set(ctx->error_info, "No protocol match");
-                    ctx->state = DecodeStateShowFailure;
-                    ctx->result_display_counter = 0;
-                    notification_message(app->notifications, &sequence_error);
-                }
-            }
-            break;
-        }
-        
-        case DecodeStateDecodingProtocol: {
-            const char* proto_name = furi_string_get_cstr(ctx->protocol_name);
-            bool decoded = false;
-            SubGhzProtocolStatus last_status = SubGhzProtocolStatusOk;
-            bool partial_decode = false;
-            
-            // Find matching protocol
-            const SubGhzProtocol* custom_protocol = NULL;
-            for(size_t i = 0; i < protopirate_protocol_registry.size; i++) {
-                if(protocol_names_match(proto_name, protopirate_protocol_registry.items[i]->name)) {
-                    custom_protocol = protopirate_protocol_registry.items[i];
-                    FURI_LOG_I(TAG, "Matched to: %s", custom_protocol->name);
-                    break;
-                }
-            }
-            
-            if(custom_protocol && custom_protocol->decoder && custom_protocol->decoder->alloc) {
-                void* decoder = custom_protocol->decoder->alloc(app->txrx->environment);
-                if(decoder) {
-                    flipper_format_rewind(ctx->ff);
-                    last_status = custom_protocol->decoder->deserialize(decoder, ctx->ff);
-                    
-                    if(last_status == SubGhzProtocolStatusOk) {
-                        FuriString* dec_str = furi_string_alloc();
-                        custom_protocol->decoder->get_string(decoder, dec_str);
-                        
-                        const char* fname = furi_string_get_cstr(ctx->file_path);
-                        const char* short_name = strrchr(fname, '/');
-                        if(short_name) short_name++; else short_name = fname;
-                        
-                        furi_string_printf(ctx->result, "File: %s\n\n%s", 
-                            short_name, furi_string_get_cstr(dec_str));
-                        furi_string_free(dec_str);
-                        decoded = true;
-                        ctx->decode_success = true;
-                        ctx->can_save = true;
-
-                        // Copy the file data for saving
-                        ctx->save_data = flipper_format_string_alloc();
-                        flipper_format_rewind(ctx->ff);
-                        custom_protocol->decoder->serialize(decoder, ctx->save_data, app->txrx->preset);
-                    } else if(last_status == SubGhzProtocolStatusErrorValueBitCount) {
-                        // Bit count mismatch - try to still show data
-                        FURI_LOG_W(TAG, "Bit count mismatch, attempting partial decode");
-                        FuriString* dec_str = furi_string_alloc();
-                        custom_protocol->decoder->get_string(decoder, dec_str);
-
-                        if(furi_string_size(dec_str) > 0) {
-                            const char* fname = furi_string_get_cstr(ctx->file_path);
-                            const char* short_name = strrchr(fname, '/');
-                            if(short_name) short_name++; else short_name = fname;
-
-                            furi_string_printf(ctx->result,
-                                "File: %s\n"
-                                "WARNING: Bit count mismatch\n\n%s",
-                                short_name, furi_string_get_cstr(dec_str));
-                            partial_decode = true;
-                            ctx->decode_success = true;
-                            ctx->can_save = true;
-
-                            // Copy the file for saving (original file data)
-                            ctx->save_data = flipper_format_string_alloc();
-                            flipper_format_rewind(ctx->ff);
-
-                            // Read entire file into save_data
-                            FuriString* header = furi_string_alloc();
-                            uint32_t ver;
-                            flipper_format_read_header(ctx->ff, header, &ver);
-                            flipper_format_write_header_cstr(ctx->save_data,
-                                furi_string_get_cstr(header), ver);
-                            furi_string_free(header);
-
-                            // Copy key fields
-                            uint32_t freq = ctx->frequency;
-                            flipper_format_write_uint32(ctx->save_data, "Frequency", &freq, 1);
-
-                            flipper_format_rewind(ctx->ff);
-                            FuriString* preset = furi_string_alloc();
-                            uint32_t dummy;
-                            flipper_format_read_header(ctx->ff, preset, &dummy);
-                            if(flipper_format_read_string(ctx->ff, "Preset", preset)) {
-                                flipper_format_write_string(ctx->save_data, "Preset", preset);
-                            }
-                            furi_string_free(preset);
-
-                            flipper_format_write_string_cstr(ctx->save_data, "Protocol", proto_name);
-                        }
-                        furi_string_free(dec_str);
-                    } else {
-                        FURI_LOG_W(TAG, "Custom decoder failed: %d", last_status);
-                    }
-                    custom_protocol->decoder->free(decoder);
-                }
-            }
-            
-            if(!decoded && !partial_decode) {
-                SubGhzProtocolDecoderBase* decoder = subghz_receiver_search_decoder_base_by_name(
-                    app->txrx->receiver, proto_name);
-                
-                if(decoder) {
-                    flipper_format_rewind(ctx->ff);
-                    last_status = subghz_protocol_decoder_base_deserialize(decoder, ctx->ff);
-                    
-                    if(last_status == SubGhzProtocolStatusOk) {
-                        FuriString* dec_str = furi_string_alloc();
-                        subghz_protocol_decoder_base_get_string(decoder, dec_str);
-                        
-                        const char* fname = furi_string_get_cstr(ctx->file_path);
-                        const char* short_name = strrchr(fname, '/');
-                        if(short_name) short_name++; else short_name = fname;
-                        
-                        furi_string_printf(ctx->result, "File: %s\n\n%s", 
-                            short_name, furi_string_get_cstr(dec_str));
-                        furi_string_free(dec_str);
-                        decoded = true;
-                        ctx->decode_success = true;
-                    } else if(last_status == SubGhzProtocolStatusErrorValueBitCount) {
-                        // Bit count mismatch - try to still show data
-                        FURI_LOG_W(TAG, "Bit count mismatch (base), attempting partial decode");
-                        FuriString* dec_str = furi_string_alloc();
-                        subghz_protocol_decoder_base_get_string(decoder, dec_str);
-
-                        if(furi_string_size(dec_str) > 0) {
-                            const char* fname = furi_string_get_cstr(ctx->file_path);
-                            const char* short_name = strrchr(fname, '/');
-                            if(short_name) short_name++; else short_name = fname;
-
-                            furi_string_printf(ctx->result,
-                                "File: %s\n"
-                                "WARNING: Bit count mismatch\n\n%s",
-                                short_name, furi_string_get_cstr(dec_str));
-                            partial_decode = true;
-                            ctx->decode_success = true;
-                        }
-                        furi_string_free(dec_str);
-                    } else {
-                        FURI_LOG_W(TAG, "App receiver failed: %d", last_status);
-                    }
-                }
-            }
-            
-            if(!decoded && !partial_decode) {
-                const char* fname = furi_string_get_cstr(ctx->file_path);
-                const char* short_name = strrchr(fname, '/');
-                if(short_name) short_name++; else short_name = fname;
-                
-                // Set error info based on status
-                furi_string_set(ctx->error_info, get_protocol_status_string(last_status));
-                
-                furi_string_printf(ctx->result, "File: %s\nProtocol: %s\n\nError: %s\n\n", 
-                    short_name, proto_name, get_protocol_status_string(last_status));
-                
-                // Read available fields to show what we can
-                FuriString* temp = furi_string_alloc();
-                uint32_t version, val;
-                
-                flipper_format_rewind(ctx->ff);
-                flipper_format_read_header(ctx->ff, temp, &version);
-                if(flipper_format_read_uint32(ctx->ff, "Bit", &val, 1)) {
-                    furi_string_cat_printf(ctx->result, "Bits: %lu\n", val);
-                }
-                
-                flipper_format_rewind(ctx->ff);
-                flipper_format_read_header(ctx->ff, temp, &version);
-                if(flipper_format_read_string(ctx->ff, "Key", temp)) {
-                    furi_string_cat_printf(ctx->result, "Key: %s\n", furi_string_get_cstr(temp));
-                }
-                
-                furi_string_cat_printf(ctx->result, "Freq: %lu.%02lu MHz\n",
-                    ctx->frequency / 1000000, (ctx->frequency % 1000000) / 10000);
-                
-                furi_string_free(temp);
-            }
-            
-            close_file_handles(ctx);
-            
-            if(ctx->decode_success) {
-                ctx->state = DecodeStateShowSuccess;
-                ctx->result_display_counter = 0;
-                notification_message(app->notifications, &sequence_success);
-            } else {
-                ctx->state = DecodeStateShowFailure;
-                ctx->result_display_counter = 0;
-                notification_message(app->notifications, &sequence_error);
-            }
-            break;
-        }
-        
         case DecodeStateShowSuccess: {
             ctx->result_display_counter++;
             if(ctx->result_display_counter >= SUCCESS_DISPLAY_TICKS) {
-                widget_reset(app->widget);
-                widget_add_text_scroll_element(app->widget, 0, 0, 128, 54, furi_string_get_cstr(ctx->result));
-
-                // Add save button if we can save
-                if(ctx->can_save) {
-                    widget_add_button_element(
-                        app->widget,
-                        GuiButtonTypeRight,
-                        "Save",
-                        protopirate_scene_sub_decode_widget_callback,
-                        app);
+                if(ctx->hit_count > 1) {
+                    protopirate_decode_show_hit_list(app, ctx);
+                } else if(ctx->hit_count == 1) {
+                    protopirate_decode_show_hit(app, ctx, 0);
+                } else {
+                    protopirate_decode_show_result(app, ctx);
                 }
-
-                view_dispatcher_switch_to_view(app->view_dispatcher, ProtoPirateViewWidget);
                 ctx->state = DecodeStateDone;
             }
             break;
@@ -1022,9 +1124,7 @@ bool protopirate_scene_sub_decode_on_event(void* context, SceneManagerEvent even
         case DecodeStateShowFailure: {
             ctx->result_display_counter++;
             if(ctx->result_display_counter >= FAILURE_DISPLAY_TICKS) {
-                widget_reset(app->widget);
-                widget_add_text_scroll_element(app->widget, 0, 0, 128, 64, furi_string_get_cstr(ctx->result));
-                view_dispatcher_switch_to_view(app->view_dispatcher, ProtoPirateViewWidget);
+                protopirate_decode_show_result(app, ctx);
                 ctx->state = DecodeStateDone;
             }
             break;
@@ -1044,22 +1144,32 @@ void protopirate_scene_sub_decode_on_exit(void* context) {
     ProtoPirateApp* app = context;
     
     if(g_decode_ctx) {
+        if(g_decode_ctx->worker) {
+            g_decode_ctx->cancel_requested = true;
+            furi_thread_join(g_decode_ctx->worker);
+            furi_thread_free(g_decode_ctx->worker);
+            g_decode_ctx->worker = NULL;
+        }
         close_file_handles(g_decode_ctx);
         
-        if(g_decode_ctx->current_decoder && g_decode_ctx->current_protocol) {
-            g_decode_ctx->current_protocol->decoder->free(g_decode_ctx->current_decoder);
-        }
-        if(g_decode_ctx->raw_samples) {
-            free(g_decode_ctx->raw_samples);
+        if(g_decode_ctx->decoders) {
+            protopirate_decoder_set_free(g_decode_ctx->decoders);
         }
         if(g_decode_ctx->save_data) {
             flipper_format_free(g_decode_ctx->save_data);
         }
+        for(size_t i = 0; i < g_decode_ctx->hit_count; i++) {
+            furi_string_free(g_decode_ctx->hits[i].text);
+            if(g_decode_ctx->hits[i].data) {
+                flipper_format_free(g_decode_ctx->hits[i].data);
+            }
+        }
         furi_string_free(g_decode_ctx->file_path);
         furi_string_free(g_decode_ctx->protocol_name);
         furi_string_free(g_decode_ctx->result);
         furi_string_free(g_decode_ctx->error_info);
         furi_string_free(g_decode_ctx->decoded_string);
+        protopirate_key_file_free(g_decode_ctx->key_file);
         free(g_decode_ctx);
         g_decode_ctx = NULL;
     }
@@ -1067,4 +1177,5 @@ void protopirate_scene_sub_decode_on_exit(void* context) {
     view_set_draw_callback(app->view_about, NULL);
     view_set_input_callback(app->view_about, NULL);
     widget_reset(app->widget);
+    submenu_reset(app->submenu);
 }
\ No newline at end of file
@@ -11,12 +11,12 @@
 #define MENU_ITEMS   4u
 #define UNLOCK_CNT   3
 
+// A row as drawn, already cut to width
 typedef struct {
-    FuriString* item_str;
-    uint8_t type;
-} ProtoPirateReceiverMenuItem;
-
-ARRAY_DEF(ProtoPirateReceiverMenuItemArray, ProtoPirateReceiverMenuItem, M_POD_OPLIST)
+    FuriString* text;
+    uint32_t seq;
+    uint8_t width; // px it was fitted to, 0 when it needs filling again
+} ProtoPirateReceiverRow;
 
 struct ProtoPirateReceiver {
     View* view;
@@ -25,9 +25,15 @@ struct ProtoPirateReceiver {
 };
 
 typedef struct {
-    ProtoPirateReceiverMenuItemArray_t history_item_arr;
-    uint8_t list_offset;
-    uint8_t history_item;
+    // Nothing is kept per item, the visible ones are asked for through
+    // item_callback and cached in rows[seq % MENU_ITEMS]
+    ProtoPirateReceiverItemCallback item_callback;
+    void* item_context;
+    ProtoPirateReceiverRow rows[MENU_ITEMS];
+    uint32_t first_seq; // history sequence numbers of the items listed
+    uint32_t next_seq;
+    uint32_t list_offset; // seq of the top row
+    uint32_t history_item; // seq of the selected row
     float rssi;
     FuriString* frequency_str;
     FuriString* preset_str;
@@ -59,15 +65,33 @@ void protopirate_view_receiver_set_callback(
     receiver->context = context;
 }
 
+void protopirate_view_receiver_set_item_callback(
+    ProtoPirateReceiver* receiver,
+    ProtoPirateReceiverItemCallback callback,
+    void* context) {
+    furi_assert(receiver);
+    with_view_model(
+        receiver->view,
+        ProtoPirateReceiverModel * model,
+        {
+            model->item_callback = callback;
+            model->item_context = context;
+            for(size_t i = 0; i < MENU_ITEMS; i++) {
+                model->rows[i].width = 0;
+            }
+        },
+        true);
+}
+
 static void protopirate_view_receiver_update_offset(ProtoPirateReceiver* receiver) {
     furi_assert(receiver);
     with_view_model(
         receiver->view,
         ProtoPirateReceiverModel * model,
         {
-            size_t history_item = model->history_item;
-            size_t list_offset = model->list_offset;
-            size_t item_count = ProtoPirateReceiverMenuItemArray_size(model->history_item_arr);
+            uint32_t history_item = model->history_item;
+            uint32_t list_offset = model->list_offset;
+            uint32_t item_count = model->next_seq - model->first_seq;
 
             if(history_item < list_offset) {
                 model->list_offset = history_item;
@@ -75,33 +99,51 @@ static void protopirate_view_receiver_update_offset(ProtoPirateReceiver* receive
                 model->list_offset = history_item - (MENU_ITEMS - 1);
             }
 
-            if(item_count < MENU_ITEMS) {
-                model->list_offset = 0;
-            } else if(model->list_offset > (item_count - MENU_ITEMS)) {
-                model->list_offset = item_count - MENU_ITEMS;
+            if(item_count < MENU_ITEMS || model->list_offset < model->first_seq) {
+                model->list_offset = model->first_seq;
+            } else if(model->list_offset > (model->next_seq - MENU_ITEMS)) {
+                model->list_offset = model->next_seq - MENU_ITEMS;
             }
         },
         true);
 }
 
-void protopirate_view_receiver_add_item_to_menu(
+void protopirate_view_receiver_set_items(
     ProtoPirateReceiver* receiver,
-    const char* name,
-    uint8_t type) {
+    uint32_t first_seq,
+    uint32_t next_seq) {
     furi_assert(receiver);
     with_view_model(
         receiver->view,
         ProtoPirateReceiverModel * model,
         {
-            ProtoPirateReceiverMenuItem* item_menu =
-                ProtoPirateReceiverMenuItemArray_push_raw(model->history_item_arr);
-            item_menu->item_str = furi_string_alloc_set(name);
-            item_menu->type = type;
+            if(model->first_seq == model->next_seq) {
+                model->list_offset = first_seq;
+                model->history_item = first_seq;
+            } else if(model->history_item < first_seq) {
+                model->history_item = first_seq;
+            }
+            model->first_seq = first_seq;
+            model->next_seq = next_seq;
         },
         true);
     protopirate_view_receiver_update_offset(receiver);
 }
 
+void protopirate_view_receiver_update_item(ProtoPirateReceiver* receiver, uint32_t seq) {
+    furi_assert(receiver);
+    with_view_model(
+        receiver->view,
+        ProtoPirateReceiverModel * model,
+        {
+            ProtoPirateReceiverRow* row = &model->rows[seq % MENU_ITEMS];
+            if(row->seq == seq) {
+                row->width = 0;
+            }
+        },
+        true);
+}
+
 void protopirate_view_receiver_add_data_statusbar(
     ProtoPirateReceiver* receiver,
     const char* frequency_str,
@@ -121,6 +163,39 @@ void protopirate_view_receiver_add_data_statusbar(
         true);
 }
 
+// Text of row seq, from the cache unless it was dropped or the width changed
+static const char* protopirate_view_receiver_get_row(
+    Canvas* canvas,
+    ProtoPirateReceiverModel* model,
+    uint32_t seq,
+    uint8_t width) {
+    ProtoPirateReceiverRow* row = &model->rows[seq % MENU_ITEMS];
+
+    if(row->seq != seq || row->width != width) {
+        uint16_t repeats = 1;
+        if(model->item_callback) {
+            repeats = model->item_callback(row->text, seq, model->item_context);
+        } else {
+            furi_string_reset(row->text);
+        }
+
+        if(repeats > 1) {
+            char suffix[8];
+            snprintf(suffix, sizeof(suffix), " x%u", repeats);
+            elements_string_fit_width(
+                canvas, row->text, width - canvas_string_width(canvas, suffix));
+            furi_string_cat_str(row->text, suffix);
+        } else {
+            elements_string_fit_width(canvas, row->text, width);
+        }
+
+        row->seq = seq;
+        row->width = width;
+    }
+
+    return furi_string_get_cstr(row->text);
+}
+
 static void protopirate_view_receiver_draw_frame(Canvas* canvas, uint16_t idx, bool scrollbar) {
     canvas_set_color(canvas, ColorBlack);
     canvas_draw_box(canvas, 0, 0 + idx * FRAME_HEIGHT, scrollbar ? 122 : 127, FRAME_HEIGHT);
@@ -143,7 +218,7 @@ void protopirate_view_receiver_draw(Canvas* canvas, ProtoPirateReceiverModel* mo
     // Increment animation frame
     model->animation_frame = (model->animation_frame + 1) % 96;
 
-    size_t item_count = ProtoPirateReceiverMenuItemArray_size(model->history_item_arr);
+    size_t item_count = model->next_seq - model->first_seq;
     bool scrollbar = item_count > MENU_ITEMS;
 
     // Draw EXT/INT indicator in upper right corner
@@ -154,20 +229,14 @@ void protopirate_view_receiver_draw(Canvas* canvas, ProtoPirateReceiverModel* mo
         canvas_draw_str_aligned(canvas, 127, 0, AlignRight, AlignTop, "INT");
     }
 
-    FuriString* str_buff;
-    str_buff = furi_string_alloc();
-
     if(item_count > 0) {
         // Draw received items list
-        size_t shift_position = model->list_offset;
+        size_t shift_position = model->list_offset - model->first_seq;
 
         for(size_t i = 0; i < MIN(item_count, MENU_ITEMS); i++) {
-            size_t idx = shift_position + i;
-            ProtoPirateReceiverMenuItem* item =
-                ProtoPirateReceiverMenuItemArray_get(model->history_item_arr, idx);
-
-            furi_string_set(str_buff, item->item_str);
-            elements_string_fit_width(canvas, str_buff, scrollbar ? MAX_LEN_PX - 6 : MAX_LEN_PX);
+            uint32_t idx = model->list_offset + i;
+            const char* text = protopirate_view_receiver_get_row(
+                canvas, model, idx, scrollbar ? MAX_LEN_PX - 6 : MAX_LEN_PX);
 
             if(model->history_item == idx) {
                 protopirate_view_receiver_draw_frame(canvas, i, scrollbar);
@@ -175,7 +244,7 @@ void protopirate_view_receiver_draw(Canvas* canvas, ProtoPirateReceiverModel* mo
                 canvas_set_color(canvas, ColorBlack);
             }
 
-            canvas_draw_str(canvas, 4, 9 + (i * FRAME_HEIGHT), furi_string_get_cstr(str_buff));
+            canvas_draw_str(canvas, 4, 9 + (i * FRAME_HEIGHT), text);
         }
 
         if(scrollbar) {
@@ -275,13 +344,12 @@ void protopirate_view_receiver_draw(Canvas* canvas, ProtoPirateReceiverModel* mo
             canvas_draw_dot(canvas, center_x, center_y);
         }
         
-        // Left-aligned config hint
+        // Config and stats hints
         canvas_set_font(canvas, FontSecondary);
         canvas_draw_str(canvas, 2, 45, "< Config");
+        canvas_draw_str_aligned(canvas, 126, 45, AlignRight, AlignBottom, "Stats >");
     }
 
-    furi_string_free(str_buff);
-
     // Status bar separator
     canvas_set_color(canvas, ColorBlack);
     canvas_draw_line(canvas, 0, 48, 127, 48);
@@ -370,7 +438,7 @@ bool protopirate_view_receiver_input(InputEvent* event, void* context) {
                 receiver->view,
                 ProtoPirateReceiverModel * model,
                 {
-                    if(model->history_item > 0) {
+                    if(model->history_item > model->first_seq) {
                         model->history_item--;
                     }
                 },
@@ -383,9 +451,7 @@ bool protopirate_view_receiver_input(InputEvent* event, void* context) {
                 receiver->view,
                 ProtoPirateReceiverModel * model,
                 {
-                    size_t item_count =
-                        ProtoPirateReceiverMenuItemArray_size(model->history_item_arr);
-                    if(item_count > 0 && model->history_item < item_count - 1) {
+                    if(model->history_item + 1 < model->next_seq) {
                         model->history_item++;
                     }
                 },
@@ -400,6 +466,9 @@ bool protopirate_view_receiver_input(InputEvent* event, void* context) {
             consumed = true;
             break;
         case InputKeyRight:
+            if(receiver->callback) {
+                receiver->callback(ProtoPirateCustomEventViewReceiverStats, receiver->context);
+            }
             consumed = true;
             break;
         case InputKeyOk:
@@ -407,9 +476,7 @@ bool protopirate_view_receiver_input(InputEvent* event, void* context) {
                 receiver->view,
                 ProtoPirateReceiverModel * model,
                 {
-                    size_t item_count =
-                        ProtoPirateReceiverMenuItemArray_size(model->history_item_arr);
-                    if(item_count > 0) {
+                    if(model->next_seq != model->first_seq) {
                         if(receiver->callback) {
                             receiver->callback(
                                 ProtoPirateCustomEventViewReceiverOK, receiver->context);
@@ -425,16 +492,9 @@ bool protopirate_view_receiver_input(InputEvent* event, void* context) {
                     receiver->view,
                     ProtoPirateReceiverModel * model,
                     {
-                        for(size_t i = 0;
-                            i < ProtoPirateReceiverMenuItemArray_size(model->history_item_arr);
-                            i++) {
-                            ProtoPirateReceiverMenuItem* item =
-                                ProtoPirateReceiverMenuItemArray_get(model->history_item_arr, i);
-                            furi_string_free(item->item_str);
-                        }
-                        ProtoPirateReceiverMenuItemArray_reset(model->history_item_arr);
-                        model->history_item = 0;
-                        model->list_offset = 0;
+                        model->first_seq = model->next_seq;
+                        model->history_item = model->next_seq;
+                        model->list_offset = model->next_seq;
                     },
                     false);
                 receiver->callback(ProtoPirateCustomEventViewReceiverBack, receiver->context);
@@ -474,7 +534,15 @@ ProtoPirateReceiver* protopirate_view_receiver_alloc() {
         receiver->view,
         ProtoPirateReceiverModel * model,
         {
-            ProtoPirateReceiverMenuItemArray_init(model->history_item_arr);
+            model->item_callback = NULL;
+            model->item_context = NULL;
+            for(size_t i = 0; i < MENU_ITEMS; i++) {
+                model->rows[i].text = furi_string_alloc();
+                model->rows[i].seq = 0;
+                model->rows[i].width = 0;
+            }
+            model->first_seq = 0;
+            model->next_seq = 0;
             model->frequency_str = furi_string_alloc();
             model->preset_str = furi_string_alloc();
             model->history_stat_str = furi_string_alloc();
@@ -498,13 +566,9 @@ void protopirate_view_receiver_free(ProtoPirateReceiver* receiver) {
         receiver->view,
         ProtoPirateReceiverModel * model,
         {
-            for(size_t i = 0; i < ProtoPirateReceiverMenuItemArray_size(model->history_item_arr);
-                i++) {
-                ProtoPirateReceiverMenuItem* item =
-                    ProtoPirateReceiverMenuItemArray_get(model->history_item_arr, i);
-                furi_string_free(item->item_str);
+            for(size_t i = 0; i < MENU_ITEMS; i++) {
+                furi_string_free(model->rows[i].text);
             }
-            ProtoPirateReceiverMenuItemArray_clear(model->history_item_arr);
             furi_string_free(model->frequency_str);
             furi_string_free(model->preset_str);
             furi_string_free(model->history_stat_str);
@@ -520,24 +584,26 @@ View* protopirate_view_receiver_get_view(ProtoPirateReceiver* receiver) {
     return receiver->view;
 }
 
-uint16_t protopirate_view_receiver_get_idx_menu(ProtoPirateReceiver* receiver) {
+uint32_t protopirate_view_receiver_get_idx_menu(ProtoPirateReceiver* receiver) {
     furi_assert(receiver);
-    uint16_t idx = 0;
+    uint32_t idx = 0;
     with_view_model(
         receiver->view, ProtoPirateReceiverModel * model, { idx = model->history_item; }, false);
     return idx;
 }
 
-void protopirate_view_receiver_set_idx_menu(ProtoPirateReceiver* receiver, uint16_t idx) {
+void protopirate_view_receiver_set_idx_menu(ProtoPirateReceiver* receiver, uint32_t idx) {
     furi_assert(receiver);
     with_view_model(
         receiver->view,
         ProtoPirateReceiverModel * model,
         {
             model->history_item = idx;
-            size_t item_count = ProtoPirateReceiverMenuItemArray_size(model->history_item_arr);
-            if(model->history_item >= item_count) {
-                model->history_item = item_count > 0 ? item_count - 1 : 0;
+            if(model->history_item >= model->next_seq) {
+                model->history_item =
+                    model->next_seq > model->first_seq ? model->next_seq - 1 : model->first_seq;
+            } else if(model->history_item < model->first_seq) {
+                model->history_item = model->first_seq;
             }
         },
         true);
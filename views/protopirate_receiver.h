@@ -8,6 +8,12 @@ typedef struct ProtoPirateReceiver ProtoPirateReceiver;
 
 typedef void (*ProtoPirateReceiverCallback)(ProtoPirateCustomEvent event, void* context);
 
+// Fills output with the one line text of history item seq and returns how many
+// frames it stands for. Called from the draw callback, only for the rows on
+// screen and only when they aren't cached yet.
+typedef uint16_t (
+    *ProtoPirateReceiverItemCallback)(FuriString* output, uint32_t seq, void* context);
+
 void protopirate_view_receiver_set_callback(
     ProtoPirateReceiver* receiver,
     ProtoPirateReceiverCallback callback,
@@ -17,10 +23,20 @@ ProtoPirateReceiver* protopirate_view_receiver_alloc(void);
 void protopirate_view_receiver_free(ProtoPirateReceiver* receiver);
 View* protopirate_view_receiver_get_view(ProtoPirateReceiver* receiver);
 
-void protopirate_view_receiver_add_item_to_menu(
+void protopirate_view_receiver_set_item_callback(
     ProtoPirateReceiver* receiver,
-    const char* name,
-    uint8_t type);
+    ProtoPirateReceiverItemCallback callback,
+    void* context);
+
+// Rows are addressed by history sequence number, see protopirate_history.h.
+// Lists first_seq up to next_seq - 1, the selection stays on the same item.
+void protopirate_view_receiver_set_items(
+    ProtoPirateReceiver* receiver,
+    uint32_t first_seq,
+    uint32_t next_seq);
+
+// Drops the cached row of item seq, its text changed
+void protopirate_view_receiver_update_item(ProtoPirateReceiver* receiver, uint32_t seq);
 
 void protopirate_view_receiver_add_data_statusbar(
     ProtoPirateReceiver* receiver,
@@ -29,7 +45,7 @@ void protopirate_view_receiver_add_data_statusbar(
     const char* history_stat_str,
     bool external_radio);
 
-uint16_t protopirate_view_receiver_get_idx_menu(ProtoPirateReceiver* receiver);
-void protopirate_view_receiver_set_idx_menu(ProtoPirateReceiver* receiver, uint16_t idx);
+uint32_t protopirate_view_receiver_get_idx_menu(ProtoPirateReceiver* receiver);
+void protopirate_view_receiver_set_idx_menu(ProtoPirateReceiver* receiver, uint32_t idx);
 void protopirate_view_receiver_set_rssi(ProtoPirateReceiver* receiver, float rssi);
 void protopirate_view_receiver_set_lock(ProtoPirateReceiver* receiver, ProtoPirateLock lock);